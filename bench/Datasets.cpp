@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#include "Datasets.hpp"
+
+#include <GeodeticCalculator.hpp>
+
+#include <cmath>
+
+namespace geodesy {
+
+namespace bench {
+
+using namespace std;
+
+namespace {
+
+/**
+ * Small, portable, deterministic generator (64 bit LCG, Knuth's MMIX
+ * constants) so that the datasets are the same everywhere.
+ */
+class Random {
+public:
+	explicit Random(unsigned long seed) :
+			mState(seed * 2862933555777941757ULL + 3037000493ULL) {
+	}
+
+	/** Uniform in [0, 1). */
+	double next() {
+		mState = mState * 6364136223846793005ULL + 1442695040888963407ULL;
+		return (mState >> 11) * (1.0 / 9007199254740992.0);
+	}
+
+	/** Uniform in [low, high). */
+	double uniform(double low, double high) {
+		return low + (high - low) * next();
+	}
+
+	/** Latitude uniform over the area of the sphere between two bounds. */
+	double latitude(double low, double high) {
+		double z = uniform(sin(low * M_PI / 180), sin(high * M_PI / 180));
+		return asin(z) * 180 / M_PI;
+	}
+
+private:
+	unsigned long long mState;
+};
+
+double wrapLongitude(double longitude) {
+	while (longitude >= 180) {
+		longitude -= 360;
+	}
+	while (longitude < -180) {
+		longitude += 360;
+	}
+	return longitude;
+}
+
+void resize(Dataset &dataset, size_t count) {
+	dataset.count = count;
+	dataset.startLatitudes.resize(count);
+	dataset.startLongitudes.resize(count);
+	dataset.endLatitudes.resize(count);
+	dataset.endLongitudes.resize(count);
+	dataset.startBearings.resize(count);
+	dataset.distances.resize(count);
+	dataset.startElevations.resize(count);
+	dataset.endElevations.resize(count);
+}
+
+/**
+ * Fill the end points of the inverse problems by travelling the direct
+ * problems, so both kinds cover the same geometry.
+ */
+void travel(Dataset &dataset) {
+	GeodeticCalculator::calculateEndingGlobalCoordinates(Ellipsoid::WGS84(),
+			dataset.count, &dataset.startLatitudes[0],
+			&dataset.startLongitudes[0], &dataset.startBearings[0],
+			&dataset.distances[0], &dataset.endLatitudes[0],
+			&dataset.endLongitudes[0], 0);
+}
+
+}
+
+const vector<string> &datasetNames() {
+	static vector<string> names;
+	if (names.empty()) {
+		names.push_back("urban");
+		names.push_back("continental");
+		names.push_back("polar");
+		names.push_back("antipodal");
+		names.push_back("mixed");
+	}
+	return names;
+}
+
+bool generateDataset(const string &name, size_t count, unsigned long seed,
+		Dataset &dataset) {
+	Random random(seed);
+	dataset.name = name;
+	resize(dataset, count);
+	if (count == 0) {
+		return true;
+	}
+
+	for (size_t i = 0; i < count; ++i) {
+		dataset.startElevations[i] = random.uniform(0, 4000);
+		dataset.endElevations[i] = random.uniform(0, 4000);
+		dataset.startBearings[i] = random.uniform(0, 360);
+	}
+
+	if (name == "urban") {
+		for (size_t i = 0; i < count; ++i) {
+			dataset.startLatitudes[i] = random.latitude(-60, 60);
+			dataset.startLongitudes[i] = random.uniform(-180, 180);
+			dataset.distances[i] = random.uniform(0, 20000);
+		}
+		travel(dataset);
+	} else if (name == "continental") {
+		for (size_t i = 0; i < count; ++i) {
+			dataset.startLatitudes[i] = random.latitude(-70, 70);
+			dataset.startLongitudes[i] = random.uniform(-180, 180);
+			dataset.distances[i] = random.uniform(100000, 3000000);
+		}
+		travel(dataset);
+	} else if (name == "polar") {
+		for (size_t i = 0; i < count; ++i) {
+			double sign = random.next() < 0.5 ? -1 : 1;
+			dataset.startLatitudes[i] = sign * random.latitude(75, 90);
+			dataset.startLongitudes[i] = random.uniform(-180, 180);
+			dataset.endLatitudes[i] = sign * random.latitude(75, 90);
+			dataset.endLongitudes[i] = random.uniform(-180, 180);
+			dataset.distances[i] = random.uniform(0, 3000000);
+		}
+	} else if (name == "antipodal") {
+		for (size_t i = 0; i < count; ++i) {
+			double latitude = random.latitude(-80, 80);
+			double longitude = random.uniform(-180, 180);
+			dataset.startLatitudes[i] = latitude;
+			dataset.startLongitudes[i] = longitude;
+			dataset.endLatitudes[i] = -latitude + random.uniform(-0.5, 0.5);
+			dataset.endLongitudes[i] = wrapLongitude(
+					longitude + 180 + random.uniform(-0.5, 0.5));
+			dataset.distances[i] = random.uniform(19900000, 20000000);
+		}
+	} else if (name == "mixed") {
+		for (size_t i = 0; i < count; ++i) {
+			dataset.startLatitudes[i] = random.latitude(-90, 90);
+			dataset.startLongitudes[i] = random.uniform(-180, 180);
+			dataset.endLatitudes[i] = random.latitude(-90, 90);
+			dataset.endLongitudes[i] = random.uniform(-180, 180);
+			dataset.distances[i] = random.uniform(0, 20000000);
+		}
+	} else {
+		return false;
+	}
+	return true;
+}
+
+} // bench
+
+} // geodesy
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#ifndef GEODESY_BENCH_DATASETS_HPP
+#define GEODESY_BENCH_DATASETS_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace geodesy {
+
+namespace bench {
+
+/**
+ * A generated workload: count pairs of points for the inverse problem and
+ * count starting bearings and distances from the first points for the direct
+ * problem, plus elevations for the measurements. The inverse and direct
+ * problems of a dataset cover the same kind of geometry.
+ */
+struct Dataset {
+	std::string name;
+	std::size_t count;
+	std::vector<double> startLatitudes;
+	std::vector<double> startLongitudes;
+	std::vector<double> endLatitudes;
+	std::vector<double> endLongitudes;
+	std::vector<double> startBearings;
+	std::vector<double> distances;
+	std::vector<double> startElevations;
+	std::vector<double> endElevations;
+};
+
+/**
+ * Names of the datasets, in the order they are run:
+ * <ul>
+ * <li>urban: up to 20 km, between 60S and 60N</li>
+ * <li>continental: 100 to 3000 km</li>
+ * <li>polar: both points above 75 degrees, often across the pole</li>
+ * <li>antipodal: within half a degree of the antipode, the hard case for
+ * Vincenty's inverse</li>
+ * <li>mixed: uniform over the sphere, any distance</li>
+ * </ul>
+ */
+const std::vector<std::string> &datasetNames();
+
+/**
+ * Generate a dataset. The same name, count and seed always give the same
+ * data.
+ *
+ * @param name one of datasetNames()
+ * @param count number of problems
+ * @param seed seed of the pseudo-random generator
+ * @param dataset the data (output value)
+ * @return false if the name is unknown
+ */
+bool generateDataset(const std::string &name, std::size_t count,
+		unsigned long seed, Dataset &dataset);
+
+} // bench
+
+} // geodesy
+
+#endif // GEODESY_BENCH_DATASETS_HPP
@@ -0,0 +1,622 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+/*
+ * Throughput and latency of the solvers over the generated datasets of
+ * Datasets.hpp. Every result is printed as one line of JSON (the default) or
+ * CSV on stdout, progress and errors go to stderr.
+ *
+ * Usage: geoBench [--count N] [--threads N[,N...]] [--repeat N] [--seed N]
+ *                 [--format json|csv] [--filter TEXT]
+ */
+
+#include "Datasets.hpp"
+
+#include <BatchExecutor.hpp>
+#include <CurveCache.hpp>
+#include <GeodeticCalculator.hpp>
+#include <GeodeticCalculatorT.hpp>
+#include <GlobalPosition.hpp>
+#include <TrackAccumulator.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace geodesy;
+using namespace geodesy::bench;
+using namespace std;
+
+namespace {
+
+/**
+ * Inputs and outputs of one benchmark run. The ranges given to the workers
+ * are disjoint, so they can share the output arrays.
+ */
+struct Context {
+	const Dataset *dataset;
+	Ellipsoid::ConstPtr ellipsoid;
+	vector<double> first;
+	vector<double> second;
+	vector<double> third;
+};
+
+typedef void (*RangeFunction)(Context &context, size_t begin, size_t end);
+
+struct Benchmark {
+	/** Name in the output. */
+	const char *name;
+	/** Solve problems [begin, end). */
+	RangeFunction run;
+	/** If the function solves one problem at a time and has a latency. */
+	bool perCall;
+};
+
+void inverseVincenty(Context &context, size_t begin, size_t end) {
+	const Dataset &data = *context.dataset;
+	const Ellipsoid &ellipsoid = *context.ellipsoid;
+	for (size_t i = begin; i < end; ++i) {
+		GeodeticCurveValue curve = GeodeticCalculator::calculateGeodeticCurve(
+				ellipsoid,
+				GlobalCoordinates(data.startLatitudes[i],
+						data.startLongitudes[i]),
+				GlobalCoordinates(data.endLatitudes[i], data.endLongitudes[i]),
+				GeodeticCalculator::Vincenty);
+		context.first[i] = curve.ellipsoidalDistance;
+	}
+}
+
+/** Same problems as inverseVincenty(), the datasets are on WGS84. */
+void inverseWgs84(Context &context, size_t begin, size_t end) {
+	const Dataset &data = *context.dataset;
+	for (size_t i = begin; i < end; ++i) {
+		GeodeticCurveValue curve = WGS84Calculator::calculateGeodeticCurve(
+				GlobalCoordinates(data.startLatitudes[i],
+						data.startLongitudes[i]),
+				GlobalCoordinates(data.endLatitudes[i], data.endLongitudes[i]));
+		context.first[i] = curve.ellipsoidalDistance;
+	}
+}
+
+void inverseKarney(Context &context, size_t begin, size_t end) {
+	const Dataset &data = *context.dataset;
+	const Ellipsoid &ellipsoid = *context.ellipsoid;
+	for (size_t i = begin; i < end; ++i) {
+		GeodeticCurveValue curve = GeodeticCalculator::calculateGeodeticCurve(
+				ellipsoid,
+				GlobalCoordinates(data.startLatitudes[i],
+						data.startLongitudes[i]),
+				GlobalCoordinates(data.endLatitudes[i], data.endLongitudes[i]),
+				GeodeticCalculator::Karney);
+		context.first[i] = curve.ellipsoidalDistance;
+	}
+}
+
+void inverseAndoyerLambert(Context &context, size_t begin, size_t end) {
+	const Dataset &data = *context.dataset;
+	const Ellipsoid &ellipsoid = *context.ellipsoid;
+	for (size_t i = begin; i < end; ++i) {
+		GeodeticCurveValue curve = GeodeticCalculator::calculateGeodeticCurve(
+				ellipsoid,
+				GlobalCoordinates(data.startLatitudes[i],
+						data.startLongitudes[i]),
+				GlobalCoordinates(data.endLatitudes[i], data.endLongitudes[i]),
+				GeodeticCalculator::AndoyerLambert);
+		context.first[i] = curve.ellipsoidalDistance;
+	}
+}
+
+void inverseHaversine(Context &context, size_t begin, size_t end) {
+	const Dataset &data = *context.dataset;
+	const Ellipsoid &ellipsoid = *context.ellipsoid;
+	for (size_t i = begin; i < end; ++i) {
+		GeodeticCurveValue curve = GeodeticCalculator::calculateGeodeticCurve(
+				ellipsoid,
+				GlobalCoordinates(data.startLatitudes[i],
+						data.startLongitudes[i]),
+				GlobalCoordinates(data.endLatitudes[i], data.endLongitudes[i]),
+				GeodeticCalculator::Haversine);
+		context.first[i] = curve.ellipsoidalDistance;
+	}
+}
+
+/**
+ * Contention on the reference count of a shared ellipsoid: the same problems
+ * as inverseHaversine(), the cheapest solver, but every call takes its own
+ * copy of the Ellipsoid::ConstPtr, as passing it by value does. With more
+ * threads the copies fight over the cache line of the count.
+ */
+void contentionCopy(Context &context, size_t begin, size_t end) {
+	const Dataset &data = *context.dataset;
+	for (size_t i = begin; i < end; ++i) {
+		Ellipsoid::ConstPtr ellipsoid = context.ellipsoid;
+		GeodeticCurveValue curve = GeodeticCalculator::calculateGeodeticCurve(
+				*ellipsoid,
+				GlobalCoordinates(data.startLatitudes[i],
+						data.startLongitudes[i]),
+				GlobalCoordinates(data.endLatitudes[i], data.endLongitudes[i]),
+				GeodeticCalculator::Haversine);
+		context.first[i] = curve.ellipsoidalDistance;
+	}
+}
+
+/** Same as contentionCopy(), with the ellipsoid by reference. */
+void contentionReference(Context &context, size_t begin, size_t end) {
+	const Dataset &data = *context.dataset;
+	for (size_t i = begin; i < end; ++i) {
+		const Ellipsoid::ConstPtr &ellipsoid = context.ellipsoid;
+		GeodeticCurveValue curve = GeodeticCalculator::calculateGeodeticCurve(
+				*ellipsoid,
+				GlobalCoordinates(data.startLatitudes[i],
+						data.startLongitudes[i]),
+				GlobalCoordinates(data.endLatitudes[i], data.endLongitudes[i]),
+				GeodeticCalculator::Haversine);
+		context.first[i] = curve.ellipsoidalDistance;
+	}
+}
+
+/** Used by inverse.cached, emptied for each dataset. */
+CurveCache cache;
+
+/**
+ * Repeated queries: the problems cycle through the first RepeatedPairs
+ * pairs of the dataset, as a routing service asking for the same depot to
+ * customer distances would.
+ */
+const size_t RepeatedPairs = 1024;
+
+void inverseCached(Context &context, size_t begin, size_t end) {
+	const Dataset &data = *context.dataset;
+	const Ellipsoid &ellipsoid = *context.ellipsoid;
+	for (size_t i = begin; i < end; ++i) {
+		size_t j = i % min(RepeatedPairs, data.count);
+		GeodeticCurveValue curve = cache.calculateGeodeticCurve(ellipsoid,
+				GlobalCoordinates(data.startLatitudes[j],
+						data.startLongitudes[j]),
+				GlobalCoordinates(data.endLatitudes[j], data.endLongitudes[j]));
+		context.first[i] = curve.ellipsoidalDistance;
+	}
+}
+
+void inverseBatch(Context &context, size_t begin, size_t end) {
+	const Dataset &data = *context.dataset;
+	GeodeticCalculator::calculateGeodeticCurves(context.ellipsoid,
+			end - begin, &data.startLatitudes[begin],
+			&data.startLongitudes[begin], &data.endLatitudes[begin],
+			&data.endLongitudes[begin], &context.first[begin],
+			&context.second[begin], &context.third[begin]);
+}
+
+void direct(Context &context, size_t begin, size_t end) {
+	const Dataset &data = *context.dataset;
+	const Ellipsoid &ellipsoid = *context.ellipsoid;
+	for (size_t i = begin; i < end; ++i) {
+		GeodeticDestinationValue destination =
+				GeodeticCalculator::calculateEndingGlobalCoordinates(ellipsoid,
+						GlobalCoordinates(data.startLatitudes[i],
+								data.startLongitudes[i]),
+						data.startBearings[i], data.distances[i]);
+		context.first[i] = destination.latitude;
+	}
+}
+
+void directBatch(Context &context, size_t begin, size_t end) {
+	const Dataset &data = *context.dataset;
+	GeodeticCalculator::calculateEndingGlobalCoordinates(context.ellipsoid,
+			end - begin, &data.startLatitudes[begin],
+			&data.startLongitudes[begin], &data.startBearings[begin],
+			&data.distances[begin], &context.first[begin],
+			&context.second[begin], &context.third[begin]);
+}
+
+/** Points per segment of the waypoints benchmark. */
+const size_t WaypointCount = 16;
+
+void waypoints(Context &context, size_t begin, size_t end) {
+	const Dataset &data = *context.dataset;
+	const Ellipsoid &ellipsoid = *context.ellipsoid;
+	double latitudes[WaypointCount];
+	double longitudes[WaypointCount];
+	for (size_t i = begin; i < end; ++i) {
+		GeodeticCalculator::calculateWaypoints(ellipsoid,
+				GlobalCoordinates(data.startLatitudes[i],
+						data.startLongitudes[i]),
+				GlobalCoordinates(data.endLatitudes[i], data.endLongitudes[i]),
+				WaypointCount, latitudes, longitudes);
+		context.first[i] = latitudes[WaypointCount / 2];
+	}
+}
+
+void measurement(Context &context, size_t begin, size_t end) {
+	const Dataset &data = *context.dataset;
+	const Ellipsoid &ellipsoid = *context.ellipsoid;
+	for (size_t i = begin; i < end; ++i) {
+		GeodeticMeasurementValue measurement =
+				GeodeticCalculator::calculateGeodeticMeasurement(ellipsoid,
+						GlobalPosition(data.startLatitudes[i],
+								data.startLongitudes[i],
+								data.startElevations[i]),
+						GlobalPosition(data.endLatitudes[i],
+								data.endLongitudes[i], data.endElevations[i]));
+		context.first[i] = measurement.pointToPointDistance;
+	}
+}
+
+/** Positions staged at a time by the batch measurement benchmark. */
+const size_t MeasurementBlock = 256;
+
+void measurementBatch(Context &context, size_t begin, size_t end) {
+	const Dataset &data = *context.dataset;
+	vector<GlobalPosition> starts;
+	vector<GlobalPosition> ends;
+	starts.reserve(MeasurementBlock);
+	ends.reserve(MeasurementBlock);
+	GeodeticMeasurementValue measurements[MeasurementBlock];
+	for (size_t block = begin; block < end; block += MeasurementBlock) {
+		size_t count = min(MeasurementBlock, end - block);
+		starts.clear();
+		ends.clear();
+		for (size_t i = block; i < block + count; ++i) {
+			starts.push_back(
+					GlobalPosition(data.startLatitudes[i],
+							data.startLongitudes[i], data.startElevations[i]));
+			ends.push_back(
+					GlobalPosition(data.endLatitudes[i], data.endLongitudes[i],
+							data.endElevations[i]));
+		}
+		GeodeticCalculator::calculateGeodeticMeasurements(*context.ellipsoid,
+				count, &starts[0], &ends[0], measurements);
+		for (size_t i = 0; i < count; ++i) {
+			context.first[block + i] = measurements[i].pointToPointDistance;
+		}
+	}
+}
+
+/**
+ * The start points of the range as the fixes of one track, each segment
+ * measured once.
+ */
+void track(Context &context, size_t begin, size_t end) {
+	const Dataset &data = *context.dataset;
+	TrackAccumulator accumulator(context.ellipsoid);
+	for (size_t i = begin; i < end; ++i) {
+		accumulator.add(
+				GlobalPosition(data.startLatitudes[i], data.startLongitudes[i],
+						data.startElevations[i]));
+		context.first[i] = accumulator.getPointToPointLength();
+	}
+}
+
+void canonicalize(Context &context, size_t begin, size_t end) {
+	const Dataset &data = *context.dataset;
+	copy(&data.startLatitudes[begin], &data.startLatitudes[0] + end,
+			&context.first[begin]);
+	copy(&data.startLongitudes[begin], &data.startLongitudes[0] + end,
+			&context.second[begin]);
+	GlobalCoordinates::canonicalize(end - begin, &context.first[begin],
+			&context.second[begin]);
+}
+
+const Benchmark Benchmarks[] = { //
+		{ "inverse.vincenty", inverseVincenty, true }, //
+				{ "inverse.wgs84", inverseWgs84, true }, //
+				{ "inverse.karney", inverseKarney, true }, //
+				{ "inverse.andoyer_lambert", inverseAndoyerLambert, true }, //
+				{ "inverse.haversine", inverseHaversine, true }, //
+				{ "inverse.cached", inverseCached, true }, //
+				{ "inverse.batch", inverseBatch, false }, //
+				{ "direct", direct, true }, //
+				{ "direct.batch", directBatch, false }, //
+				{ "waypoints", waypoints, true }, //
+				{ "measurement", measurement, true }, //
+				{ "measurement.batch", measurementBatch, false }, //
+				{ "track", track, false }, //
+				{ "contention.copy", contentionCopy, true }, //
+				{ "contention.reference", contentionReference, true }, //
+				{ "canonicalize", canonicalize, false } };
+
+const size_t BenchmarkCount = sizeof(Benchmarks) / sizeof(Benchmarks[0]);
+
+/**
+ * Runs a benchmark function on the worker threads of an executor.
+ */
+class RangeTask: public BatchExecutor::Task {
+public:
+	RangeTask(RangeFunction function, Context &context) :
+			mFunction(function), mContext(context) {
+	}
+
+	virtual void run(size_t begin, size_t end) {
+		mFunction(mContext, begin, end);
+	}
+
+private:
+	RangeFunction mFunction;
+	Context &mContext;
+};
+
+struct Options {
+	size_t count;
+	vector<unsigned> threads;
+	unsigned repeat;
+	unsigned long seed;
+	bool csv;
+	string filter;
+};
+
+struct Result {
+	double seconds;
+	bool hasLatency;
+	double p50;
+	double p90;
+	double p99;
+	double max;
+};
+
+double now() {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec * 1E-9;
+}
+
+/** Keeps the compiler from dropping the solves whose results are unused. */
+volatile double sink;
+
+void consume(const Context &context) {
+	double sum = 0;
+	for (size_t i = 0; i < context.first.size(); ++i) {
+		sum += context.first[i];
+	}
+	sink = sink + sum;
+}
+
+double percentile(const vector<double> &sorted, double fraction) {
+	size_t index = static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5);
+	return sorted[index];
+}
+
+/**
+ * Time the benchmark, best of options.repeat runs. With a single thread and
+ * a per-call function, also time every call on its own for the latency
+ * distribution; those times include the clock overhead, some tens of
+ * nanoseconds.
+ */
+Result measure(const Benchmark &benchmark, Context &context,
+		BatchExecutor *executor, const Options &options) {
+	size_t count = context.dataset->count;
+	Result result;
+	result.seconds = 0;
+	result.hasLatency = false;
+
+	for (unsigned r = 0; r < options.repeat; ++r) {
+		double start = now();
+		if (executor) {
+			RangeTask task(benchmark.run, context);
+			executor->run(task, count);
+		} else {
+			benchmark.run(context, 0, count);
+		}
+		double seconds = now() - start;
+		if (r == 0 || seconds < result.seconds) {
+			result.seconds = seconds;
+		}
+		consume(context);
+	}
+
+	if (benchmark.perCall && !executor && count > 0) {
+		vector<double> latencies(count);
+		for (size_t i = 0; i < count; ++i) {
+			double start = now();
+			benchmark.run(context, i, i + 1);
+			latencies[i] = (now() - start) * 1E9;
+		}
+		consume(context);
+		sort(latencies.begin(), latencies.end());
+		result.hasLatency = true;
+		result.p50 = percentile(latencies, 0.5);
+		result.p90 = percentile(latencies, 0.9);
+		result.p99 = percentile(latencies, 0.99);
+		result.max = latencies.back();
+	}
+	return result;
+}
+
+void printHeader(const Options &options) {
+	if (options.csv) {
+		printf("benchmark,dataset,threads,count,seconds,ns_per_op,"
+				"ops_per_second,p50_ns,p90_ns,p99_ns,max_ns\n");
+	}
+}
+
+void print(const Options &options, const Benchmark &benchmark,
+		const Dataset &dataset, unsigned threads, const Result &result) {
+	double nsPerOp = dataset.count ? result.seconds * 1E9 / dataset.count : 0;
+	double opsPerSecond =
+			result.seconds > 0 ? dataset.count / result.seconds : 0;
+	if (options.csv) {
+		printf("%s,%s,%u,%lu,%.9f,%.3f,%.1f", benchmark.name,
+				dataset.name.c_str(), threads,
+				static_cast<unsigned long>(dataset.count), result.seconds,
+				nsPerOp, opsPerSecond);
+		if (result.hasLatency) {
+			printf(",%.1f,%.1f,%.1f,%.1f\n", result.p50, result.p90,
+					result.p99, result.max);
+		} else {
+			printf(",,,,\n");
+		}
+	} else {
+		printf("{\"benchmark\":\"%s\",\"dataset\":\"%s\",\"threads\":%u,"
+				"\"count\":%lu,\"seconds\":%.9f,\"ns_per_op\":%.3f,"
+				"\"ops_per_second\":%.1f", benchmark.name,
+				dataset.name.c_str(), threads,
+				static_cast<unsigned long>(dataset.count), result.seconds,
+				nsPerOp, opsPerSecond);
+		if (result.hasLatency) {
+			printf(",\"p50_ns\":%.1f,\"p90_ns\":%.1f,\"p99_ns\":%.1f,"
+					"\"max_ns\":%.1f}\n", result.p50, result.p90, result.p99,
+					result.max);
+		} else {
+			printf(",\"p50_ns\":null,\"p90_ns\":null,\"p99_ns\":null,"
+					"\"max_ns\":null}\n");
+		}
+	}
+	fflush(stdout);
+}
+
+void usage() {
+	fprintf(stderr,
+			"usage: geoBench [--count N] [--threads N[,N...]] [--repeat N]\n"
+					"                [--seed N] [--format json|csv] [--filter TEXT]\n"
+					"  --count    problems per dataset (default 20000)\n"
+					"  --threads  thread counts to run, 0 for one per processor\n"
+					"             (default 1,0)\n"
+					"  --repeat   runs per measurement, the best is kept "
+					"(default 3)\n"
+					"  --seed     seed of the generated datasets (default 1)\n"
+					"  --format   output format (default json)\n"
+					"  --filter   only run benchmarks whose name or dataset\n"
+					"             contains TEXT\n");
+}
+
+bool parseThreads(const char *text, vector<unsigned> &threads) {
+	threads.clear();
+	while (*text) {
+		char *end;
+		unsigned long value = strtoul(text, &end, 10);
+		if (end == text || (*end != ',' && *end != 0)) {
+			return false;
+		}
+		if (value == 0) {
+			long online = sysconf(_SC_NPROCESSORS_ONLN);
+			value = online > 0 ? online : 1;
+		}
+		if (find(threads.begin(), threads.end(), value) == threads.end()) {
+			threads.push_back(value);
+		}
+		text = *end ? end + 1 : end;
+	}
+	return !threads.empty();
+}
+
+bool parseOptions(int argc, char **argv, Options &options) {
+	options.count = 20000;
+	options.repeat = 3;
+	options.seed = 1;
+	options.csv = false;
+	parseThreads("1,0", options.threads);
+
+	for (int i = 1; i < argc; ++i) {
+		string option = argv[i];
+		if (i + 1 >= argc) {
+			return false;
+		}
+		const char *value = argv[++i];
+		if (option == "--count") {
+			options.count = strtoul(value, 0, 10);
+		} else if (option == "--threads") {
+			if (!parseThreads(value, options.threads)) {
+				return false;
+			}
+		} else if (option == "--repeat") {
+			options.repeat = max(1UL, strtoul(value, 0, 10));
+		} else if (option == "--seed") {
+			options.seed = strtoul(value, 0, 10);
+		} else if (option == "--format") {
+			if (strcmp(value, "csv") == 0) {
+				options.csv = true;
+			} else if (strcmp(value, "json") == 0) {
+				options.csv = false;
+			} else {
+				return false;
+			}
+		} else if (option == "--filter") {
+			options.filter = value;
+		} else {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool selected(const Options &options, const Benchmark &benchmark,
+		const Dataset &dataset) {
+	return options.filter.empty()
+			|| string(benchmark.name).find(options.filter) != string::npos
+			|| dataset.name.find(options.filter) != string::npos;
+}
+
+}
+
+int main(int argc, char **argv) {
+	Options options;
+	if (!parseOptions(argc, argv, options)) {
+		usage();
+		return 2;
+	}
+
+	printHeader(options);
+	const vector<string> &names = datasetNames();
+	for (size_t d = 0; d < names.size(); ++d) {
+		Dataset dataset;
+		generateDataset(names[d], options.count, options.seed, dataset);
+		cache.clear();
+
+		Context context;
+		context.dataset = &dataset;
+		context.ellipsoid = Ellipsoid::WGS84();
+		context.first.resize(dataset.count);
+		context.second.resize(dataset.count);
+		context.third.resize(dataset.count);
+
+		for (size_t t = 0; t < options.threads.size(); ++t) {
+			unsigned threads = options.threads[t];
+			// a single thread runs on the caller, without the executor
+			BatchExecutor *executor = 0;
+			if (threads > 1) {
+				executor = new BatchExecutor(threads);
+			}
+			for (size_t b = 0; b < BenchmarkCount; ++b) {
+				if (!selected(options, Benchmarks[b], dataset)) {
+					continue;
+				}
+				fprintf(stderr, "%s %s %u\n", Benchmarks[b].name,
+						dataset.name.c_str(), threads);
+				Result result = measure(Benchmarks[b], context, executor,
+						options);
+				print(options, Benchmarks[b], dataset, threads, result);
+			}
+			delete executor;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#include "ApproximateInverse.hpp"
+#include "Angle.hpp"
+#include "FastMath.hpp"
+#include "SolverStats.hpp"
+
+#include <cmath>
+
+namespace geodesy {
+
+using namespace std;
+
+namespace {
+
+/**
+ * Convert an azimuth in radians, in [-pi, pi], to degrees in [0, 360).
+ */
+double toAzimuth(double radians) {
+	double degrees = Angle::toDegrees(radians);
+	if (degrees < 0.0)
+		degrees += 360.0;
+	if (degrees >= 360.0)
+		degrees -= 360.0;
+	return degrees;
+}
+
+/**
+ * Solve the inverse problem on the unit sphere.
+ *
+ * @param phi1 starting latitude (radians)
+ * @param phi2 ending latitude (radians)
+ * @param lambda difference in longitude (radians)
+ * @param h haversine of the central angle (output value)
+ * @param alpha1 azimuth in degrees (output value)
+ * @param alpha2 reverse azimuth in degrees (output value)
+ * @return the central angle (radians)
+ */
+double solveSphere(double phi1, double phi2, double lambda, double &h,
+		double &alpha1, double &alpha2) {
+	double sinPhi1;
+	double cosPhi1;
+	double sinPhi2;
+	double cosPhi2;
+	double sinLambda;
+	double cosLambda;
+	double sinHalfPhi;
+	double sinHalfLambda;
+	double unused;
+	fastmath::sincosReduced(phi1, sinPhi1, cosPhi1);
+	fastmath::sincosReduced(phi2, sinPhi2, cosPhi2);
+	fastmath::sincosReduced(lambda, sinLambda, cosLambda);
+	fastmath::sincosReduced((phi2 - phi1) / 2.0, sinHalfPhi, unused);
+	fastmath::sincosReduced(lambda / 2.0, sinHalfLambda, unused);
+
+	h = sinHalfPhi * sinHalfPhi
+			+ cosPhi1 * cosPhi2 * sinHalfLambda * sinHalfLambda;
+	if (h > 1.0)
+		h = 1.0;
+
+	alpha1 = toAzimuth(
+			fastmath::atan2Reduced(cosPhi2 * sinLambda,
+					cosPhi1 * sinPhi2 - sinPhi1 * cosPhi2 * cosLambda));
+	alpha2 = toAzimuth(
+			fastmath::atan2Reduced(-cosPhi1 * sinLambda,
+					cosPhi2 * sinPhi1 - sinPhi2 * cosPhi1 * cosLambda));
+
+	return 2.0 * fastmath::atan2Reduced(sqrt(h), sqrt(1.0 - h));
+}
+
+}
+
+void ApproximateInverse::haversine(double a, double b, double startLatitude,
+		double startLongitude, double endLatitude, double endLongitude,
+		double &s, double &alpha1, double &alpha2) {
+	double h;
+	double sigma = solveSphere(Angle::toRadians(startLatitude),
+			Angle::toRadians(endLatitude),
+			Angle::toRadians(endLongitude - startLongitude), h, alpha1, alpha2);
+
+	s = (2.0 * a + b) / 3.0 * sigma;
+	GEODESY_STATS_RECORD(SolverStats::Inverse, 0, true, false);
+}
+
+void ApproximateInverse::andoyerLambert(double a, double f,
+		double startLatitude, double startLongitude, double endLatitude,
+		double endLongitude, double &s, double &alpha1, double &alpha2) {
+	// reduced latitudes
+	double sinPhi;
+	double cosPhi;
+	fastmath::sincosReduced(Angle::toRadians(startLatitude), sinPhi, cosPhi);
+	double beta1 = fastmath::atan2Reduced((1.0 - f) * sinPhi, cosPhi);
+	fastmath::sincosReduced(Angle::toRadians(endLatitude), sinPhi, cosPhi);
+	double beta2 = fastmath::atan2Reduced((1.0 - f) * sinPhi, cosPhi);
+
+	double h;
+	double sigma = solveSphere(beta1, beta2,
+			Angle::toRadians(endLongitude - startLongitude), h, alpha1, alpha2);
+
+	// sin^2(sigma/2) is h and cos^2(sigma/2) is 1 - h, the terms whose
+	// denominator vanishes are dropped for coincident and antipodal points
+	double p = (beta1 + beta2) / 2.0;
+	double q = (beta2 - beta1) / 2.0;
+	double sinP;
+	double cosP;
+	double sinQ;
+	double cosQ;
+	double sinSigma;
+	double unused;
+	fastmath::sincosReduced(p, sinP, cosP);
+	fastmath::sincosReduced(q, sinQ, cosQ);
+	fastmath::sincosReduced(sigma, sinSigma, unused);
+	double x = 0.0;
+	double y = 0.0;
+	if (h < 1.0)
+		x = (sigma - sinSigma) * sinP * sinP * cosQ * cosQ / (1.0 - h);
+	if (h > 0.0)
+		y = (sigma + sinSigma) * cosP * cosP * sinQ * sinQ / h;
+
+	s = a * (sigma - f / 2.0 * (x + y));
+	GEODESY_STATS_RECORD(SolverStats::Inverse, 0, true, false);
+}
+
+}
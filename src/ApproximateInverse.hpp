@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#ifndef APPROXIMATEINVERSE_HPP_
+#define APPROXIMATEINVERSE_HPP_
+
+namespace geodesy {
+
+/**
+ * <p>
+ * Closed form approximations of the inverse geodetic problem, for callers
+ * that can trade accuracy for speed. Neither iterates, both cost a handful of
+ * trigonometric functions. Select them through
+ * GeodeticCalculator::InverseMethod.
+ * </p>
+ * <p>
+ * The worst case errors quoted below are for the WGS84 ellipsoid, measured
+ * against Karney's method over random pairs covering the whole ellipsoid.
+ * </p>
+ */
+class ApproximateInverse {
+public:
+	/**
+	 * Great circle distance on a sphere of the mean radius (2a + b) / 3 by the
+	 * haversine formula, with the great circle azimuths taken from the
+	 * geodetic latitudes. The distance is within 0.56% of the ellipsoidal
+	 * distance, that is up to 56 m on 10 km and 28 km on 5000 km. The
+	 * azimuths are within 0.2 degrees up to 10000 km; beyond that they drift
+	 * (1.7 degrees at 19000 km) and can be anything for nearly antipodal
+	 * points.
+	 *
+	 * @param a semi major axis (meters)
+	 * @param b semi minor axis (meters)
+	 * @param startLatitude starting latitude (degrees)
+	 * @param startLongitude starting longitude (degrees)
+	 * @param endLatitude ending latitude (degrees)
+	 * @param endLongitude ending longitude (degrees)
+	 * @param s distance in meters (output value)
+	 * @param alpha1 azimuth in degrees (output value)
+	 * @param alpha2 reverse azimuth in degrees (output value)
+	 */
+	static void haversine(double a, double b, double startLatitude,
+			double startLongitude, double endLatitude, double endLongitude,
+			double &s, double &alpha1, double &alpha2);
+
+	/**
+	 * Lambert's formula for long lines (Andoyer-Lambert): the great circle
+	 * between the reduced latitudes plus a one pass correction of first order
+	 * in the flattening. The distance error grows with the length of the line:
+	 * at most 1.4 m per 1000 km up to 10000 km, 60 m up to 15000 km and 500 m
+	 * up to 19000 km; closer to the antipode the correction breaks down and
+	 * the distance may be off by tens of kilometers. The azimuths, those of
+	 * the great circle between the reduced latitudes, are within 0.1 degrees
+	 * up to 5000 km and 0.2 degrees up to 10000 km.
+	 *
+	 * @param a semi major axis (meters)
+	 * @param f flattening
+	 * @param startLatitude starting latitude (degrees)
+	 * @param startLongitude starting longitude (degrees)
+	 * @param endLatitude ending latitude (degrees)
+	 * @param endLongitude ending longitude (degrees)
+	 * @param s distance in meters (output value)
+	 * @param alpha1 azimuth in degrees (output value)
+	 * @param alpha2 reverse azimuth in degrees (output value)
+	 */
+	static void andoyerLambert(double a, double f, double startLatitude,
+			double startLongitude, double endLatitude, double endLongitude,
+			double &s, double &alpha1, double &alpha2);
+
+private:
+	// no instances
+	ApproximateInverse() {
+	}
+};
+
+}
+
+#endif /* APPROXIMATEINVERSE_HPP_ */
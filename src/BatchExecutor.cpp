@@ -0,0 +1,480 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#include "BatchExecutor.hpp"
+
+#include <algorithm>
+#include <unistd.h>
+
+namespace geodesy {
+
+using namespace std;
+
+namespace {
+
+/**
+ * Solves the inverse problem for a range of a batch.
+ */
+class InverseTask: public BatchExecutor::Task {
+public:
+	InverseTask(const Ellipsoid &ellipsoid, const double *startLatitudes,
+			const double *startLongitudes, const double *endLatitudes,
+			const double *endLongitudes, double *ellipsoidalDistances,
+			double *azimuths, double *reverseAzimuths,
+			GeodeticCalculator::InverseMethod method, double errorTolerance,
+			int maxIterations) :
+			mEllipsoid(ellipsoid), mStartLatitudes(startLatitudes), mStartLongitudes(
+					startLongitudes), mEndLatitudes(endLatitudes), mEndLongitudes(
+					endLongitudes), mEllipsoidalDistances(ellipsoidalDistances), mAzimuths(
+					azimuths), mReverseAzimuths(reverseAzimuths), mMethod(
+					method), mErrorTolerance(errorTolerance), mMaxIterations(
+					maxIterations) {
+	}
+
+	virtual void run(size_t begin, size_t end) {
+		GeodeticCalculator::calculateGeodeticCurves(mEllipsoid, end - begin,
+				mStartLatitudes + begin, mStartLongitudes + begin,
+				mEndLatitudes + begin, mEndLongitudes + begin,
+				mEllipsoidalDistances + begin,
+				mAzimuths ? mAzimuths + begin : 0,
+				mReverseAzimuths ? mReverseAzimuths + begin : 0, mMethod,
+				mErrorTolerance, mMaxIterations);
+	}
+
+private:
+	const Ellipsoid &mEllipsoid;
+	const double *mStartLatitudes;
+	const double *mStartLongitudes;
+	const double *mEndLatitudes;
+	const double *mEndLongitudes;
+	double *mEllipsoidalDistances;
+	double *mAzimuths;
+	double *mReverseAzimuths;
+	GeodeticCalculator::InverseMethod mMethod;
+	double mErrorTolerance;
+	int mMaxIterations;
+};
+
+/**
+ * Solves the direct problem for a range of a batch. A NaN bearing is recorded
+ * rather than thrown on the worker thread.
+ */
+class DirectTask: public BatchExecutor::Task {
+public:
+	DirectTask(const Ellipsoid &ellipsoid, const double *startLatitudes,
+			const double *startLongitudes, const double *startBearings,
+			const double *distances, double *endLatitudes,
+			double *endLongitudes, double *endBearings, double errorTolerance,
+			int maxIterations) :
+			mEllipsoid(ellipsoid), mStartLatitudes(startLatitudes), mStartLongitudes(
+					startLongitudes), mStartBearings(startBearings), mDistances(
+					distances), mEndLatitudes(endLatitudes), mEndLongitudes(
+					endLongitudes), mEndBearings(endBearings), mErrorTolerance(
+					errorTolerance), mMaxIterations(maxIterations), mInvalid(0) {
+	}
+
+	virtual void run(size_t begin, size_t end) {
+		try {
+			GeodeticCalculator::calculateEndingGlobalCoordinates(mEllipsoid,
+					end - begin, mStartLatitudes + begin,
+					mStartLongitudes + begin, mStartBearings + begin,
+					mDistances + begin, mEndLatitudes + begin,
+					mEndLongitudes + begin,
+					mEndBearings ? mEndBearings + begin : 0, mErrorTolerance,
+					mMaxIterations);
+		} catch (InvalidAzimuthException &) {
+			__sync_fetch_and_or(&mInvalid, 1);
+		}
+	}
+
+	bool isInvalid() {
+		return __sync_fetch_and_or(&mInvalid, 0) != 0;
+	}
+
+private:
+	const Ellipsoid &mEllipsoid;
+	const double *mStartLatitudes;
+	const double *mStartLongitudes;
+	const double *mStartBearings;
+	const double *mDistances;
+	double *mEndLatitudes;
+	double *mEndLongitudes;
+	double *mEndBearings;
+	double mErrorTolerance;
+	int mMaxIterations;
+	int mInvalid;
+};
+
+/**
+ * Measures between positions for a range of a batch.
+ */
+class MeasurementTask: public BatchExecutor::Task {
+public:
+	MeasurementTask(const Ellipsoid &refEllipsoid, const GlobalPosition *starts,
+			const GlobalPosition *ends, GeodeticMeasurementValue *measurements,
+			double errorTolerance, int maxIterations) :
+			mRefEllipsoid(refEllipsoid), mStarts(starts), mEnds(ends), mMeasurements(
+					measurements), mErrorTolerance(errorTolerance), mMaxIterations(
+					maxIterations) {
+	}
+
+	virtual void run(size_t begin, size_t end) {
+		GeodeticCalculator::calculateGeodeticMeasurements(mRefEllipsoid,
+				end - begin, mStarts + begin, mEnds + begin,
+				mMeasurements + begin, mErrorTolerance, mMaxIterations);
+	}
+
+private:
+	const Ellipsoid &mRefEllipsoid;
+	const GlobalPosition *mStarts;
+	const GlobalPosition *mEnds;
+	GeodeticMeasurementValue *mMeasurements;
+	double mErrorTolerance;
+	int mMaxIterations;
+};
+
+/**
+ * Holds a mutex for the lifetime of the object.
+ */
+class ScopedLock {
+public:
+	explicit ScopedLock(pthread_mutex_t &mutex) :
+			mMutex(mutex) {
+		pthread_mutex_lock(&mMutex);
+	}
+	~ScopedLock() {
+		pthread_mutex_unlock(&mMutex);
+	}
+private:
+	pthread_mutex_t &mMutex;
+};
+
+}
+
+const size_t BatchExecutor::DefaultChunkSize;
+
+BatchExecutor::Task::~Task() {
+}
+
+BatchExecutor::BatchExecutor(unsigned threads) :
+		mThreadCount(threads), mInline(false), mGeneration(0), mShutdown(false), mRunning(
+				0), mFailed(false), mTask(0), mCount(0), mChunkSize(
+				DefaultChunkSize) {
+	if (mThreadCount == 0) {
+		long online = sysconf(_SC_NPROCESSORS_ONLN);
+		mThreadCount = online > 0 ? static_cast<unsigned>(online) : 1;
+	}
+
+	pthread_mutex_init(&mRunMutex, 0);
+	pthread_mutex_init(&mMutex, 0);
+	pthread_cond_init(&mWake, 0);
+	pthread_cond_init(&mDone, 0);
+
+	mQueues = new Queue[mThreadCount];
+	mWorkers = new Worker[mThreadCount];
+	mThreads = new pthread_t[mThreadCount];
+	for (unsigned i = 0; i < mThreadCount; ++i) {
+		mWorkers[i].executor = this;
+		mWorkers[i].index = i;
+	}
+
+	// thread limits may stop this short, the workers don't look at the count
+	// or the queues before the first run()
+	unsigned started = 0;
+	while (started < mThreadCount
+			&& pthread_create(&mThreads[started], 0,
+					&BatchExecutor::threadMain, &mWorkers[started]) == 0) {
+		++started;
+	}
+	mInline = started == 0;
+	mThreadCount = mInline ? 1 : started;
+
+	for (unsigned i = 0; i < mThreadCount; ++i) {
+		pthread_mutex_init(&mQueues[i].mutex, 0);
+		mQueues[i].next = mQueues[i].end = 0;
+	}
+}
+
+BatchExecutor::~BatchExecutor() {
+	{
+		ScopedLock lock(mMutex);
+		mShutdown = true;
+		pthread_cond_broadcast(&mWake);
+	}
+	for (unsigned i = 0; !mInline && i < mThreadCount; ++i) {
+		pthread_join(mThreads[i], 0);
+	}
+	for (unsigned i = 0; i < mThreadCount; ++i) {
+		pthread_mutex_destroy(&mQueues[i].mutex);
+	}
+	delete[] mThreads;
+	delete[] mWorkers;
+	delete[] mQueues;
+
+	pthread_cond_destroy(&mDone);
+	pthread_cond_destroy(&mWake);
+	pthread_mutex_destroy(&mMutex);
+	pthread_mutex_destroy(&mRunMutex);
+}
+
+unsigned BatchExecutor::getThreadCount() const {
+	return mThreadCount;
+}
+
+void BatchExecutor::run(Task &task, size_t count, size_t chunkSize) {
+	if (count == 0) {
+		return;
+	}
+	if (chunkSize == 0) {
+		chunkSize = DefaultChunkSize;
+	}
+
+	ScopedLock runLock(mRunMutex);
+
+	// equal contiguous shares, published to the workers by the mutex below
+	size_t chunks = (count + chunkSize - 1) / chunkSize;
+	for (unsigned i = 0; i < mThreadCount; ++i) {
+		ScopedLock lock(mQueues[i].mutex);
+		mQueues[i].next = chunks * i / mThreadCount;
+		mQueues[i].end = chunks * (i + 1) / mThreadCount;
+	}
+
+	bool failed;
+	if (mInline) {
+		mTask = &task;
+		mCount = count;
+		mChunkSize = chunkSize;
+		mFailed = false;
+		process(0);
+		mTask = 0;
+		failed = mFailed;
+	} else {
+		ScopedLock lock(mMutex);
+		mTask = &task;
+		mCount = count;
+		mChunkSize = chunkSize;
+		mRunning = mThreadCount;
+		mFailed = false;
+		++mGeneration;
+		pthread_cond_broadcast(&mWake);
+		while (mRunning > 0) {
+			pthread_cond_wait(&mDone, &mMutex);
+		}
+		mTask = 0;
+		failed = mFailed;
+	}
+
+	if (failed) {
+		throw BatchTaskException();
+	}
+}
+
+void BatchExecutor::calculateGeodeticCurves(
+		const Ellipsoid::ConstPtr &ellipsoid, size_t count,
+		const double *startLatitudes, const double *startLongitudes,
+		const double *endLatitudes, const double *endLongitudes,
+		double *ellipsoidalDistances, double *azimuths,
+		double *reverseAzimuths, double const errorTolerance,
+		int const maxIterations) {
+	calculateGeodeticCurves(*ellipsoid, count, startLatitudes, startLongitudes,
+			endLatitudes, endLongitudes, ellipsoidalDistances, azimuths,
+			reverseAzimuths, GeodeticCalculator::Vincenty, errorTolerance,
+			maxIterations);
+}
+
+void BatchExecutor::calculateGeodeticCurves(const Ellipsoid &ellipsoid,
+		size_t count, const double *startLatitudes,
+		const double *startLongitudes, const double *endLatitudes,
+		const double *endLongitudes, double *ellipsoidalDistances,
+		double *azimuths, double *reverseAzimuths, double const errorTolerance,
+		int const maxIterations) {
+	calculateGeodeticCurves(ellipsoid, count, startLatitudes, startLongitudes,
+			endLatitudes, endLongitudes, ellipsoidalDistances, azimuths,
+			reverseAzimuths, GeodeticCalculator::Vincenty, errorTolerance,
+			maxIterations);
+}
+
+void BatchExecutor::calculateGeodeticCurves(
+		const Ellipsoid::ConstPtr &ellipsoid, size_t count,
+		const double *startLatitudes, const double *startLongitudes,
+		const double *endLatitudes, const double *endLongitudes,
+		double *ellipsoidalDistances, double *azimuths,
+		double *reverseAzimuths, GeodeticCalculator::InverseMethod method,
+		double const errorTolerance, int const maxIterations) {
+	calculateGeodeticCurves(*ellipsoid, count, startLatitudes, startLongitudes,
+			endLatitudes, endLongitudes, ellipsoidalDistances, azimuths,
+			reverseAzimuths, method, errorTolerance, maxIterations);
+}
+
+void BatchExecutor::calculateGeodeticCurves(const Ellipsoid &ellipsoid,
+		size_t count, const double *startLatitudes,
+		const double *startLongitudes, const double *endLatitudes,
+		const double *endLongitudes, double *ellipsoidalDistances,
+		double *azimuths, double *reverseAzimuths,
+		GeodeticCalculator::InverseMethod method, double const errorTolerance,
+		int const maxIterations) {
+	InverseTask task(ellipsoid, startLatitudes, startLongitudes, endLatitudes,
+			endLongitudes, ellipsoidalDistances, azimuths, reverseAzimuths,
+			method, errorTolerance, maxIterations);
+	run(task, count);
+}
+
+void BatchExecutor::calculateEndingGlobalCoordinates(
+		const Ellipsoid::ConstPtr &ellipsoid, size_t count,
+		const double *startLatitudes, const double *startLongitudes,
+		const double *startBearings, const double *distances,
+		double *endLatitudes, double *endLongitudes, double *endBearings,
+		double const errorTolerance, int const maxIterations)
+				throw (InvalidAzimuthException) {
+	calculateEndingGlobalCoordinates(*ellipsoid, count, startLatitudes,
+			startLongitudes, startBearings, distances, endLatitudes,
+			endLongitudes, endBearings, errorTolerance, maxIterations);
+}
+
+void BatchExecutor::calculateEndingGlobalCoordinates(
+		const Ellipsoid &ellipsoid, size_t count,
+		const double *startLatitudes, const double *startLongitudes,
+		const double *startBearings, const double *distances,
+		double *endLatitudes, double *endLongitudes, double *endBearings,
+		double const errorTolerance, int const maxIterations)
+				throw (InvalidAzimuthException) {
+	DirectTask task(ellipsoid, startLatitudes, startLongitudes, startBearings,
+			distances, endLatitudes, endLongitudes, endBearings,
+			errorTolerance, maxIterations);
+	run(task, count);
+	if (task.isInvalid()) {
+		throw InvalidAzimuthException();
+	}
+}
+
+void BatchExecutor::calculateGeodeticMeasurements(
+		const Ellipsoid &refEllipsoid, size_t count,
+		const GlobalPosition *starts, const GlobalPosition *ends,
+		GeodeticMeasurementValue *measurements, double const errorTolerance,
+		int const maxIterations) {
+	MeasurementTask task(refEllipsoid, starts, ends, measurements,
+			errorTolerance, maxIterations);
+	run(task, count);
+}
+
+void *BatchExecutor::threadMain(void *worker) {
+	Worker *w = static_cast<Worker *>(worker);
+	w->executor->work(w->index);
+	return 0;
+}
+
+void BatchExecutor::work(size_t index) {
+	unsigned long seen = 0;
+	for (;;) {
+		{
+			ScopedLock lock(mMutex);
+			while (mGeneration == seen && !mShutdown) {
+				pthread_cond_wait(&mWake, &mMutex);
+			}
+			if (mShutdown) {
+				return;
+			}
+			seen = mGeneration;
+		}
+
+		process(index);
+
+		ScopedLock lock(mMutex);
+		if (--mRunning == 0) {
+			pthread_cond_signal(&mDone);
+		}
+	}
+}
+
+void BatchExecutor::process(size_t index) {
+	size_t chunk;
+	while (popChunk(index, chunk) || stealChunk(index, chunk)) {
+		size_t begin = chunk * mChunkSize;
+		size_t end = min(begin + mChunkSize, mCount);
+		try {
+			mTask->run(begin, end);
+		} catch (...) {
+			ScopedLock lock(mMutex);
+			mFailed = true;
+		}
+	}
+}
+
+bool BatchExecutor::popChunk(size_t index, size_t &chunk) {
+	Queue &queue = mQueues[index];
+	ScopedLock lock(queue.mutex);
+	if (queue.next == queue.end) {
+		return false;
+	}
+	chunk = queue.next++;
+	return true;
+}
+
+bool BatchExecutor::stealChunk(size_t index, size_t &chunk) {
+	// take the back half of the largest share left, steals are rare enough
+	// that looking at every queue under its lock is cheap
+	for (;;) {
+		size_t victim = index;
+		size_t most = 0;
+		for (size_t i = 1; i < mThreadCount; ++i) {
+			size_t candidate = (index + i) % mThreadCount;
+			Queue &queue = mQueues[candidate];
+			ScopedLock lock(queue.mutex);
+			if (queue.end - queue.next > most) {
+				most = queue.end - queue.next;
+				victim = candidate;
+			}
+		}
+		if (victim == index) {
+			return false;
+		}
+
+		size_t begin, end;
+		{
+			Queue &queue = mQueues[victim];
+			ScopedLock lock(queue.mutex);
+			if (queue.next == queue.end) {
+				// emptied since we looked, look again
+				continue;
+			}
+			end = queue.end;
+			begin = end - max<size_t>(1, (end - queue.next) / 2);
+			queue.end = begin;
+		}
+
+		// the first stolen chunk is done now, the rest can be stolen in turn
+		Queue &own = mQueues[index];
+		ScopedLock lock(own.mutex);
+		own.next = begin + 1;
+		own.end = end;
+		chunk = begin;
+		return true;
+	}
+}
+
+}
@@ -0,0 +1,289 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#ifndef BATCHEXECUTOR_HPP_
+#define BATCHEXECUTOR_HPP_
+
+#include <cstddef>
+#include <exception>
+#include <pthread.h>
+#include <tr1/memory>
+
+#include "Ellipsoid.hpp"
+#include "GeodeticCalculator.hpp"
+
+namespace geodesy {
+
+/**
+ * Thrown by BatchExecutor::run() when a task threw an exception.
+ */
+class BatchTaskException: public std::exception {
+public:
+	BatchTaskException() {
+	}
+	virtual ~BatchTaskException() throw () {
+	}
+	/**
+	 * @see exception::what()
+	 */
+	virtual const char * what() const throw () {
+		return "Batch task failed";
+	}
+};
+
+/**
+ * <p>
+ * A pool of worker threads that runs large batches of geodetic problems in
+ * parallel.
+ * </p>
+ * <p>
+ * A batch of count items is cut into chunks of chunkSize items. Every worker
+ * starts with an equal, contiguous share of the chunks and takes them from the
+ * front. A worker that runs out steals the back half of the share of the
+ * busiest worker it can find. Chunks whose problems need many iterations (near
+ * antipodal pairs, for instance) therefore don't leave the other cores idle
+ * at the end of a batch, and in the common case each worker only touches its
+ * own share.
+ * </p>
+ * <p>
+ * One batch runs at a time; concurrent calls to run() are serialized.
+ * </p>
+ */
+class BatchExecutor {
+public:
+	typedef std::tr1::shared_ptr<BatchExecutor> Ptr;
+	typedef std::tr1::shared_ptr<BatchExecutor const> ConstPtr;
+
+	/**
+	 * Work to be done over a range of items. run() is called from the worker
+	 * threads, concurrently for disjoint ranges, and must not throw.
+	 */
+	class Task {
+	public:
+		virtual ~Task();
+
+		/**
+		 * Process items [begin, end).
+		 */
+		virtual void run(std::size_t begin, std::size_t end) = 0;
+	};
+
+	/**
+	 * Default number of items per chunk. Large enough to amortize the
+	 * scheduling, small enough that the inputs and outputs of a chunk stay in
+	 * the first level cache.
+	 */
+	static const std::size_t DefaultChunkSize = 512;
+
+	/**
+	 * Start the worker threads. If the system won't start as many as asked
+	 * for, the executor makes do with those it got, and if it won't start
+	 * any, run() does the work on the calling thread.
+	 *
+	 * @param threads number of worker threads, 0 for one per online processor
+	 */
+	explicit BatchExecutor(unsigned threads = 0);
+
+	/**
+	 * Stop and join the worker threads.
+	 */
+	virtual ~BatchExecutor();
+
+	/**
+	 * Get the number of threads that run the tasks: the worker threads that
+	 * could be started, or 1 for the calling thread if none could.
+	 * @return
+	 */
+	unsigned getThreadCount() const;
+
+	/**
+	 * Run a task over items [0, count) and wait for it to finish.
+	 *
+	 * @param task the work
+	 * @param count number of items
+	 * @param chunkSize number of items handed to a worker at a time
+	 * @throws BatchTaskException if the task threw, the other chunks are
+	 *           still processed
+	 */
+	void run(Task &task, std::size_t count, std::size_t chunkSize =
+			DefaultChunkSize);
+
+	/**
+	 * Parallel form of GeodeticCalculator::calculateGeodeticCurves(), same
+	 * parameters.
+	 */
+	void calculateGeodeticCurves(const Ellipsoid::ConstPtr &ellipsoid,
+			std::size_t count, const double *startLatitudes,
+			const double *startLongitudes, const double *endLatitudes,
+			const double *endLongitudes, double *ellipsoidalDistances,
+			double *azimuths, double *reverseAzimuths,
+			double const errorTolerance = 1E-13, int const maxIterations = 20);
+
+	/**
+	 * Same as calculateGeodeticCurves() above, with the ellipsoid by
+	 * reference.
+	 */
+	void calculateGeodeticCurves(const Ellipsoid &ellipsoid,
+			std::size_t count, const double *startLatitudes,
+			const double *startLongitudes, const double *endLatitudes,
+			const double *endLongitudes, double *ellipsoidalDistances,
+			double *azimuths, double *reverseAzimuths,
+			double const errorTolerance = 1E-13, int const maxIterations = 20);
+
+	/**
+	 * Parallel form of GeodeticCalculator::calculateGeodeticCurves() with a
+	 * choice of algorithm, same parameters.
+	 */
+	void calculateGeodeticCurves(const Ellipsoid::ConstPtr &ellipsoid,
+			std::size_t count, const double *startLatitudes,
+			const double *startLongitudes, const double *endLatitudes,
+			const double *endLongitudes, double *ellipsoidalDistances,
+			double *azimuths, double *reverseAzimuths,
+			GeodeticCalculator::InverseMethod method,
+			double const errorTolerance = 1E-13, int const maxIterations = 20);
+
+	/**
+	 * Same as calculateGeodeticCurves() above, with the ellipsoid by
+	 * reference.
+	 */
+	void calculateGeodeticCurves(const Ellipsoid &ellipsoid,
+			std::size_t count, const double *startLatitudes,
+			const double *startLongitudes, const double *endLatitudes,
+			const double *endLongitudes, double *ellipsoidalDistances,
+			double *azimuths, double *reverseAzimuths,
+			GeodeticCalculator::InverseMethod method,
+			double const errorTolerance = 1E-13, int const maxIterations = 20);
+
+	/**
+	 * Parallel form of the batch
+	 * GeodeticCalculator::calculateEndingGlobalCoordinates(), same
+	 * parameters.
+	 *
+	 * @throws InvalidAzimuthException if a starting bearing is NaN, the
+	 *           results are then incomplete
+	 */
+	void calculateEndingGlobalCoordinates(
+			const Ellipsoid::ConstPtr &ellipsoid, std::size_t count,
+			const double *startLatitudes, const double *startLongitudes,
+			const double *startBearings, const double *distances,
+			double *endLatitudes, double *endLongitudes, double *endBearings,
+			double const errorTolerance = 1E-13, int const maxIterations = 20)
+					throw (InvalidAzimuthException);
+
+	/**
+	 * Same as calculateEndingGlobalCoordinates() above, with the ellipsoid by
+	 * reference.
+	 *
+	 * @throws InvalidAzimuthException if a starting bearing is NaN, the
+	 *           results are then incomplete
+	 */
+	void calculateEndingGlobalCoordinates(const Ellipsoid &ellipsoid,
+			std::size_t count, const double *startLatitudes,
+			const double *startLongitudes, const double *startBearings,
+			const double *distances, double *endLatitudes,
+			double *endLongitudes, double *endBearings,
+			double const errorTolerance = 1E-13, int const maxIterations = 20)
+					throw (InvalidAzimuthException);
+
+	/**
+	 * Parallel form of GeodeticCalculator::calculateGeodeticMeasurements(),
+	 * same parameters.
+	 */
+	void calculateGeodeticMeasurements(const Ellipsoid &refEllipsoid,
+			std::size_t count, const GlobalPosition *starts,
+			const GlobalPosition *ends, GeodeticMeasurementValue *measurements,
+			double const errorTolerance = 1E-13, int const maxIterations = 20);
+
+private:
+	/**
+	 * The chunks a worker still has to do, [next, end). Padded so that the
+	 * queues of different workers don't share a cache line.
+	 */
+	struct Queue {
+		pthread_mutex_t mutex;
+		std::size_t next;
+		std::size_t end;
+		char padding[64];
+	};
+
+	/** Arguments of a worker thread. */
+	struct Worker {
+		BatchExecutor *executor;
+		std::size_t index;
+	};
+
+	static void *threadMain(void *worker);
+
+	void work(std::size_t index);
+
+	void process(std::size_t index);
+
+	bool popChunk(std::size_t index, std::size_t &chunk);
+
+	bool stealChunk(std::size_t index, std::size_t &chunk);
+
+	// no copies
+	BatchExecutor(const BatchExecutor &);
+	BatchExecutor &operator=(const BatchExecutor &);
+
+	/** Number of worker threads, or 1 when mInline. */
+	unsigned mThreadCount;
+
+	/** No worker thread could be started, run() does the work itself. */
+	bool mInline;
+
+	pthread_t *mThreads;
+	Worker *mWorkers;
+	Queue *mQueues;
+
+	/** Serializes calls to run(). */
+	pthread_mutex_t mRunMutex;
+
+	/** Protects everything below. */
+	pthread_mutex_t mMutex;
+	pthread_cond_t mWake;
+	pthread_cond_t mDone;
+
+	/** Incremented for every batch, workers wait for it to change. */
+	unsigned long mGeneration;
+	bool mShutdown;
+
+	/** Number of workers still busy with the current batch. */
+	unsigned mRunning;
+	bool mFailed;
+
+	/** The current batch. */
+	Task *mTask;
+	std::size_t mCount;
+	std::size_t mChunkSize;
+
+};
+
+}
+
+#endif /* BATCHEXECUTOR_HPP_ */
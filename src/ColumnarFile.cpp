@@ -0,0 +1,664 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#include "ColumnarFile.hpp"
+#include "FileUtil.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace geodesy {
+
+using namespace std;
+
+const double ColumnarFile::FixedPointScale = 1E-7;
+
+const std::size_t ColumnarWriter::DefaultBlockSize;
+
+namespace {
+
+struct Header {
+	char magic[8];
+	unsigned int version;
+	/** ByteOrder as written, to catch files from other architectures. */
+	unsigned int byteOrder;
+	unsigned int content;
+	unsigned int columnCount;
+	unsigned long long rowCount;
+	unsigned long long blockCount;
+	/** Maximum number of rows per block. */
+	unsigned long long blockSize;
+	unsigned long long reserved[2];
+};
+
+/** Follows the header, one per column. */
+struct ColumnHeader {
+	unsigned int encoding;
+	unsigned int reserved;
+	/** FixedPoint32 only: units per degree. */
+	double units;
+	/** FixedPoint32 only: value in degrees of 0. */
+	double offset;
+	unsigned long long padding;
+};
+
+/**
+ * Starts a block, followed by the minimum and maximum of each column (two
+ * doubles per column) and by the values of each column, each padded to a
+ * multiple of 8 bytes.
+ */
+struct BlockHeader {
+	unsigned long long rowCount;
+	unsigned long long reserved;
+};
+
+const char Magic[8] = { 'G', 'E', 'O', 'C', 'O', 'L', 'M', 'N' };
+const unsigned int Version = 1;
+const unsigned int ByteOrder = 0x01020304;
+
+/** FixedPoint32 units per degree. */
+const double FixedPointUnits = 1E7;
+
+/** FixedPoint32 value of NaN, outside the range of the other values. */
+const int FixedPointNaN = numeric_limits<int>::min();
+
+const double NaN = numeric_limits<double>::quiet_NaN();
+
+/**
+ * Get the FixedPoint32 offset of a column: azimuths are in [0, 360) and
+ * only fit 32 bits relative to 180 degrees.
+ */
+double fixedPointOffset(ColumnarFile::Content content, std::size_t column) {
+	if (content != ColumnarFile::Coordinates
+			&& (column == ColumnarFile::AzimuthColumn
+					|| column == ColumnarFile::ReverseAzimuthColumn)) {
+		return 180;
+	}
+	return 0;
+}
+
+std::size_t columnBytes(ColumnarFile::Encoding encoding, std::size_t rows) {
+	if (encoding == ColumnarFile::FixedPoint32) {
+		return (sizeof(int) * rows + 7) / 8 * 8;
+	}
+	return sizeof(double) * rows;
+}
+
+/**
+ * Bytes per row of the values of a block, not counting the padding of the
+ * FixedPoint32 columns.
+ */
+std::size_t rowBytes(const vector<ColumnarFile::Encoding> &encodings) {
+	std::size_t size = 0;
+	for (std::size_t c = 0; c < encodings.size(); ++c) {
+		size += encodings[c] == ColumnarFile::FixedPoint32 ?
+				sizeof(int) : sizeof(double);
+	}
+	return size;
+}
+
+std::size_t blockBytes(const vector<ColumnarFile::Encoding> &encodings,
+		std::size_t rows) {
+	std::size_t size = sizeof(BlockHeader)
+			+ 2 * sizeof(double) * encodings.size();
+	for (std::size_t c = 0; c < encodings.size(); ++c) {
+		size += columnBytes(encodings[c], rows);
+	}
+	return size;
+}
+
+/**
+ * Convert to FixedPoint32 units, or tell that the value doesn't fit.
+ */
+bool toFixedPoint(double value, double offset, int &fixed) {
+	if (isnan(value)) {
+		fixed = FixedPointNaN;
+		return true;
+	}
+	double units = floor((value - offset) * FixedPointUnits + 0.5);
+	if (!(units > FixedPointNaN && units <= numeric_limits<int>::max())) {
+		return false;
+	}
+	fixed = static_cast<int>(units);
+	return true;
+}
+
+double fromFixedPoint(int fixed, double offset) {
+	if (fixed == FixedPointNaN) {
+		return NaN;
+	}
+	return offset + fixed / FixedPointUnits;
+}
+
+/**
+ * Widen [minimum, maximum] to include a value, NaN values aside. An empty
+ * range is NaN, NaN.
+ */
+void include(double value, double &minimum, double &maximum) {
+	if (isnan(value)) {
+		return;
+	}
+	if (isnan(minimum) || value < minimum) {
+		minimum = value;
+	}
+	if (isnan(maximum) || value > maximum) {
+		maximum = value;
+	}
+}
+
+string errorMessage(const string &what, const string &path) {
+	return what + " " + path + ": " + strerror(errno);
+}
+
+}
+
+std::size_t ColumnarFile::getColumnCount(Content content) {
+	switch (content) {
+	case Coordinates:
+		return 2;
+	case Curves:
+		return 3;
+	case Measurements:
+		return 5;
+	}
+	return 0;
+}
+
+bool ColumnarFile::isAngle(Content content, std::size_t column) {
+	if (content == Coordinates) {
+		return column < 2;
+	}
+	return column == AzimuthColumn || column == ReverseAzimuthColumn;
+}
+
+ColumnarWriter::ColumnarWriter(const std::string &path,
+		ColumnarFile::Content content, ColumnarFile::Encoding angleEncoding,
+		std::size_t blockSize) throw (ColumnarFileException) :
+		mPath(path), mTemporaryPath(path + ".tmp"), mFile(0), mContent(
+				content), mBlockSize(blockSize > 0 ? blockSize : 1), mRowCount(
+				0), mBlockCount(0) {
+	std::size_t columnCount = ColumnarFile::getColumnCount(content);
+	if (columnCount == 0) {
+		throw ColumnarFileException("Unknown content");
+	}
+	for (std::size_t c = 0; c < columnCount; ++c) {
+		bool fixed = angleEncoding == ColumnarFile::FixedPoint32
+				&& ColumnarFile::isAngle(content, c);
+		mEncodings.push_back(
+				fixed ? ColumnarFile::FixedPoint32 : ColumnarFile::Float64);
+		mOffsets.push_back(fixed ? fixedPointOffset(content, c) : 0);
+	}
+	mColumns.resize(columnCount);
+
+	mFile = fopen(mTemporaryPath.c_str(), "wb");
+	if (!mFile) {
+		throw ColumnarFileException(
+				errorMessage("Can't create", mTemporaryPath));
+	}
+
+	// the header is written again with the counts by close()
+	try {
+		Header header;
+		memset(&header, 0, sizeof(header));
+		writeBytes(&header, sizeof(header));
+		for (std::size_t c = 0; c < columnCount; ++c) {
+			ColumnHeader column;
+			memset(&column, 0, sizeof(column));
+			column.encoding = mEncodings[c];
+			if (mEncodings[c] == ColumnarFile::FixedPoint32) {
+				column.units = FixedPointUnits;
+				column.offset = mOffsets[c];
+			}
+			writeBytes(&column, sizeof(column));
+		}
+	} catch (const ColumnarFileException &) {
+		fclose(mFile);
+		remove(mTemporaryPath.c_str());
+		throw;
+	}
+}
+
+ColumnarWriter::~ColumnarWriter() {
+	if (mFile) {
+		fclose(mFile);
+		remove(mTemporaryPath.c_str());
+	}
+}
+
+void ColumnarWriter::writeCoordinates(std::size_t count,
+		const double *latitudes, const double *longitudes)
+				throw (ColumnarFileException) {
+	const double *columns[] = { latitudes, longitudes };
+	append(ColumnarFile::Coordinates, count, columns);
+}
+
+void ColumnarWriter::writeCoordinates(std::size_t count,
+		const LatLon *coordinates) throw (ColumnarFileException) {
+	const std::size_t BatchSize = 256;
+	double latitudes[BatchSize];
+	double longitudes[BatchSize];
+
+	for (std::size_t offset = 0; offset < count; offset += BatchSize) {
+		std::size_t n = min(BatchSize, count - offset);
+		for (std::size_t i = 0; i < n; ++i) {
+			latitudes[i] = coordinates[offset + i].latitude;
+			longitudes[i] = coordinates[offset + i].longitude;
+		}
+		writeCoordinates(n, latitudes, longitudes);
+	}
+}
+
+void ColumnarWriter::write(const GlobalCoordinates &coordinates)
+		throw (ColumnarFileException) {
+	double latitude = coordinates.getLatitude();
+	double longitude = coordinates.getLongitude();
+	writeCoordinates(1, &latitude, &longitude);
+}
+
+void ColumnarWriter::writeCurves(std::size_t count,
+		const double *ellipsoidalDistances, const double *azimuths,
+		const double *reverseAzimuths) throw (ColumnarFileException) {
+	const double *columns[] = { ellipsoidalDistances, azimuths,
+			reverseAzimuths };
+	append(ColumnarFile::Curves, count, columns);
+}
+
+void ColumnarWriter::write(const GeodeticCurveValue &curve)
+		throw (ColumnarFileException) {
+	writeCurves(1, &curve.ellipsoidalDistance, &curve.azimuth,
+			&curve.reverseAzimuth);
+}
+
+void ColumnarWriter::write(const GeodeticCurve &curve)
+		throw (ColumnarFileException) {
+	GeodeticCurveValue value;
+	value.ellipsoidalDistance = curve.getEllipsoidalDistance();
+	value.azimuth = curve.getAzimuth();
+	value.reverseAzimuth = curve.getReverseAzimuth();
+	write(value);
+}
+
+void ColumnarWriter::writeMeasurements(std::size_t count,
+		const double *ellipsoidalDistances, const double *azimuths,
+		const double *reverseAzimuths, const double *elevationChanges,
+		const double *pointToPointDistances) throw (ColumnarFileException) {
+	const double *columns[] = { ellipsoidalDistances, azimuths,
+			reverseAzimuths, elevationChanges, pointToPointDistances };
+	append(ColumnarFile::Measurements, count, columns);
+}
+
+void ColumnarWriter::write(const GeodeticMeasurementValue &measurement)
+		throw (ColumnarFileException) {
+	writeMeasurements(1, &measurement.ellipsoidalDistance,
+			&measurement.azimuth, &measurement.reverseAzimuth,
+			&measurement.elevationChange, &measurement.pointToPointDistance);
+}
+
+void ColumnarWriter::write(const GeodeticMeasurement &measurement)
+		throw (ColumnarFileException) {
+	GeodeticMeasurementValue value;
+	value.ellipsoidalDistance = measurement.getEllipsoidalDistance();
+	value.azimuth = measurement.getAzimuth();
+	value.reverseAzimuth = measurement.getReverseAzimuth();
+	value.elevationChange = measurement.getElevationChange();
+	value.pointToPointDistance = measurement.getPointToPointDistance();
+	write(value);
+}
+
+void ColumnarWriter::append(ColumnarFile::Content content, std::size_t count,
+		const double * const *columns) throw (ColumnarFileException) {
+	if (!mFile) {
+		throw ColumnarFileException("Writer is closed: " + mPath);
+	}
+	if (content != mContent) {
+		throw ColumnarFileException("Wrong content for " + mPath);
+	}
+
+	// check the whole call first, so that a failed call appends nothing
+	for (std::size_t c = 0; c < mColumns.size(); ++c) {
+		if (mEncodings[c] != ColumnarFile::FixedPoint32) {
+			continue;
+		}
+		for (std::size_t i = 0; i < count; ++i) {
+			int fixed;
+			if (!toFixedPoint(columns[c][i], mOffsets[c], fixed)) {
+				throw ColumnarFileException(
+						"Angle out of fixed point range for " + mPath);
+			}
+		}
+	}
+
+	std::size_t done = 0;
+	while (done < count) {
+		std::size_t n = min(count - done, mBlockSize - mColumns[0].size());
+		for (std::size_t c = 0; c < mColumns.size(); ++c) {
+			mColumns[c].insert(mColumns[c].end(), columns[c] + done,
+					columns[c] + done + n);
+		}
+		done += n;
+		mRowCount += n;
+		if (mColumns[0].size() == mBlockSize) {
+			writeBlock();
+		}
+	}
+}
+
+void ColumnarWriter::writeBlock() throw (ColumnarFileException) {
+	std::size_t rows = mColumns[0].size();
+	std::size_t columnCount = mColumns.size();
+	vector<char> block(blockBytes(mEncodings, rows), 0);
+
+	BlockHeader header;
+	memset(&header, 0, sizeof(header));
+	header.rowCount = rows;
+	memcpy(&block[0], &header, sizeof(header));
+
+	double *ranges = reinterpret_cast<double *>(&block[sizeof(header)]);
+	char *data = reinterpret_cast<char *>(ranges + 2 * columnCount);
+	for (std::size_t c = 0; c < columnCount; ++c) {
+		const vector<double> &values = mColumns[c];
+		double minimum = NaN;
+		double maximum = NaN;
+
+		if (mEncodings[c] == ColumnarFile::FixedPoint32) {
+			// the range of the values as they are read back
+			int *fixed = reinterpret_cast<int *>(data);
+			for (std::size_t i = 0; i < rows; ++i) {
+				toFixedPoint(values[i], mOffsets[c], fixed[i]);
+				include(fromFixedPoint(fixed[i], mOffsets[c]), minimum,
+						maximum);
+			}
+		} else {
+			memcpy(data, &values[0], sizeof(double) * rows);
+			for (std::size_t i = 0; i < rows; ++i) {
+				include(values[i], minimum, maximum);
+			}
+		}
+		ranges[2 * c] = minimum;
+		ranges[2 * c + 1] = maximum;
+		data += columnBytes(mEncodings[c], rows);
+		mColumns[c].clear();
+	}
+
+	writeBytes(&block[0], block.size());
+	++mBlockCount;
+}
+
+void ColumnarWriter::writeBytes(const void *data, std::size_t size)
+		throw (ColumnarFileException) {
+	if (fwrite(data, 1, size, mFile) != size) {
+		throw ColumnarFileException(
+				errorMessage("Can't write", mTemporaryPath));
+	}
+}
+
+void ColumnarWriter::close() throw (ColumnarFileException) {
+	if (!mFile) {
+		throw ColumnarFileException("Writer is closed: " + mPath);
+	}
+
+	// on failure the destructor removes the temporary file
+	if (!mColumns[0].empty()) {
+		writeBlock();
+	}
+
+	Header header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, Magic, sizeof(Magic));
+	header.version = Version;
+	header.byteOrder = ByteOrder;
+	header.content = mContent;
+	header.columnCount = mColumns.size();
+	header.rowCount = mRowCount;
+	header.blockCount = mBlockCount;
+	header.blockSize = mBlockSize;
+	if (fseek(mFile, 0, SEEK_SET) != 0) {
+		throw ColumnarFileException(
+				errorMessage("Can't write", mTemporaryPath));
+	}
+	writeBytes(&header, sizeof(header));
+
+	FILE *file = mFile;
+	mFile = 0;
+	if (!fileutil::closeSynced(file)) {
+		string message = errorMessage("Can't write", mTemporaryPath);
+		remove(mTemporaryPath.c_str());
+		throw ColumnarFileException(message);
+	}
+	if (rename(mTemporaryPath.c_str(), mPath.c_str()) != 0) {
+		string message = errorMessage("Can't rename to", mPath);
+		remove(mTemporaryPath.c_str());
+		throw ColumnarFileException(message);
+	}
+	if (!fileutil::syncDirectory(mPath)) {
+		throw ColumnarFileException(
+				errorMessage("Can't sync the directory of", mPath));
+	}
+}
+
+std::size_t ColumnarWriter::getRowCount() const {
+	return mRowCount;
+}
+
+ColumnarReader::ColumnarReader() :
+		mMapping(0), mMappingSize(0), mContent(ColumnarFile::Coordinates), mRowCount(
+				0) {
+}
+
+ColumnarReader::~ColumnarReader() {
+	if (mMapping) {
+		munmap(mMapping, mMappingSize);
+	}
+}
+
+ColumnarReader::Ptr ColumnarReader::open(const std::string &path)
+		throw (ColumnarFileException) {
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		throw ColumnarFileException(errorMessage("Can't open", path));
+	}
+	struct stat status;
+	if (fstat(fd, &status) != 0) {
+		string message = errorMessage("Can't stat", path);
+		::close(fd);
+		throw ColumnarFileException(message);
+	}
+	std::size_t size = status.st_size;
+	if (size < sizeof(Header)) {
+		::close(fd);
+		throw ColumnarFileException("Not a columnar file: " + path);
+	}
+
+	void *mapping = mmap(0, size, PROT_READ, MAP_SHARED, fd, 0);
+	if (mapping == MAP_FAILED) {
+		string message = errorMessage("Can't map", path);
+		::close(fd);
+		throw ColumnarFileException(message);
+	}
+	::close(fd);
+
+	ColumnarReader::Ptr reader(new ColumnarReader());
+	reader->mMapping = mapping;
+	reader->mMappingSize = size;
+	string problem = reader->attach();
+	if (!problem.empty()) {
+		throw ColumnarFileException(problem + ": " + path);
+	}
+	return reader;
+}
+
+std::string ColumnarReader::attach() {
+	const char *file = static_cast<const char *>(mMapping);
+	Header header;
+	memcpy(&header, file, sizeof(header));
+	if (memcmp(header.magic, Magic, sizeof(Magic)) != 0) {
+		return "Not a columnar file";
+	}
+	if (header.byteOrder != ByteOrder) {
+		return "Columnar file of another byte order";
+	}
+	if (header.version != Version) {
+		return "Unsupported columnar file version";
+	}
+	mContent = static_cast<ColumnarFile::Content>(header.content);
+	std::size_t columnCount = ColumnarFile::getColumnCount(mContent);
+	if (columnCount == 0 || header.columnCount != columnCount) {
+		return "Unknown columnar file content";
+	}
+
+	std::size_t position = sizeof(Header)
+			+ columnCount * sizeof(ColumnHeader);
+	if (position > mMappingSize) {
+		return "Truncated columnar file";
+	}
+	for (std::size_t c = 0; c < columnCount; ++c) {
+		ColumnHeader column;
+		memcpy(&column, file + sizeof(Header) + c * sizeof(ColumnHeader),
+				sizeof(column));
+		if (column.encoding == ColumnarFile::Float64) {
+			mEncodings.push_back(ColumnarFile::Float64);
+			mOffsets.push_back(0);
+		} else if (column.encoding == ColumnarFile::FixedPoint32
+				&& column.units == FixedPointUnits) {
+			mEncodings.push_back(ColumnarFile::FixedPoint32);
+			mOffsets.push_back(column.offset);
+		} else {
+			return "Unknown columnar file encoding";
+		}
+	}
+
+	mRowCount = header.rowCount;
+	std::size_t bytesPerRow = rowBytes(mEncodings);
+	std::size_t rows = 0;
+	for (unsigned long long b = 0; b < header.blockCount; ++b) {
+		if (mMappingSize - position < sizeof(BlockHeader)) {
+			return "Truncated columnar file";
+		}
+		BlockHeader block;
+		memcpy(&block, file + position, sizeof(block));
+		if (block.rowCount == 0 || block.rowCount > header.blockSize) {
+			return "Corrupt columnar file";
+		}
+		// the counts come from the file, one that can't be there must not
+		// reach blockBytes(), where it would wrap around
+		if (block.rowCount > (mMappingSize - position) / bytesPerRow) {
+			return "Truncated columnar file";
+		}
+		std::size_t size = blockBytes(mEncodings, block.rowCount);
+		if (mMappingSize - position < size) {
+			return "Truncated columnar file";
+		}
+		mBlockPositions.push_back(position);
+		mBlockStarts.push_back(rows);
+		position += size;
+		rows += block.rowCount;
+	}
+	mBlockStarts.push_back(rows);
+	if (rows != mRowCount || position != mMappingSize) {
+		return "Corrupt columnar file";
+	}
+	return "";
+}
+
+ColumnarFile::Content ColumnarReader::getContent() const {
+	return mContent;
+}
+
+std::size_t ColumnarReader::getColumnCount() const {
+	return mEncodings.size();
+}
+
+ColumnarFile::Encoding ColumnarReader::getEncoding(std::size_t column) const {
+	return mEncodings[column];
+}
+
+std::size_t ColumnarReader::getRowCount() const {
+	return mRowCount;
+}
+
+std::size_t ColumnarReader::getBlockCount() const {
+	return mBlockPositions.size();
+}
+
+std::size_t ColumnarReader::getBlockStart(std::size_t block) const {
+	return mBlockStarts[block];
+}
+
+std::size_t ColumnarReader::getBlockRowCount(std::size_t block) const {
+	return mBlockStarts[block + 1] - mBlockStarts[block];
+}
+
+double ColumnarReader::getBlockMinimum(std::size_t block,
+		std::size_t column) const {
+	const char *ranges = static_cast<const char *>(mMapping)
+			+ mBlockPositions[block] + sizeof(BlockHeader);
+	return reinterpret_cast<const double *>(ranges)[2 * column];
+}
+
+double ColumnarReader::getBlockMaximum(std::size_t block,
+		std::size_t column) const {
+	const char *ranges = static_cast<const char *>(mMapping)
+			+ mBlockPositions[block] + sizeof(BlockHeader);
+	return reinterpret_cast<const double *>(ranges)[2 * column + 1];
+}
+
+void ColumnarReader::readBlock(std::size_t block, std::size_t column,
+		double *values) const {
+	std::size_t rows = getBlockRowCount(block);
+	const char *data = static_cast<const char *>(mMapping)
+			+ mBlockPositions[block] + sizeof(BlockHeader)
+			+ 2 * sizeof(double) * mEncodings.size();
+	for (std::size_t c = 0; c < column; ++c) {
+		data += columnBytes(mEncodings[c], rows);
+	}
+
+	if (mEncodings[column] == ColumnarFile::FixedPoint32) {
+		const int *fixed = reinterpret_cast<const int *>(data);
+		double offset = mOffsets[column];
+		for (std::size_t i = 0; i < rows; ++i) {
+			values[i] = fromFixedPoint(fixed[i], offset);
+		}
+	} else {
+		memcpy(values, data, sizeof(double) * rows);
+	}
+}
+
+void ColumnarReader::readColumn(std::size_t column, double *values) const {
+	for (std::size_t b = 0; b < mBlockPositions.size(); ++b) {
+		readBlock(b, column, values + mBlockStarts[b]);
+	}
+}
+
+}
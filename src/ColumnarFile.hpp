@@ -0,0 +1,454 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#ifndef COLUMNARFILE_HPP_
+#define COLUMNARFILE_HPP_
+
+#include <cstdio>
+#include <cstddef>
+#include <exception>
+#include <string>
+#include <tr1/memory>
+#include <vector>
+
+#include "GeodeticCurve.hpp"
+#include "GeodeticMeasurement.hpp"
+#include "GlobalCoordinates.hpp"
+#include "LatLon.hpp"
+
+namespace geodesy {
+
+/**
+ * Thrown when a columnar file can't be written or read.
+ */
+class ColumnarFileException: public std::exception {
+public:
+	explicit ColumnarFileException(const std::string &message) :
+			mMessage(message) {
+	}
+	virtual ~ColumnarFileException() throw () {
+	}
+	/**
+	 * @see exception::what()
+	 */
+	virtual const char * what() const throw () {
+		return mMessage.c_str();
+	}
+
+private:
+	std::string mMessage;
+};
+
+/**
+ * <p>
+ * Binary file of coordinates, geodetic curves or geodetic measurements,
+ * written by ColumnarWriter and read by ColumnarReader. It takes a fraction
+ * of the space of the text written by the stream operators and is read
+ * without parsing.
+ * </p>
+ * <p>
+ * Rows are stored in blocks of up to a fixed number of rows. Within a block
+ * each column is stored contiguously, preceded by the minimum and maximum of
+ * every column in the block, so that readers can skip the blocks that can't
+ * match a range query and read only the columns they need. The file starts
+ * with a versioned header and a description of the encoding of each column,
+ * and is in the byte order of the machine that wrote it.
+ * </p>
+ * <p>
+ * Columns are 64 bit doubles, or for the angles optionally 32 bit integers
+ * in units of 1E-7 degrees (about 1 cm on the ground), which halves their
+ * size. Azimuths are stored relative to 180 degrees so that they fit. NaN is
+ * kept in both encodings.
+ * </p>
+ */
+class ColumnarFile {
+public:
+	/** What the rows of a file are. */
+	enum Content {
+		/** Latitude and longitude, see CoordinateColumn. */
+		Coordinates = 1,
+		/** GeodeticCurve values, see CurveColumn. */
+		Curves = 2,
+		/** GeodeticMeasurement values, see CurveColumn. */
+		Measurements = 3
+	};
+
+	/** How the values of a column are stored. */
+	enum Encoding {
+		/** 64 bit doubles. */
+		Float64 = 1,
+		/** 32 bit integers, in units of FixedPointScale degrees. */
+		FixedPoint32 = 2
+	};
+
+	/** The columns of a Coordinates file. */
+	enum CoordinateColumn {
+		LatitudeColumn = 0, LongitudeColumn = 1
+	};
+
+	/**
+	 * The columns of a Curves file, and the first columns of a Measurements
+	 * file.
+	 */
+	enum CurveColumn {
+		EllipsoidalDistanceColumn = 0,
+		AzimuthColumn = 1,
+		ReverseAzimuthColumn = 2,
+		/** Measurements only. */
+		ElevationChangeColumn = 3,
+		/** Measurements only. */
+		PointToPointDistanceColumn = 4
+	};
+
+	/** Degrees per unit of the FixedPoint32 encoding. */
+	static const double FixedPointScale;
+
+	/**
+	 * Get the number of columns of a kind of file.
+	 *
+	 * @param content the kind of file
+	 * @return
+	 */
+	static std::size_t getColumnCount(Content content);
+
+	/**
+	 * Tell if a column holds angles, which may be stored as FixedPoint32.
+	 *
+	 * @param content the kind of file
+	 * @param column the column
+	 * @return
+	 */
+	static bool isAngle(Content content, std::size_t column);
+};
+
+/**
+ * <p>
+ * Writes a ColumnarFile. Rows are buffered until a block is full, so the
+ * file can be much larger than memory.
+ * </p>
+ * <p>
+ * The rows go to a temporary file next to the destination, which close()
+ * renames over it: the file either appears complete or not at all. A writer
+ * destroyed without close() discards what was written.
+ * </p>
+ */
+class ColumnarWriter {
+public:
+	typedef std::tr1::shared_ptr<ColumnarWriter> Ptr;
+	typedef std::tr1::shared_ptr<ColumnarWriter const> ConstPtr;
+
+	/** Default maximum number of rows per block. */
+	static const std::size_t DefaultBlockSize = 65536;
+
+	/**
+	 * Start writing a file.
+	 *
+	 * @param path the file, replaced on close() if it exists
+	 * @param content what the rows are
+	 * @param angleEncoding how the angle columns are stored, the other
+	 *          columns are always Float64
+	 * @param blockSize maximum number of rows per block
+	 * @throws ColumnarFileException if the file can't be created
+	 */
+	ColumnarWriter(const std::string &path, ColumnarFile::Content content,
+			ColumnarFile::Encoding angleEncoding = ColumnarFile::Float64,
+			std::size_t blockSize = DefaultBlockSize)
+					throw (ColumnarFileException);
+
+	virtual ~ColumnarWriter();
+
+	/**
+	 * Append coordinates to a Coordinates file.
+	 *
+	 * @param count number of rows
+	 * @param latitudes latitudes (degrees)
+	 * @param longitudes longitudes (degrees)
+	 * @throws ColumnarFileException if the file isn't a Coordinates file, a
+	 *           value doesn't fit the encoding or the file can't be written
+	 */
+	void writeCoordinates(std::size_t count, const double *latitudes,
+			const double *longitudes) throw (ColumnarFileException);
+
+	/**
+	 * Append coordinates to a Coordinates file.
+	 *
+	 * @see writeCoordinates()
+	 */
+	void writeCoordinates(std::size_t count, const LatLon *coordinates)
+			throw (ColumnarFileException);
+
+	/**
+	 * Append one row to a Coordinates file.
+	 *
+	 * @see writeCoordinates()
+	 */
+	void write(const GlobalCoordinates &coordinates)
+			throw (ColumnarFileException);
+
+	/**
+	 * Append curves to a Curves file, in the layout of the batch
+	 * GeodeticCalculator::calculateGeodeticCurves().
+	 *
+	 * @param count number of rows
+	 * @param ellipsoidalDistances ellipsoidal distances (meters)
+	 * @param azimuths azimuths (degrees)
+	 * @param reverseAzimuths reverse azimuths (degrees)
+	 * @throws ColumnarFileException if the file isn't a Curves file, a value
+	 *           doesn't fit the encoding or the file can't be written
+	 */
+	void writeCurves(std::size_t count, const double *ellipsoidalDistances,
+			const double *azimuths, const double *reverseAzimuths)
+					throw (ColumnarFileException);
+
+	/**
+	 * Append one row to a Curves file.
+	 *
+	 * @see writeCurves()
+	 */
+	void write(const GeodeticCurveValue &curve) throw (ColumnarFileException);
+
+	/**
+	 * Append one row to a Curves file.
+	 *
+	 * @see writeCurves()
+	 */
+	void write(const GeodeticCurve &curve) throw (ColumnarFileException);
+
+	/**
+	 * Append measurements to a Measurements file.
+	 *
+	 * @param count number of rows
+	 * @param ellipsoidalDistances ellipsoidal distances (meters)
+	 * @param azimuths azimuths (degrees)
+	 * @param reverseAzimuths reverse azimuths (degrees)
+	 * @param elevationChanges elevation changes (meters)
+	 * @param pointToPointDistances point to point distances (meters)
+	 * @throws ColumnarFileException if the file isn't a Measurements file, a
+	 *           value doesn't fit the encoding or the file can't be written
+	 */
+	void writeMeasurements(std::size_t count,
+			const double *ellipsoidalDistances, const double *azimuths,
+			const double *reverseAzimuths, const double *elevationChanges,
+			const double *pointToPointDistances) throw (ColumnarFileException);
+
+	/**
+	 * Append one row to a Measurements file.
+	 *
+	 * @see writeMeasurements()
+	 */
+	void write(const GeodeticMeasurementValue &measurement)
+			throw (ColumnarFileException);
+
+	/**
+	 * Append one row to a Measurements file.
+	 *
+	 * @see writeMeasurements()
+	 */
+	void write(const GeodeticMeasurement &measurement)
+			throw (ColumnarFileException);
+
+	/**
+	 * Write the last block and the header, and move the file into place.
+	 * The file is on disk when close() returns. Nothing can be written
+	 * afterwards.
+	 *
+	 * @throws ColumnarFileException if the file can't be written
+	 */
+	void close() throw (ColumnarFileException);
+
+	/**
+	 * Get the number of rows written so far.
+	 * @return
+	 */
+	std::size_t getRowCount() const;
+
+private:
+	std::string mPath;
+	std::string mTemporaryPath;
+	FILE *mFile;
+	ColumnarFile::Content mContent;
+	std::vector<ColumnarFile::Encoding> mEncodings;
+	std::vector<double> mOffsets;
+	std::size_t mBlockSize;
+	std::size_t mRowCount;
+	std::size_t mBlockCount;
+
+	/** The rows of the current block, one array per column. */
+	std::vector<std::vector<double> > mColumns;
+
+	void append(ColumnarFile::Content content, std::size_t count,
+			const double * const *columns) throw (ColumnarFileException);
+
+	void writeBlock() throw (ColumnarFileException);
+
+	void writeBytes(const void *data, std::size_t size)
+			throw (ColumnarFileException);
+
+	// no copies
+	ColumnarWriter(const ColumnarWriter &);
+	ColumnarWriter &operator=(const ColumnarWriter &);
+};
+
+/**
+ * <p>
+ * Reads a ColumnarFile. The file is mapped read-only: opening it reads only
+ * the header and the block headers, and the blocks and columns that are
+ * never read are never loaded from disk.
+ * </p>
+ * <p>
+ * Readers don't change and may be used from several threads.
+ * </p>
+ */
+class ColumnarReader {
+public:
+	typedef std::tr1::shared_ptr<ColumnarReader> Ptr;
+	typedef std::tr1::shared_ptr<ColumnarReader const> ConstPtr;
+
+	virtual ~ColumnarReader();
+
+	/**
+	 * Map a file written by ColumnarWriter.
+	 *
+	 * @param path the file
+	 * @return the reader
+	 * @throws ColumnarFileException if the file can't be mapped, isn't a
+	 *           columnar file of a supported version written on a machine
+	 *           with the same byte order, or is truncated
+	 */
+	static ColumnarReader::Ptr open(const std::string &path)
+			throw (ColumnarFileException);
+
+	/**
+	 * Get what the rows are.
+	 * @return
+	 */
+	ColumnarFile::Content getContent() const;
+
+	/**
+	 * Get the number of columns.
+	 * @return
+	 */
+	std::size_t getColumnCount() const;
+
+	/**
+	 * Get how a column is stored.
+	 *
+	 * @param column the column
+	 * @return
+	 */
+	ColumnarFile::Encoding getEncoding(std::size_t column) const;
+
+	/**
+	 * Get the number of rows.
+	 * @return
+	 */
+	std::size_t getRowCount() const;
+
+	/**
+	 * Get the number of blocks.
+	 * @return
+	 */
+	std::size_t getBlockCount() const;
+
+	/**
+	 * Get the number of the first row of a block.
+	 *
+	 * @param block the block
+	 * @return
+	 */
+	std::size_t getBlockStart(std::size_t block) const;
+
+	/**
+	 * Get the number of rows of a block.
+	 *
+	 * @param block the block
+	 * @return
+	 */
+	std::size_t getBlockRowCount(std::size_t block) const;
+
+	/**
+	 * Get the smallest value of a column in a block, NaN values aside.
+	 *
+	 * @param block the block
+	 * @param column the column
+	 * @return the smallest value as it is read back, NaN if all are NaN
+	 */
+	double getBlockMinimum(std::size_t block, std::size_t column) const;
+
+	/**
+	 * Get the largest value of a column in a block, NaN values aside.
+	 *
+	 * @param block the block
+	 * @param column the column
+	 * @return the largest value as it is read back, NaN if all are NaN
+	 */
+	double getBlockMaximum(std::size_t block, std::size_t column) const;
+
+	/**
+	 * Read the values of a column in a block.
+	 *
+	 * @param block the block
+	 * @param column the column
+	 * @param values getBlockRowCount(block) values (output value)
+	 */
+	void readBlock(std::size_t block, std::size_t column, double *values) const;
+
+	/**
+	 * Read all the values of a column.
+	 *
+	 * @param column the column
+	 * @param values getRowCount() values (output value)
+	 */
+	void readColumn(std::size_t column, double *values) const;
+
+private:
+	void *mMapping;
+	std::size_t mMappingSize;
+	ColumnarFile::Content mContent;
+	std::vector<ColumnarFile::Encoding> mEncodings;
+	std::vector<double> mOffsets;
+	std::size_t mRowCount;
+
+	/** Offset in the mapping of each block. */
+	std::vector<std::size_t> mBlockPositions;
+
+	/** First row of each block, and the row count at the end. */
+	std::vector<std::size_t> mBlockStarts;
+
+	ColumnarReader();
+
+	std::string attach();
+
+	// no copies
+	ColumnarReader(const ColumnarReader &);
+	ColumnarReader &operator=(const ColumnarReader &);
+};
+
+}
+
+#endif /* COLUMNARFILE_HPP_ */
@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#include "CurveCache.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <list>
+#include <pthread.h>
+#include <tr1/unordered_map>
+#include <utility>
+
+namespace geodesy {
+
+using namespace std;
+
+const std::size_t CurveCache::DefaultCapacity;
+const unsigned CurveCache::DefaultShardCount;
+const double CurveCache::DefaultResolution = 1E-7;
+
+namespace {
+
+unsigned long long bitsOf(double value) {
+	unsigned long long bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+/** Fold a value into a hash, with the finalizer of splitmix64. */
+unsigned long long mix(unsigned long long hash, unsigned long long value) {
+	hash ^= value + 0x9E3779B97F4A7C15ULL;
+	hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBULL;
+	return hash ^ (hash >> 31);
+}
+
+}
+
+struct CurveCache::Key {
+	/** The coordinates in units of the resolution, or their bits. */
+	long long startLatitude;
+	long long startLongitude;
+	long long endLatitude;
+	long long endLongitude;
+	double semiMajorAxis;
+	double flattening;
+	int method;
+
+	bool operator==(const Key &other) const {
+		return startLatitude == other.startLatitude
+				&& startLongitude == other.startLongitude
+				&& endLatitude == other.endLatitude
+				&& endLongitude == other.endLongitude
+				&& semiMajorAxis == other.semiMajorAxis
+				&& flattening == other.flattening && method == other.method;
+	}
+};
+
+struct CurveCache::KeyHash {
+	std::size_t operator()(const Key &key) const {
+		unsigned long long hash = mix(0, key.startLatitude);
+		hash = mix(hash, key.startLongitude);
+		hash = mix(hash, key.endLatitude);
+		hash = mix(hash, key.endLongitude);
+		hash = mix(hash, bitsOf(key.semiMajorAxis));
+		hash = mix(hash, bitsOf(key.flattening));
+		return mix(hash, key.method);
+	}
+};
+
+/**
+ * A part of the cache with its own lock. The entries are kept most recently
+ * used first and indexed by key.
+ */
+struct CurveCache::Shard {
+	typedef list<pair<Key, GeodeticCurveValue> > Entries;
+	typedef tr1::unordered_map<Key, Entries::iterator, KeyHash> Index;
+
+	pthread_mutex_t mutex;
+	Entries entries;
+	Index index;
+	std::size_t capacity;
+	unsigned long long hits;
+	unsigned long long misses;
+	unsigned long long evictions;
+};
+
+CurveCache::CurveCache(std::size_t capacity, unsigned shardCount,
+		double resolution) :
+		mCapacity(capacity), mResolution(resolution) {
+	// no shard without room, and the shares add up to the capacity
+	if (shardCount > capacity) {
+		shardCount = capacity;
+	}
+	shardCount = max(shardCount, 1U);
+	for (unsigned i = 0; i < shardCount; ++i) {
+		Shard *shard = new Shard();
+		pthread_mutex_init(&shard->mutex, 0);
+		shard->capacity = capacity / shardCount
+				+ (i < capacity % shardCount ? 1 : 0);
+		shard->index.rehash(shard->capacity);
+		shard->hits = 0;
+		shard->misses = 0;
+		shard->evictions = 0;
+		mShards.push_back(shard);
+	}
+}
+
+CurveCache::~CurveCache() {
+	for (std::size_t i = 0; i < mShards.size(); ++i) {
+		pthread_mutex_destroy(&mShards[i]->mutex);
+		delete mShards[i];
+	}
+}
+
+double CurveCache::quantize(double angle, long long &key) const {
+	if (mResolution > 0) {
+		double units = floor(angle / mResolution + 0.5);
+		// 2^52 units or more, NaN and the infinities included, may not fit the
+		// integer; the bits of such angles, one NaN standing for all, lie
+		// outside that range
+		if (fabs(units) < 4503599627370496.0) {
+			key = static_cast<long long>(units);
+			return units * mResolution;
+		}
+	}
+	key = bitsOf(isnan(angle) ? numeric_limits<double>::quiet_NaN() : angle);
+	return angle;
+}
+
+GeodeticCurveValue CurveCache::calculateGeodeticCurve(
+		const Ellipsoid &ellipsoid, const GlobalCoordinates &start,
+		const GlobalCoordinates &end,
+		GeodeticCalculator::InverseMethod method) {
+	Key key;
+	double startLatitude = quantize(start.getLatitude(), key.startLatitude);
+	double startLongitude = quantize(start.getLongitude(),
+			key.startLongitude);
+	double endLatitude = quantize(end.getLatitude(), key.endLatitude);
+	double endLongitude = quantize(end.getLongitude(), key.endLongitude);
+	key.semiMajorAxis = ellipsoid.getSemiMajorAxis();
+	key.flattening = ellipsoid.getFlattening();
+	key.method = method;
+
+	// the high bits pick the shard, the low ones the bucket within it
+	std::size_t hash = KeyHash()(key);
+	Shard &shard = *mShards[(hash >> 16) % mShards.size()];
+
+	pthread_mutex_lock(&shard.mutex);
+	Shard::Index::iterator found = shard.index.find(key);
+	if (found != shard.index.end()) {
+		shard.entries.splice(shard.entries.begin(), shard.entries,
+				found->second);
+		++shard.hits;
+		GeodeticCurveValue curve = found->second->second;
+		pthread_mutex_unlock(&shard.mutex);
+		return curve;
+	}
+	++shard.misses;
+	pthread_mutex_unlock(&shard.mutex);
+
+	GeodeticCurveValue curve = GeodeticCalculator::calculateGeodeticCurve(
+			ellipsoid, GlobalCoordinates(startLatitude, startLongitude),
+			GlobalCoordinates(endLatitude, endLongitude), method);
+
+	// another thread may have added the same key meanwhile
+	pthread_mutex_lock(&shard.mutex);
+	if (shard.index.find(key) == shard.index.end()) {
+		shard.entries.push_front(make_pair(key, curve));
+		shard.index[key] = shard.entries.begin();
+		if (shard.index.size() > shard.capacity) {
+			shard.index.erase(shard.entries.back().first);
+			shard.entries.pop_back();
+			++shard.evictions;
+		}
+	}
+	pthread_mutex_unlock(&shard.mutex);
+	return curve;
+}
+
+CurveCache::Statistics CurveCache::getStatistics() const {
+	Statistics statistics;
+	statistics.hits = 0;
+	statistics.misses = 0;
+	statistics.evictions = 0;
+	statistics.size = 0;
+	for (std::size_t i = 0; i < mShards.size(); ++i) {
+		Shard &shard = *mShards[i];
+		pthread_mutex_lock(&shard.mutex);
+		statistics.hits += shard.hits;
+		statistics.misses += shard.misses;
+		statistics.evictions += shard.evictions;
+		statistics.size += shard.index.size();
+		pthread_mutex_unlock(&shard.mutex);
+	}
+	return statistics;
+}
+
+void CurveCache::clear() {
+	for (std::size_t i = 0; i < mShards.size(); ++i) {
+		Shard &shard = *mShards[i];
+		pthread_mutex_lock(&shard.mutex);
+		shard.index.clear();
+		shard.entries.clear();
+		shard.hits = 0;
+		shard.misses = 0;
+		shard.evictions = 0;
+		pthread_mutex_unlock(&shard.mutex);
+	}
+}
+
+std::size_t CurveCache::getCapacity() const {
+	return mCapacity;
+}
+
+double CurveCache::getResolution() const {
+	return mResolution;
+}
+
+}
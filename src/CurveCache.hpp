@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#ifndef CURVECACHE_HPP_
+#define CURVECACHE_HPP_
+
+#include <cstddef>
+#include <tr1/memory>
+#include <vector>
+
+#include "Ellipsoid.hpp"
+#include "GeodeticCalculator.hpp"
+#include "GeodeticCurve.hpp"
+#include "GlobalCoordinates.hpp"
+
+namespace geodesy {
+
+/**
+ * <p>
+ * Memoizes GeodeticCalculator::calculateGeodeticCurve() for workloads that
+ * ask for the same pairs of points over and over.
+ * </p>
+ * <p>
+ * Entries are keyed by the start and end coordinates rounded to a grid of
+ * getResolution() degrees, the ellipsoid (by its semi-major axis and
+ * flattening) and the algorithm. The curve is calculated between the rounded
+ * coordinates, so a result only depends on its key: with the default
+ * resolution of 1E-7 degrees the coordinates move by at most about a
+ * centimeter. A resolution of 0 keys on the exact coordinates.
+ * </p>
+ * <p>
+ * The cache holds at most getCapacity() curves, about 150 bytes each, and
+ * drops the least recently used ones first. It is split into shards, each
+ * with its own lock and its own share of the capacity, so that threads
+ * looking up different pairs rarely wait for each other. The curve of a miss
+ * is calculated without holding a lock.
+ * </p>
+ */
+class CurveCache {
+public:
+	typedef std::tr1::shared_ptr<CurveCache> Ptr;
+	typedef std::tr1::shared_ptr<CurveCache const> ConstPtr;
+
+	/** Counters of a cache. */
+	struct Statistics {
+		/** Lookups answered from the cache. */
+		unsigned long long hits;
+		/** Lookups that calculated the curve. */
+		unsigned long long misses;
+		/** Curves dropped to make room. */
+		unsigned long long evictions;
+		/** Curves held. */
+		std::size_t size;
+	};
+
+	/** Default maximum number of curves. */
+	static const std::size_t DefaultCapacity = 65536;
+
+	/** Default number of shards. */
+	static const unsigned DefaultShardCount = 16;
+
+	/** Default grid the coordinates are rounded to (degrees). */
+	static const double DefaultResolution;
+
+	/**
+	 * Create an empty cache.
+	 *
+	 * @param capacity maximum number of curves
+	 * @param shardCount number of independently locked parts
+	 * @param resolution grid the coordinates are rounded to (degrees), 0 to
+	 *          use them as they are
+	 */
+	explicit CurveCache(std::size_t capacity = DefaultCapacity,
+			unsigned shardCount = DefaultShardCount, double resolution =
+					DefaultResolution);
+
+	virtual ~CurveCache();
+
+	/**
+	 * Get the curve between two points, from the cache or calculated with
+	 * GeodeticCalculator::calculateGeodeticCurve() and its default tolerance
+	 * and iterations.
+	 *
+	 * @param ellipsoid reference ellipsoid to use
+	 * @param start starting coordinates
+	 * @param end ending coordinates
+	 * @param method the algorithm
+	 * @return the curve between the rounded coordinates
+	 */
+	GeodeticCurveValue calculateGeodeticCurve(const Ellipsoid &ellipsoid,
+			const GlobalCoordinates &start, const GlobalCoordinates &end,
+			GeodeticCalculator::InverseMethod method =
+					GeodeticCalculator::Vincenty);
+
+	/**
+	 * Get the counters, summed over the shards.
+	 * @return
+	 */
+	Statistics getStatistics() const;
+
+	/**
+	 * Drop all curves and reset the counters.
+	 */
+	void clear();
+
+	/**
+	 * Get the maximum number of curves.
+	 * @return
+	 */
+	std::size_t getCapacity() const;
+
+	/**
+	 * Get the grid the coordinates are rounded to (degrees).
+	 * @return
+	 */
+	double getResolution() const;
+
+private:
+	struct Key;
+	struct KeyHash;
+	struct Shard;
+
+	std::vector<Shard *> mShards;
+	std::size_t mCapacity;
+	double mResolution;
+
+	double quantize(double angle, long long &key) const;
+
+	// no copies
+	CurveCache(const CurveCache &);
+	CurveCache &operator=(const CurveCache &);
+};
+
+}
+
+#endif /* CURVECACHE_HPP_ */
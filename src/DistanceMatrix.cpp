@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#include "DistanceMatrix.hpp"
+#include "GeodeticCalculator.hpp"
+#include "GlobalCoordinates.hpp"
+#include "VincentySimd.hpp"
+
+#include <algorithm>
+
+namespace geodesy {
+
+using namespace std;
+
+/**
+ * Solves tiles into scratch space allocated once per calculation: one slot
+ * per executor thread, so that a tile claims a slot instead of allocating.
+ */
+class DistanceMatrix::SolveTask: public BatchExecutor::Task {
+public:
+	SolveTask(const DistanceMatrix &matrix, TileHandler &handler,
+			size_t slotCount, double errorTolerance, int maxIterations) :
+			mMatrix(matrix), mHandler(handler), mSlotSize(
+					slotSize(matrix.mTileSize)), mScratch(
+					slotCount * mSlotSize), mInUse(slotCount, 0), mErrorTolerance(
+					errorTolerance), mMaxIterations(maxIterations) {
+	}
+
+	virtual void run(size_t begin, size_t end) {
+		size_t tileSize = mMatrix.mTileSize;
+		size_t tileColumns = (mMatrix.mColumns.count + tileSize - 1) / tileSize;
+
+		Slot slot(*this);
+		double *startSinU = slot.getData();
+		double *startCosU = startSinU + tileSize;
+		double *startLambdas = startCosU + tileSize;
+		double *distances = startLambdas + tileSize;
+		double *azimuths = distances + tileSize * tileSize + simd::MaxLanes;
+		double *reverseAzimuths = azimuths + tileSize * tileSize
+				+ simd::MaxLanes;
+
+		for (size_t t = begin; t < end; ++t) {
+			Tile tile;
+			tile.rowBegin = t / tileColumns * tileSize;
+			tile.rowEnd = min(tile.rowBegin + tileSize, mMatrix.mRows.count);
+			tile.columnBegin = t % tileColumns * tileSize;
+			tile.columnEnd = min(tile.columnBegin + tileSize,
+					mMatrix.mColumns.count);
+			tile.ellipsoidalDistances = distances;
+			tile.azimuths = azimuths;
+			tile.reverseAzimuths = reverseAzimuths;
+
+			mMatrix.solveTile(tile.rowBegin, tile.rowEnd, tile.columnBegin,
+					tile.columnEnd, mErrorTolerance, mMaxIterations, startSinU,
+					startCosU, startLambdas, distances, azimuths,
+					reverseAzimuths);
+			mHandler.handleTile(tile);
+		}
+	}
+
+private:
+	/**
+	 * One row broadcast and one tile of results, plus room for the padding
+	 * the kernels write past the last column.
+	 */
+	static size_t slotSize(size_t tileSize) {
+		return 3 * tileSize + 3 * (tileSize * tileSize + simd::MaxLanes);
+	}
+
+	/**
+	 * A scratch slot claimed for the lifetime of the object, released even
+	 * if the handler throws. No more threads run the task than there are
+	 * slots, so a free one is always found.
+	 */
+	class Slot {
+	public:
+		explicit Slot(SolveTask &task) :
+				mTask(task), mIndex(0) {
+			while (!__sync_bool_compare_and_swap(&mTask.mInUse[mIndex], 0, 1)) {
+				mIndex = (mIndex + 1) % mTask.mInUse.size();
+			}
+		}
+		~Slot() {
+			__sync_lock_release(&mTask.mInUse[mIndex]);
+		}
+		double *getData() {
+			return &mTask.mScratch[mIndex * mTask.mSlotSize];
+		}
+	private:
+		SolveTask &mTask;
+		size_t mIndex;
+	};
+
+	const DistanceMatrix &mMatrix;
+	TileHandler &mHandler;
+	size_t mSlotSize;
+	vector<double> mScratch;
+	vector<int> mInUse;
+	double mErrorTolerance;
+	int mMaxIterations;
+};
+
+namespace {
+
+/**
+ * Copies the tiles into row-major arrays of the whole matrix.
+ */
+class DenseHandler: public DistanceMatrix::TileHandler {
+public:
+	DenseHandler(size_t columnCount, double *ellipsoidalDistances,
+			double *azimuths, double *reverseAzimuths) :
+			mColumnCount(columnCount), mEllipsoidalDistances(
+					ellipsoidalDistances), mAzimuths(azimuths), mReverseAzimuths(
+					reverseAzimuths) {
+	}
+
+	virtual void handleTile(const DistanceMatrix::Tile &tile) {
+		size_t width = tile.columnEnd - tile.columnBegin;
+		for (size_t row = tile.rowBegin; row < tile.rowEnd; ++row) {
+			size_t from = (row - tile.rowBegin) * width;
+			size_t to = row * mColumnCount + tile.columnBegin;
+			copy(tile.ellipsoidalDistances + from,
+					tile.ellipsoidalDistances + from + width,
+					mEllipsoidalDistances + to);
+			if (mAzimuths) {
+				copy(tile.azimuths + from, tile.azimuths + from + width,
+						mAzimuths + to);
+			}
+			if (mReverseAzimuths) {
+				copy(tile.reverseAzimuths + from,
+						tile.reverseAzimuths + from + width,
+						mReverseAzimuths + to);
+			}
+		}
+	}
+
+private:
+	size_t mColumnCount;
+	double *mEllipsoidalDistances;
+	double *mAzimuths;
+	double *mReverseAzimuths;
+};
+
+}
+
+const size_t DistanceMatrix::DefaultTileSize;
+
+DistanceMatrix::TileHandler::~TileHandler() {
+}
+
+DistanceMatrix::DistanceMatrix(Ellipsoid::ConstPtr ellipsoid,
+		size_t rowCount, const double *rowLatitudes,
+		const double *rowLongitudes, size_t columnCount,
+		const double *columnLatitudes, const double *columnLongitudes,
+		size_t tileSize) :
+		mSemiMajorAxis(ellipsoid->getSemiMajorAxis()), mSemiMinorAxis(
+				ellipsoid->getSemiMinorAxis()), mFlattening(
+				ellipsoid->getFlattening()), mAxisRatio(
+				ellipsoid->getAxisRatio()), mSecondEccentricitySquared(
+				ellipsoid->getSecondEccentricitySquared()) {
+	tileSize = max(tileSize, static_cast<size_t>(1));
+	mTileSize = (tileSize + simd::MaxLanes - 1) / simd::MaxLanes
+			* simd::MaxLanes;
+
+	prepare(rowCount, rowLatitudes, rowLongitudes, mRows);
+	prepare(columnCount, columnLatitudes, columnLongitudes, mColumns);
+}
+
+DistanceMatrix::~DistanceMatrix() {
+}
+
+size_t DistanceMatrix::getRowCount() const {
+	return mRows.count;
+}
+
+size_t DistanceMatrix::getColumnCount() const {
+	return mColumns.count;
+}
+
+size_t DistanceMatrix::getTileSize() const {
+	return mTileSize;
+}
+
+void DistanceMatrix::calculate(BatchExecutor &executor,
+		double *ellipsoidalDistances, double *azimuths,
+		double *reverseAzimuths, double const errorTolerance,
+		int const maxIterations) const {
+	DenseHandler handler(mColumns.count, ellipsoidalDistances, azimuths,
+			reverseAzimuths);
+	calculate(executor, handler, errorTolerance, maxIterations);
+}
+
+void DistanceMatrix::calculate(BatchExecutor &executor, TileHandler &handler,
+		double const errorTolerance, int const maxIterations) const {
+	size_t tileRows = (mRows.count + mTileSize - 1) / mTileSize;
+	size_t tileColumns = (mColumns.count + mTileSize - 1) / mTileSize;
+
+	SolveTask task(*this, handler, executor.getThreadCount(), errorTolerance,
+			maxIterations);
+	executor.run(task, tileRows * tileColumns, 1);
+}
+
+void DistanceMatrix::prepare(size_t count, const double *latitudes,
+		const double *longitudes, Points &points) const {
+	// padded with copies of the last point so that a whole tile can be
+	// handed to the kernels
+	size_t padded = (count + mTileSize - 1) / mTileSize * mTileSize;
+	points.count = count;
+	points.sinU.resize(padded);
+	points.cosU.resize(padded);
+	points.lambda.resize(padded);
+	for (size_t i = 0; i < padded; ++i) {
+		double latitude = latitudes[min(i, count - 1)];
+		double longitude = longitudes[min(i, count - 1)];
+		GlobalCoordinates::canonicalize(latitude, longitude);
+		GeodeticCalculator::reducePoint(mAxisRatio, latitude, longitude,
+				points.sinU[i], points.cosU[i], points.lambda[i]);
+	}
+}
+
+void DistanceMatrix::solveTile(size_t rowBegin, size_t rowEnd,
+		size_t columnBegin, size_t columnEnd, double errorTolerance,
+		int maxIterations, double *startSinU, double *startCosU,
+		double *startLambdas, double *distances, double *azimuths,
+		double *reverseAzimuths) const {
+	size_t width = columnEnd - columnBegin;
+
+	const simd::Kernels *kernels = simd::bestKernels();
+	if (kernels) {
+		size_t padded = (width + kernels->lanes - 1) / kernels->lanes
+				* kernels->lanes;
+		for (size_t row = rowBegin; row < rowEnd; ++row) {
+			fill(startSinU, startSinU + padded, mRows.sinU[row]);
+			fill(startCosU, startCosU + padded, mRows.cosU[row]);
+			fill(startLambdas, startLambdas + padded, mRows.lambda[row]);
+
+			// the padding spills into the next row, which is written after
+			size_t offset = (row - rowBegin) * width;
+			kernels->preparedInverse(mSemiMajorAxis, mSemiMinorAxis,
+					mFlattening, errorTolerance, maxIterations, padded,
+					startSinU, startCosU, startLambdas,
+					&mColumns.sinU[columnBegin], &mColumns.cosU[columnBegin],
+					&mColumns.lambda[columnBegin], distances + offset,
+					azimuths + offset, reverseAzimuths + offset);
+		}
+	} else {
+		for (size_t row = rowBegin; row < rowEnd; ++row) {
+			size_t offset = (row - rowBegin) * width;
+			for (size_t column = columnBegin; column < columnEnd; ++column) {
+				size_t i = offset + column - columnBegin;
+				GeodeticCalculator::solveReducedInverse(mSemiMinorAxis,
+						mFlattening, mSecondEccentricitySquared,
+						mRows.sinU[row], mRows.cosU[row], mRows.lambda[row],
+						mColumns.sinU[column], mColumns.cosU[column],
+						mColumns.lambda[column], errorTolerance,
+						maxIterations, distances[i], azimuths[i],
+						reverseAzimuths[i]);
+			}
+		}
+	}
+}
+
+}
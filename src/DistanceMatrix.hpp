@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#ifndef DISTANCEMATRIX_HPP_
+#define DISTANCEMATRIX_HPP_
+
+#include <cstddef>
+#include <tr1/memory>
+#include <vector>
+
+#include "BatchExecutor.hpp"
+#include "Ellipsoid.hpp"
+
+namespace geodesy {
+
+/**
+ * <p>
+ * The geodetic curves between every point of one set (the rows) and every
+ * point of another (the columns), as given by
+ * GeodeticCalculator::calculateGeodeticCurve().
+ * </p>
+ * <p>
+ * The reduced latitude and the longitude in radians of every point are
+ * computed once, when the matrix is built. The matrix is then solved in
+ * square tiles, each on one worker of a BatchExecutor, so that the prepared
+ * terms of the rows and columns of a tile stay in cache while the tile is
+ * solved. Tiles are solved with the SIMD kernels when the processor has them,
+ * in which case the results match GeodeticCalculator::calculateGeodeticCurves()
+ * closely but not bit for bit.
+ * </p>
+ */
+class DistanceMatrix {
+public:
+	typedef std::tr1::shared_ptr<DistanceMatrix> Ptr;
+	typedef std::tr1::shared_ptr<DistanceMatrix const> ConstPtr;
+
+	/**
+	 * The results for one tile, row-major with a stride of the number of
+	 * columns in the tile.
+	 */
+	struct Tile {
+		/** First row of the tile. */
+		std::size_t rowBegin;
+		/** One past the last row of the tile. */
+		std::size_t rowEnd;
+		/** First column of the tile. */
+		std::size_t columnBegin;
+		/** One past the last column of the tile. */
+		std::size_t columnEnd;
+		/** Ellipsoidal distances (meters). */
+		const double *ellipsoidalDistances;
+		/** Azimuths (degrees). */
+		const double *azimuths;
+		/** Reverse azimuths (degrees). */
+		const double *reverseAzimuths;
+	};
+
+	/**
+	 * Receives the tiles as they are solved. handleTile() is called from the
+	 * worker threads, concurrently for different tiles, and must not throw.
+	 * The tile is only valid for the duration of the call.
+	 */
+	class TileHandler {
+	public:
+		virtual ~TileHandler();
+
+		virtual void handleTile(const Tile &tile) = 0;
+	};
+
+	/** Default number of rows and columns per tile. */
+	static const std::size_t DefaultTileSize = 64;
+
+	/**
+	 * Prepare the points. The coordinates are copied.
+	 *
+	 * @param ellipsoid reference ellipsoid to use
+	 * @param rowCount number of row points
+	 * @param rowLatitudes latitudes of the row points (degrees)
+	 * @param rowLongitudes longitudes of the row points (degrees)
+	 * @param columnCount number of column points
+	 * @param columnLatitudes latitudes of the column points (degrees)
+	 * @param columnLongitudes longitudes of the column points (degrees)
+	 * @param tileSize number of rows and columns per tile, rounded up to a
+	 *          multiple of simd::MaxLanes
+	 */
+	DistanceMatrix(Ellipsoid::ConstPtr ellipsoid, std::size_t rowCount,
+			const double *rowLatitudes, const double *rowLongitudes,
+			std::size_t columnCount, const double *columnLatitudes,
+			const double *columnLongitudes, std::size_t tileSize =
+					DefaultTileSize);
+
+	virtual ~DistanceMatrix();
+
+	std::size_t getRowCount() const;
+
+	std::size_t getColumnCount() const;
+
+	std::size_t getTileSize() const;
+
+	/**
+	 * Solve the whole matrix into row-major arrays of getRowCount() times
+	 * getColumnCount() elements.
+	 *
+	 * @param executor the threads to solve the tiles on
+	 * @param ellipsoidalDistances distances in meters (output array)
+	 * @param azimuths azimuths in degrees (output array, may be NULL)
+	 * @param reverseAzimuths reverse azimuths in degrees (output array, may
+	 *          be NULL)
+	 * @param errorTolerance once the change in lambda reaches this value, stop iterating
+	 * @param maxIterations maximum number of iterations, even if the error tolerance is not met
+	 */
+	void calculate(BatchExecutor &executor, double *ellipsoidalDistances,
+			double *azimuths, double *reverseAzimuths,
+			double const errorTolerance = 1E-13,
+			int const maxIterations = 20) const;
+
+	/**
+	 * Solve the whole matrix, handing each tile to handler as soon as it is
+	 * done. Nothing of size rows times columns is ever allocated.
+	 *
+	 * @param executor the threads to solve the tiles on
+	 * @param handler receives the tiles
+	 * @param errorTolerance once the change in lambda reaches this value, stop iterating
+	 * @param maxIterations maximum number of iterations, even if the error tolerance is not met
+	 * @throws BatchTaskException if the handler threw
+	 */
+	void calculate(BatchExecutor &executor, TileHandler &handler,
+			double const errorTolerance = 1E-13,
+			int const maxIterations = 20) const;
+
+private:
+	/** The prepared terms of a set of points, padded to whole tiles. */
+	struct Points {
+		std::size_t count;
+		std::vector<double> sinU;
+		std::vector<double> cosU;
+		std::vector<double> lambda;
+	};
+
+	/** Solves a range of tiles on the executor. */
+	class SolveTask;
+
+	void prepare(std::size_t count, const double *latitudes,
+			const double *longitudes, Points &points) const;
+
+	/**
+	 * Solve one tile into buffers of getTileSize() squared elements.
+	 */
+	void solveTile(std::size_t rowBegin, std::size_t rowEnd,
+			std::size_t columnBegin, std::size_t columnEnd,
+			double errorTolerance, int maxIterations, double *startSinU,
+			double *startCosU, double *startLambdas, double *distances,
+			double *azimuths, double *reverseAzimuths) const;
+
+	/** Semi major axis (meters). */
+	double mSemiMajorAxis;
+
+	/** Semi minor axis (meters). */
+	double mSemiMinorAxis;
+
+	/** Flattening. */
+	double mFlattening;
+
+	/** 1 - f */
+	double mAxisRatio;
+
+	/** Square of the second eccentricity. */
+	double mSecondEccentricitySquared;
+
+	std::size_t mTileSize;
+
+	Points mRows;
+
+	Points mColumns;
+
+};
+
+}
+
+#endif /* DISTANCEMATRIX_HPP_ */
@@ -28,57 +28,136 @@
 
 #include "Ellipsoid.hpp"
 
+#include <cmath>
+#include <map>
+#include <pthread.h>
+#include <utility>
+
 namespace geodesy {
 
+using namespace std;
+
+namespace {
+
+/**
+ * The shared ellipsoids by semi major axis and flattening. An entry doesn't
+ * keep its ellipsoid alive, entries whose ellipsoid is gone are dropped as
+ * new ones are added.
+ */
+typedef map<pair<double, double>, tr1::weak_ptr<const Ellipsoid> > Registry;
+
+pthread_mutex_t registryMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Get the registry, with the common reference ellipsoids in it. The caller
+ * holds registryMutex.
+ */
+Registry &registry() {
+	static Registry ellipsoids;
+	static bool seeded = false;
+	if (!seeded) {
+		seeded = true;
+		Ellipsoid::ConstPtr common[] = { Ellipsoid::WGS84(),
+				Ellipsoid::GRS80(), Ellipsoid::GRS67(), Ellipsoid::ANS(),
+				Ellipsoid::WGS72(), Ellipsoid::Clarke1858(),
+				Ellipsoid::Clarke1880(), Ellipsoid::Sphere() };
+		for (size_t i = 0; i < sizeof(common) / sizeof(common[0]); ++i) {
+			ellipsoids.insert(
+					make_pair(
+							make_pair(common[i]->getSemiMajorAxis(),
+									common[i]->getFlattening()),
+							tr1::weak_ptr<const Ellipsoid>(common[i])));
+		}
+	}
+	return ellipsoids;
+}
+
+/**
+ * Find the shared ellipsoid for a key, or make candidate the shared one if
+ * it isn't NULL.
+ */
+Ellipsoid::ConstPtr share(const pair<double, double> &key,
+		Ellipsoid::ConstPtr candidate) {
+	pthread_mutex_lock(&registryMutex);
+	Registry &ellipsoids = registry();
+	Registry::iterator found = ellipsoids.find(key);
+	Ellipsoid::ConstPtr shared;
+	if (found != ellipsoids.end()) {
+		shared = found->second.lock();
+	}
+	if (!shared && candidate) {
+		for (Registry::iterator i = ellipsoids.begin(); i != ellipsoids.end();) {
+			if (i->second.expired()) {
+				ellipsoids.erase(i++);
+			} else {
+				++i;
+			}
+		}
+		ellipsoids[key] = candidate;
+		shared = candidate;
+	}
+	pthread_mutex_unlock(&registryMutex);
+	return shared;
+}
+
+}
+
 Ellipsoid::~Ellipsoid() {
 }
 
 Ellipsoid::Ellipsoid(double semiMajor, double semiMinor, double flattening,
 		double inverseFlattening) :
 		mSemiMajorAxis(semiMajor), mSemiMinorAxis(semiMinor), mFlattening(
-				flattening), mInverseFlattening(inverseFlattening) {
+				flattening), mInverseFlattening(inverseFlattening), mSemiMajorAxisSquared(
+				semiMajor * semiMajor), mSemiMinorAxisSquared(
+				semiMinor * semiMinor), mAxisRatio(1.0 - flattening), mThirdFlattening(
+				flattening / (2.0 - flattening)), mEccentricitySquared(
+				flattening * (2.0 - flattening)), mEccentricity(
+				sqrt(mEccentricitySquared)), mSecondEccentricitySquared(
+				(mSemiMajorAxisSquared - mSemiMinorAxisSquared)
+						/ mSemiMinorAxisSquared) {
 }
 
-Ellipsoid::ConstPtr Ellipsoid::WGS84() {
+const Ellipsoid::ConstPtr &Ellipsoid::WGS84() {
 	static Ellipsoid::ConstPtr singleton = fromAAndInverseF(6378137.0,
 			298.257223563);
 	return singleton;
 }
 
-Ellipsoid::ConstPtr Ellipsoid::GRS80() {
+const Ellipsoid::ConstPtr &Ellipsoid::GRS80() {
 	static Ellipsoid::ConstPtr singleton = fromAAndInverseF(6378137.0,
 			298.257222101);
 	return singleton;
 }
 
-Ellipsoid::ConstPtr Ellipsoid::GRS67() {
+const Ellipsoid::ConstPtr &Ellipsoid::GRS67() {
 	static Ellipsoid::ConstPtr singleton = fromAAndInverseF(6378160.0, 298.25);
 	return singleton;
 }
 
-Ellipsoid::ConstPtr Ellipsoid::ANS() {
+const Ellipsoid::ConstPtr &Ellipsoid::ANS() {
 	static Ellipsoid::ConstPtr singleton = fromAAndInverseF(6378160.0, 298.25);
 	return singleton;
 }
 
-Ellipsoid::ConstPtr Ellipsoid::WGS72() {
+const Ellipsoid::ConstPtr &Ellipsoid::WGS72() {
 	static Ellipsoid::ConstPtr singleton = fromAAndInverseF(6378135.0, 298.26);
 	return singleton;
 }
 
-Ellipsoid::ConstPtr Ellipsoid::Clarke1858() {
+const Ellipsoid::ConstPtr &Ellipsoid::Clarke1858() {
 	static Ellipsoid::ConstPtr singleton = fromAAndInverseF(6378293.645,
 			294.26);
 	return singleton;
 }
 
-Ellipsoid::ConstPtr Ellipsoid::Clarke1880() {
+const Ellipsoid::ConstPtr &Ellipsoid::Clarke1880() {
 	static Ellipsoid::ConstPtr singleton = fromAAndInverseF(6378249.145,
 			293.465);
 	return singleton;
 }
 
-Ellipsoid::ConstPtr Ellipsoid::Sphere() {
+const Ellipsoid::ConstPtr &Ellipsoid::Sphere() {
 	static Ellipsoid::ConstPtr singleton = fromAAndF(6371000, 0.0);
 	return singleton;
 }
@@ -100,6 +179,27 @@ Ellipsoid::ConstPtr Ellipsoid::fromAAndF(double semiMajor, double flattening) {
 			new Ellipsoid(semiMajor, b, flattening, inverseF));
 }
 
+Ellipsoid::ConstPtr Ellipsoid::intern(double semiMajor, double flattening) {
+	pair<double, double> key(semiMajor, flattening);
+	if (isnan(semiMajor) || isnan(flattening)) {
+		// can't be ordered in the registry
+		return fromAAndF(semiMajor, flattening);
+	}
+	Ellipsoid::ConstPtr shared = share(key, Ellipsoid::ConstPtr());
+	if (!shared) {
+		shared = share(key, fromAAndF(semiMajor, flattening));
+	}
+	return shared;
+}
+
+Ellipsoid::ConstPtr Ellipsoid::intern(Ellipsoid::ConstPtr ellipsoid) {
+	if (isnan(ellipsoid->mSemiMajorAxis) || isnan(ellipsoid->mFlattening)) {
+		return ellipsoid;
+	}
+	return share(make_pair(ellipsoid->mSemiMajorAxis, ellipsoid->mFlattening),
+			ellipsoid);
+}
+
 double Ellipsoid::getSemiMajorAxis() const {
 	return mSemiMajorAxis;
 }
@@ -116,4 +216,32 @@ double Ellipsoid::getInverseFlattening() const {
 	return mInverseFlattening;
 }
 
+double Ellipsoid::getSemiMajorAxisSquared() const {
+	return mSemiMajorAxisSquared;
+}
+
+double Ellipsoid::getSemiMinorAxisSquared() const {
+	return mSemiMinorAxisSquared;
+}
+
+double Ellipsoid::getAxisRatio() const {
+	return mAxisRatio;
+}
+
+double Ellipsoid::getThirdFlattening() const {
+	return mThirdFlattening;
+}
+
+double Ellipsoid::getEccentricity() const {
+	return mEccentricity;
+}
+
+double Ellipsoid::getEccentricitySquared() const {
+	return mEccentricitySquared;
+}
+
+double Ellipsoid::getSecondEccentricitySquared() const {
+	return mSecondEccentricitySquared;
+}
+
 } // geodesy
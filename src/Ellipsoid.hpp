@@ -34,7 +34,20 @@
 namespace geodesy {
 
 /**
+ * <p>
  * Encapsulation of an ellipsoid, and declaration of common reference ellipsoids.
+ * </p>
+ * <p>
+ * The constants the solvers derive from the axes and the flattening are
+ * computed once, when the ellipsoid is built, and the solvers read them from
+ * here rather than derive them again on every call.
+ * </p>
+ * <p>
+ * The common reference ellipsoids are returned by reference to pointers that
+ * live as long as the program, so *Ellipsoid::WGS84() or passing
+ * Ellipsoid::WGS84() on to GeodeticCalculator doesn't touch the reference
+ * count, which threads would otherwise all write to.
+ * </p>
  */
 class Ellipsoid {
 public:
@@ -45,28 +58,28 @@ public:
 
 public:
 	/** The WGS84 ellipsoid. */
-	static Ellipsoid::ConstPtr WGS84();
+	static const Ellipsoid::ConstPtr &WGS84();
 
 	/** The GRS80 ellipsoid. */
-	static Ellipsoid::ConstPtr GRS80();
+	static const Ellipsoid::ConstPtr &GRS80();
 
 	/** The GRS67 ellipsoid. */
-	static Ellipsoid::ConstPtr GRS67();
+	static const Ellipsoid::ConstPtr &GRS67();
 
 	/** The ANS ellipsoid. */
-	static Ellipsoid::ConstPtr ANS();
+	static const Ellipsoid::ConstPtr &ANS();
 
 	/** The WGS72 ellipsoid. */
-	static Ellipsoid::ConstPtr WGS72();
+	static const Ellipsoid::ConstPtr &WGS72();
 
 	/** The Clarke1858 ellipsoid. */
-	static Ellipsoid::ConstPtr Clarke1858();
+	static const Ellipsoid::ConstPtr &Clarke1858();
 
 	/** The Clarke1880 ellipsoid. */
-	static Ellipsoid::ConstPtr Clarke1880();
+	static const Ellipsoid::ConstPtr &Clarke1880();
 
 	/** A spherical "ellipsoid". */
-	static Ellipsoid::ConstPtr Sphere();
+	static const Ellipsoid::ConstPtr &Sphere();
 
 	/**
 	 * Build an Ellipsoid from the semi major axis measurement and the inverse flattening.
@@ -85,6 +98,28 @@ public:
 	 */
 	static Ellipsoid::ConstPtr fromAAndF(double semiMajor, double flattening);
 
+	/**
+	 * Get the shared Ellipsoid with a semi major axis and flattening. Every
+	 * call with the same values, bit for bit, gets the same instance for as
+	 * long as some reference to it is held. The common reference ellipsoids
+	 * above are shared this way too.
+	 *
+	 * @param semiMajor semi major axis (meters)
+	 * @param flattening
+	 * @return
+	 */
+	static Ellipsoid::ConstPtr intern(double semiMajor, double flattening);
+
+	/**
+	 * Get the shared Ellipsoid with the same semi major axis and flattening as
+	 * ellipsoid, see intern() above. If there is none yet, ellipsoid becomes
+	 * the shared instance.
+	 *
+	 * @param ellipsoid the ellipsoid
+	 * @return
+	 */
+	static Ellipsoid::ConstPtr intern(Ellipsoid::ConstPtr ellipsoid);
+
 	/**
 	 * Get semi-major axis.
 	 * @return semi-major axis (in meters).
@@ -109,6 +144,48 @@ public:
 	 */
 	double getInverseFlattening() const;
 
+	/**
+	 * Get the square of the semi-major axis.
+	 * @return a^2 (in square meters).
+	 */
+	double getSemiMajorAxisSquared() const;
+
+	/**
+	 * Get the square of the semi-minor axis.
+	 * @return b^2 (in square meters).
+	 */
+	double getSemiMinorAxisSquared() const;
+
+	/**
+	 * Get the ratio of the axes.
+	 * @return b / a = 1 - f
+	 */
+	double getAxisRatio() const;
+
+	/**
+	 * Get the third flattening.
+	 * @return n = (a - b) / (a + b) = f / (2 - f)
+	 */
+	double getThirdFlattening() const;
+
+	/**
+	 * Get the eccentricity.
+	 * @return e
+	 */
+	double getEccentricity() const;
+
+	/**
+	 * Get the square of the eccentricity.
+	 * @return e^2 = (a^2 - b^2) / a^2 = f (2 - f)
+	 */
+	double getEccentricitySquared() const;
+
+	/**
+	 * Get the square of the second eccentricity.
+	 * @return e'^2 = (a^2 - b^2) / b^2
+	 */
+	double getSecondEccentricitySquared() const;
+
 private:
 	/** Semi major axis (meters). */
 	const double mSemiMajorAxis;
@@ -122,6 +199,27 @@ private:
 	/** Inverse flattening. */
 	const double mInverseFlattening;
 
+	/** a^2 */
+	const double mSemiMajorAxisSquared;
+
+	/** b^2 */
+	const double mSemiMinorAxisSquared;
+
+	/** 1 - f */
+	const double mAxisRatio;
+
+	/** Third flattening. */
+	const double mThirdFlattening;
+
+	/** Square of the eccentricity. */
+	const double mEccentricitySquared;
+
+	/** Eccentricity. */
+	const double mEccentricity;
+
+	/** Square of the second eccentricity. */
+	const double mSecondEccentricitySquared;
+
 	/**
 	 * Construct a new Ellipsoid.  This is private to ensure the values are
 	 * consistent (flattening = 1.0 / inverseFlattening).  Use the methods
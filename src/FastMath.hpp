@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#ifndef FASTMATH_HPP_
+#define FASTMATH_HPP_
+
+#include <cmath>
+#include <cstring>
+
+#include "VectorMath.hpp"
+
+/**
+ * Scalar forms of the branch free elementary functions of VectorMath.hpp, for
+ * the loops of the calculators that solve one problem at a time. They are
+ * inline, evaluate the same polynomials as the SIMD kernels, and replace
+ * pairs of calls to the C library such as sin() and cos() of the same
+ * argument by one fused sincos().
+ *
+ * Each function comes in a full accuracy variant, within about one ulp of the
+ * C library, and a Reduced variant with shorter polynomials, see
+ * VectorMath.hpp for its accuracy. The square root is the processor's
+ * instruction, already correctly rounded, in both.
+ */
+namespace geodesy {
+
+namespace fastmath {
+
+/**
+ * One double as a lane type for the templates of VectorMath.hpp.
+ */
+class Lane {
+public:
+	class Mask {
+	public:
+		explicit Mask(bool m) :
+				m(m) {
+		}
+		bool m;
+	};
+
+	Lane(double x) :
+			v(x) {
+	}
+
+	double v;
+};
+
+inline Lane operator+(const Lane &a, const Lane &b) {
+	return Lane(a.v + b.v);
+}
+inline Lane operator-(const Lane &a, const Lane &b) {
+	return Lane(a.v - b.v);
+}
+inline Lane operator*(const Lane &a, const Lane &b) {
+	return Lane(a.v * b.v);
+}
+inline Lane operator/(const Lane &a, const Lane &b) {
+	return Lane(a.v / b.v);
+}
+inline Lane operator-(const Lane &a) {
+	return Lane(-a.v);
+}
+
+inline Lane::Mask operator<(const Lane &a, const Lane &b) {
+	return Lane::Mask(a.v < b.v);
+}
+inline Lane::Mask operator>(const Lane &a, const Lane &b) {
+	return Lane::Mask(a.v > b.v);
+}
+inline Lane::Mask operator>=(const Lane &a, const Lane &b) {
+	return Lane::Mask(a.v >= b.v);
+}
+inline Lane::Mask operator==(const Lane &a, const Lane &b) {
+	return Lane::Mask(a.v == b.v);
+}
+
+inline Lane::Mask operator&(const Lane::Mask &a, const Lane::Mask &b) {
+	return Lane::Mask(a.m & b.m);
+}
+inline Lane::Mask operator|(const Lane::Mask &a, const Lane::Mask &b) {
+	return Lane::Mask(a.m | b.m);
+}
+inline Lane::Mask operator~(const Lane::Mask &a) {
+	return Lane::Mask(!a.m);
+}
+inline bool any(const Lane::Mask &a) {
+	return a.m;
+}
+
+inline Lane select(const Lane::Mask &m, const Lane &a, const Lane &b) {
+	return m.m ? a : b;
+}
+inline Lane abs(const Lane &a) {
+	return Lane(std::fabs(a.v));
+}
+inline Lane sqrt(const Lane &a) {
+	return Lane(std::sqrt(a.v));
+}
+/**
+ * Round to nearest even by adding and subtracting 1.5 * 2^52, which leaves
+ * no fractional bits. Only valid below 2^51, which covers every argument the
+ * reductions of VectorMath.hpp see, and cheaper than rint() without SSE4.1.
+ * Relies on strict IEEE arithmetic, don't build with -ffast-math.
+ */
+inline Lane round(const Lane &a) {
+	static const double Shifter = 6755399441055744.0;
+	return Lane((a.v + Shifter) - Shifter);
+}
+inline Lane floor(const Lane &a) {
+	Lane r = round(a);
+	return Lane(r.v > a.v ? r.v - 1.0 : r.v);
+}
+inline Lane mulAdd(const Lane &a, const Lane &b, const Lane &c) {
+	return Lane(a.v * b.v + c.v);
+}
+inline Lane::Mask signBits(const Lane &a) {
+	return Lane::Mask(__builtin_signbit(a.v) != 0);
+}
+inline Lane xorSign(const Lane &a, const Lane &sign) {
+	unsigned long long bits;
+	unsigned long long signBit;
+	std::memcpy(&bits, &a.v, sizeof(bits));
+	std::memcpy(&signBit, &sign.v, sizeof(signBit));
+	bits ^= signBit & 0x8000000000000000ULL;
+	double result;
+	std::memcpy(&result, &bits, sizeof(result));
+	return Lane(result);
+}
+
+/**
+ * Sine and cosine of the same argument, accurate up to a few thousand
+ * radians.
+ */
+inline void sincos(double x, double &sine, double &cosine) {
+	Lane s(0.0);
+	Lane c(0.0);
+	simd::sincos(Lane(x), s, c);
+	sine = s.v;
+	cosine = c.v;
+}
+
+/**
+ * Same as sincos() with reduced accuracy.
+ */
+inline void sincosReduced(double x, double &sine, double &cosine) {
+	Lane s(0.0);
+	Lane c(0.0);
+	simd::sincosReduced(Lane(x), s, c);
+	sine = s.v;
+	cosine = c.v;
+}
+
+/**
+ * Four quadrant arc tangent, same conventions as the C library.
+ */
+inline double atan2(double y, double x) {
+	return simd::atan2(Lane(y), Lane(x)).v;
+}
+
+/**
+ * Same as atan2() with reduced accuracy.
+ */
+inline double atan2Reduced(double y, double x) {
+	return simd::atan2Reduced(Lane(y), Lane(x)).v;
+}
+
+/**
+ * Arc sine, for arguments in [-1, 1].
+ */
+inline double asin(double x) {
+	return simd::asin(Lane(x)).v;
+}
+
+/**
+ * Same as asin() with reduced accuracy.
+ */
+inline double asinReduced(double x) {
+	return simd::asinReduced(Lane(x)).v;
+}
+
+/**
+ * Square root.
+ */
+inline double sqrt(double x) {
+	return std::sqrt(x);
+}
+
+} // fastmath
+
+} // geodesy
+
+#endif /* FASTMATH_HPP_ */
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#ifndef FILEUTIL_HPP_
+#define FILEUTIL_HPP_
+
+#include <cstdio>
+#include <string>
+
+/**
+ * The steps the writers of SpatialIndex and ColumnarFile share to replace a
+ * file safely: they write a temporary file next to it and rename that over
+ * it. The data must be on disk before the rename, or a crash could leave an
+ * empty or truncated file under the name, and the directory must be on disk
+ * after it, or a crash could lose the rename.
+ */
+namespace geodesy {
+
+namespace fileutil {
+
+/**
+ * Flush a file to disk and close it. The file is closed even if flushing it
+ * failed.
+ *
+ * @return false with errno set if that failed
+ */
+bool closeSynced(FILE *file);
+
+/**
+ * Flush the directory that holds a file to disk, so that the entry a rename
+ * gave the file survives a crash.
+ *
+ * @return false with errno set if that failed
+ */
+bool syncDirectory(const std::string &path);
+
+}
+
+}
+
+#endif /* FILEUTIL_HPP_ */
@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#include "GeodesicLine.hpp"
+#include "Angle.hpp"
+#include "FastMath.hpp"
+#include "SolverStats.hpp"
+
+#include <cmath>
+
+namespace geodesy {
+
+using namespace std;
+
+GeodesicLine::~GeodesicLine() {
+}
+
+GeodesicLine::GeodesicLine(const Ellipsoid &ellipsoid,
+		const GlobalCoordinates &start, double startBearing)
+				throw (InvalidAzimuthException) :
+		mStartLatitude(start.getLatitude()), mStartLongitude(
+				start.getLongitude()), mStartBearing(startBearing) {
+	if (isnan(startBearing)) {
+		throw InvalidAzimuthException();
+	}
+
+	initialize(ellipsoid);
+}
+
+GeodesicLine::GeodesicLine(const Ellipsoid &ellipsoid, double startLatitude,
+		double startLongitude, double startBearing) :
+		mStartLatitude(startLatitude), mStartLongitude(startLongitude), mStartBearing(
+				startBearing) {
+	initialize(ellipsoid);
+}
+
+void GeodesicLine::initialize(const Ellipsoid &ellipsoid) {
+	double f = ellipsoid.getFlattening();
+	double phi1 = Angle::toRadians(mStartLatitude);
+	double alpha1 = Angle::toRadians(mStartBearing);
+
+	mSemiMinorAxis = ellipsoid.getSemiMinorAxis();
+	mFlattening = f;
+	mAxisRatio = ellipsoid.getAxisRatio();
+	double tanU1 = mAxisRatio * tan(phi1);
+	fastmath::sincos(alpha1, mSinAlpha1, mCosAlpha1);
+	mCosU1 = 1.0 / sqrt(1.0 + tanU1 * tanU1);
+	mSinU1 = tanU1 * mCosU1;
+
+	// eq. 1
+	mSigma1 = fastmath::atan2(tanU1, mCosAlpha1);
+
+	// eq. 2
+	mSinAlpha = mCosU1 * mSinAlpha1;
+
+	mSin2Alpha = mSinAlpha * mSinAlpha;
+	mCos2Alpha = 1 - mSin2Alpha;
+	double uSquared = mCos2Alpha * ellipsoid.getSecondEccentricitySquared();
+
+	// eq. 3
+	mA = 1
+			+ (uSquared / 16384)
+					* (4096
+							+ uSquared * (-768 + uSquared * (320 - 175 * uSquared)));
+
+	// eq. 4
+	mB = (uSquared / 1024)
+			* (256 + uSquared * (-128 + uSquared * (74 - 47 * uSquared)));
+
+	// eq. 10
+	mC = (f / 16) * mCos2Alpha * (4 + f * (4 - 3 * mCos2Alpha));
+}
+
+double GeodesicLine::getStartLatitude() const {
+	return mStartLatitude;
+}
+
+double GeodesicLine::getStartLongitude() const {
+	return mStartLongitude;
+}
+
+double GeodesicLine::getStartBearing() const {
+	return mStartBearing;
+}
+
+void GeodesicLine::solve(double distance, double const errorTolerance,
+		int const maxIterations, double &latitude, double &longitude,
+		double &endBearing) const {
+	double b = mSemiMinorAxis;
+	double f = mFlattening;
+	double s = distance;
+	double sigma1 = mSigma1;
+	double sinU1 = mSinU1;
+	double cosU1 = mCosU1;
+	double sinAlpha1 = mSinAlpha1;
+	double cosAlpha1 = mCosAlpha1;
+	double sinAlpha = mSinAlpha;
+	double A = mA;
+	double B = mB;
+	double C = mC;
+
+	// iterate until there is a negligible change in sigma
+	double deltaSigma;
+	double sOverbA = s / (b * A);
+	double sigma = sOverbA;
+	double sinSigma;
+	double prevSigma = sOverbA;
+	double sigmaM2;
+	double cosSigmaM2;
+	double cos2SigmaM2;
+	bool converged = false;
+	int iterations = 0;
+
+	for (int iteration = 0; iteration < maxIterations; ++iteration) {
+		++iterations;
+
+		// eq. 5
+		sigmaM2 = 2.0 * sigma1 + sigma;
+		double sinSigmaM2;
+		fastmath::sincos(sigmaM2, sinSigmaM2, cosSigmaM2);
+		cos2SigmaM2 = cosSigmaM2 * cosSigmaM2;
+		double cosSignma;
+		fastmath::sincos(sigma, sinSigma, cosSignma);
+
+		// eq. 6
+		deltaSigma = B * sinSigma
+				* (cosSigmaM2
+						+ (B / 4.0)
+								* (cosSignma * (-1 + 2 * cos2SigmaM2)
+										- (B / 6.0) * cosSigmaM2
+												* (-3 + 4 * sinSigma * sinSigma)
+												* (-3 + 4 * cos2SigmaM2)));
+
+		// eq. 7
+		sigma = sOverbA + deltaSigma;
+
+		// break after converging to tolerance
+		if (fabs(sigma - prevSigma) < errorTolerance) {
+			converged = true;
+			break;
+		}
+
+		prevSigma = sigma;
+	}
+
+	GEODESY_STATS_RECORD(SolverStats::Direct, iterations, converged, false);
+
+	sigmaM2 = 2.0 * sigma1 + sigma;
+	double sinSigmaM2;
+	fastmath::sincos(sigmaM2, sinSigmaM2, cosSigmaM2);
+	cos2SigmaM2 = cosSigmaM2 * cosSigmaM2;
+
+	double cosSigma;
+	fastmath::sincos(sigma, sinSigma, cosSigma);
+
+	// eq. 8
+	double x = sinU1 * sinSigma - cosU1 * cosSigma * cosAlpha1;
+	double phi2 = fastmath::atan2(
+			sinU1 * cosSigma + cosU1 * sinSigma * cosAlpha1,
+			mAxisRatio * sqrt(mSin2Alpha + x * x));
+
+	// eq. 9
+	// This fixes the pole crossing defect spotted by Matt Feemster. When a
+	// path passes a pole and essentially crosses a line of latitude twice -
+	// once in each direction - the longitude calculation got messed up. Using
+	// atan2 instead of atan fixes the defect. The change is in the next 3
+	// lines.
+	// double tanLambda = sinSigma * sinAlpha1 / (cosU1 * cosSigma - sinU1 * sinSigma * cosAlpha1);
+	// double lambda = atan(tanLambda);
+	double lambda = fastmath::atan2(sinSigma * sinAlpha1,
+			(cosU1 * cosSigma - sinU1 * sinSigma * cosAlpha1));
+
+	// eq. 11
+	double L = lambda
+			- (1 - C) * f * sinAlpha
+					* (sigma
+							+ C * sinSigma
+									* (cosSigmaM2
+											+ C * cosSigma
+													* (-1 + 2 * cos2SigmaM2)));
+
+	// eq. 12
+	double alpha2 = fastmath::atan2(sinAlpha,
+			-sinU1 * sinSigma + cosU1 * cosSigma * cosAlpha1);
+
+	// build result
+	latitude = Angle::toDegrees(phi2);
+	longitude = mStartLongitude + Angle::toDegrees(L);
+
+	endBearing = Angle::toDegrees(alpha2);
+}
+
+GeodeticDestinationValue GeodesicLine::calculatePosition(double distance,
+		double const errorTolerance, int const maxIterations) const {
+	GeodeticDestinationValue destination;
+	solve(distance, errorTolerance, maxIterations, destination.latitude,
+			destination.longitude, destination.endBearing);
+	GlobalCoordinates::canonicalize(destination.latitude,
+			destination.longitude);
+
+	return destination;
+}
+
+void GeodesicLine::calculatePositions(std::size_t count,
+		const double *distances, double *latitudes, double *longitudes,
+		double *endBearings, double const errorTolerance,
+		int const maxIterations) const {
+	for (std::size_t i = 0; i < count; ++i) {
+		double endBearing;
+		solve(distances[i], errorTolerance, maxIterations, latitudes[i],
+				longitudes[i], endBearing);
+		GlobalCoordinates::canonicalize(latitudes[i], longitudes[i]);
+		if (endBearings) {
+			endBearings[i] = endBearing;
+		}
+	}
+}
+
+}
@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#ifndef GEODESICLINE_HPP_
+#define GEODESICLINE_HPP_
+
+#include <cstddef>
+#include <tr1/memory>
+
+#include "Ellipsoid.hpp"
+#include "GeodeticCalculator.hpp"
+#include "GlobalCoordinates.hpp"
+
+namespace geodesy {
+
+/**
+ * <p>
+ * A geodesic given by a starting point and a starting bearing, set up for
+ * solving the direct problem at many distances along it. Everything in
+ * Vincenty's direct formula that does not depend on the distance (the reduced
+ * latitude, sigma1, alpha, u^2 and the A, B and C coefficients) is computed
+ * once by the constructor, so each position only costs the sigma iteration
+ * and the final trigonometry.
+ * </p>
+ * <p>
+ * Positions agree with GeodeticCalculator::calculateEndingGlobalCoordinates(),
+ * which is implemented on top of this class.
+ * </p>
+ */
+class GeodesicLine {
+public:
+	typedef std::tr1::shared_ptr<GeodesicLine> Ptr;
+	typedef std::tr1::shared_ptr<GeodesicLine const> ConstPtr;
+
+	virtual ~GeodesicLine();
+
+	/**
+	 * Set up a geodesic. The line keeps copies of the ellipsoid constants it
+	 * needs, not a reference to the ellipsoid.
+	 *
+	 * @param ellipsoid reference ellipsoid to use
+	 * @param start starting location
+	 * @param startBearing starting bearing (degrees)
+	 * @throws InvalidAzimuthException if startBearing is NaN
+	 */
+	GeodesicLine(const Ellipsoid &ellipsoid, const GlobalCoordinates &start,
+			double startBearing) throw (InvalidAzimuthException);
+
+	/**
+	 * Get the starting latitude.
+	 * @return latitude in degrees
+	 */
+	double getStartLatitude() const;
+
+	/**
+	 * Get the starting longitude.
+	 * @return longitude in degrees
+	 */
+	double getStartLongitude() const;
+
+	/**
+	 * Get the starting bearing.
+	 * @return bearing in degrees
+	 */
+	double getStartBearing() const;
+
+	/**
+	 * Calculate the position and bearing after traveling a distance along the
+	 * line. This is the solution to the direct geodetic problem.
+	 *
+	 * @param distance distance to travel (meters)
+	 * @param errorTolerance once the change in sigma reaches this value, stop iterating
+	 * @param maxIterations maximum number of iterations, even if the error tolerance is not met
+	 * @return the location and bearing at that distance
+	 */
+	GeodeticDestinationValue calculatePosition(double distance,
+			double const errorTolerance = 1E-13,
+			int const maxIterations = 20) const;
+
+	/**
+	 * Calculate the positions and bearings at many distances along the line,
+	 * written to caller-owned arrays. No memory is allocated.
+	 *
+	 * @param count number of distances
+	 * @param distances distances to travel (meters)
+	 * @param latitudes latitudes in degrees (output array)
+	 * @param longitudes longitudes in degrees (output array)
+	 * @param endBearings bearings in degrees (output array, may be NULL)
+	 * @param errorTolerance once the change in sigma reaches this value, stop iterating
+	 * @param maxIterations maximum number of iterations, even if the error tolerance is not met
+	 */
+	void calculatePositions(std::size_t count, const double *distances,
+			double *latitudes, double *longitudes, double *endBearings,
+			double const errorTolerance = 1E-13,
+			int const maxIterations = 20) const;
+
+private:
+	friend class GeodeticCalculator;
+
+	/**
+	 * Set up a geodesic from raw values. The starting coordinates must be
+	 * canonical and the bearing must not be NaN.
+	 */
+	GeodesicLine(const Ellipsoid &ellipsoid, double startLatitude,
+			double startLongitude, double startBearing);
+
+	/**
+	 * Compute all the terms that depend only on the start and the bearing.
+	 */
+	void initialize(const Ellipsoid &ellipsoid);
+
+	/**
+	 * Same as calculatePosition() without canonicalizing the longitude.
+	 */
+	void solve(double distance, double const errorTolerance,
+			int const maxIterations, double &latitude, double &longitude,
+			double &endBearing) const;
+
+	/** Semi minor axis (meters). */
+	double mSemiMinorAxis;
+
+	/** Flattening. */
+	double mFlattening;
+
+	/** 1 - f */
+	double mAxisRatio;
+
+	/** Starting latitude (degrees). */
+	double mStartLatitude;
+
+	/** Starting longitude (degrees). */
+	double mStartLongitude;
+
+	/** Starting bearing (degrees). */
+	double mStartBearing;
+
+	/** Sine and cosine of the starting bearing. */
+	double mSinAlpha1;
+	double mCosAlpha1;
+
+	/** Sine and cosine of the reduced latitude of the start. */
+	double mSinU1;
+	double mCosU1;
+
+	/** Angular distance from the equator to the start (eq. 1). */
+	double mSigma1;
+
+	/** Sine of the azimuth of the geodesic at the equator (eq. 2). */
+	double mSinAlpha;
+
+	/** Squares of the sine and cosine of the equatorial azimuth. */
+	double mSin2Alpha;
+	double mCos2Alpha;
+
+	/** Coefficients of eq. 3, 4 and 10. */
+	double mA;
+	double mB;
+	double mC;
+
+};
+
+}
+
+#endif /* GEODESICLINE_HPP_ */
@@ -28,7 +28,14 @@
 
 #include "GeodeticCalculator.hpp"
 #include "Angle.hpp"
-
+#include "ApproximateInverse.hpp"
+#include "FastMath.hpp"
+#include "GeodesicLine.hpp"
+#include "KarneyInverse.hpp"
+#include "SolverStats.hpp"
+#include "VincentySimd.hpp"
+
+#include <algorithm>
 #include <cmath>
 #include <limits>
 
@@ -36,185 +43,172 @@ namespace geodesy {
 
 using namespace std;
 
+/**
+ * Number of problems the batch methods stage at a time. Must be a multiple of
+ * simd::MaxLanes.
+ */
+static const std::size_t BatchBlockSize = 64;
+
+GeodeticDestinationValue GeodeticCalculator::calculateEndingGlobalCoordinates(
+		const Ellipsoid &ellipsoid, const GlobalCoordinates &start,
+		double startBearing, double distance, double const errorTolerance,
+		int const maxIterations) throw (InvalidAzimuthException) {
+	GEODESY_STATS_TIMER(SolverStats::Direct);
+	GeodesicLine line(ellipsoid, start, startBearing);
+
+	return line.calculatePosition(distance, errorTolerance, maxIterations);
+}
+
 GlobalCoordinates::Ptr GeodeticCalculator::calculateEndingGlobalCoordinates(
-		Ellipsoid::ConstPtr ellipsoid, const GlobalCoordinates &start,
+		const Ellipsoid::ConstPtr &ellipsoid, const GlobalCoordinates &start,
 		double startBearing, double distance, double &endBearing,
 		double const errorTolerance, int const maxIterations)
 				throw (InvalidAzimuthException) {
-	if (isnan(startBearing)) {
-		throw InvalidAzimuthException();
-	}
+	GeodeticDestinationValue destination = calculateEndingGlobalCoordinates(
+			*ellipsoid, start, startBearing, distance, errorTolerance,
+			maxIterations);
+	endBearing = destination.endBearing;
+
+	return GlobalCoordinates::Ptr(
+			new GlobalCoordinates(destination.latitude, destination.longitude,
+					GlobalCoordinates::AssumeCanonical));
+}
 
-	double a = ellipsoid->getSemiMajorAxis();
-	double b = ellipsoid->getSemiMinorAxis();
-	double aSquared = a * a;
-	double bSquared = b * b;
-	double f = ellipsoid->getFlattening();
-	double phi1 = Angle::toRadians(start.getLatitude());
-	double alpha1 = Angle::toRadians(startBearing);
-	double cosAlpha1 = cos(alpha1);
-	double sinAlpha1 = sin(alpha1);
-	double s = distance;
-	double tanU1 = (1.0 - f) * tan(phi1);
-	double cosU1 = 1.0 / sqrt(1.0 + tanU1 * tanU1);
-	double sinU1 = tanU1 * cosU1;
-
-	// eq. 1
-	double sigma1 = atan2(tanU1, cosAlpha1);
-
-	// eq. 2
-	double sinAlpha = cosU1 * sinAlpha1;
-
-	double sin2Alpha = sinAlpha * sinAlpha;
-	double cos2Alpha = 1 - sin2Alpha;
-	double uSquared = cos2Alpha * (aSquared - bSquared) / bSquared;
-
-	// eq. 3
-	double A =
-			1
-					+ (uSquared / 16384)
-							* (4096
-									+ uSquared
-											* (-768
-													+ uSquared
-															* (320
-																	- 175
-																			* uSquared)));
-
-	// eq. 4
-	double B = (uSquared / 1024)
-			* (256 + uSquared * (-128 + uSquared * (74 - 47 * uSquared)));
-
-	// iterate until there is a negligible change in sigma
-	double deltaSigma;
-	double sOverbA = s / (b * A);
-	double sigma = sOverbA;
-	double sinSigma;
-	double prevSigma = sOverbA;
-	double sigmaM2;
-	double cosSigmaM2;
-	double cos2SigmaM2;
-
-	for (int iteration = 0; iteration < maxIterations; ++iteration) {
-		// eq. 5
-		sigmaM2 = 2.0 * sigma1 + sigma;
-		cosSigmaM2 = cos(sigmaM2);
-		cos2SigmaM2 = cosSigmaM2 * cosSigmaM2;
-		sinSigma = sin(sigma);
-		double cosSignma = cos(sigma);
+void GeodeticCalculator::calculateEndingGlobalCoordinates(
+		const Ellipsoid::ConstPtr &ellipsoid, std::size_t count,
+		const double *startLatitudes, const double *startLongitudes,
+		const double *startBearings, const double *distances,
+		double *endLatitudes, double *endLongitudes, double *endBearings,
+		double const errorTolerance, int const maxIterations)
+				throw (InvalidAzimuthException) {
+	calculateEndingGlobalCoordinates(*ellipsoid, count, startLatitudes,
+			startLongitudes, startBearings, distances, endLatitudes,
+			endLongitudes, endBearings, errorTolerance, maxIterations);
+}
 
-		// eq. 6
-		deltaSigma = B * sinSigma
-				* (cosSigmaM2
-						+ (B / 4.0)
-								* (cosSignma * (-1 + 2 * cos2SigmaM2)
-										- (B / 6.0) * cosSigmaM2
-												* (-3 + 4 * sinSigma * sinSigma)
-												* (-3 + 4 * cos2SigmaM2)));
-
-		// eq. 7
-		sigma = sOverbA + deltaSigma;
-
-		// break after converging to tolerance
-		if (fabs(sigma - prevSigma) < errorTolerance)
-			break;
+void GeodeticCalculator::calculateEndingGlobalCoordinates(
+		const Ellipsoid &ellipsoid, std::size_t count,
+		const double *startLatitudes, const double *startLongitudes,
+		const double *startBearings, const double *distances,
+		double *endLatitudes, double *endLongitudes, double *endBearings,
+		double const errorTolerance, int const maxIterations)
+				throw (InvalidAzimuthException) {
+	double a = ellipsoid.getSemiMajorAxis();
+	double b = ellipsoid.getSemiMinorAxis();
+	double f = ellipsoid.getFlattening();
+
+	const simd::Kernels *kernels = simd::bestKernels();
+	std::size_t lanes = kernels ? kernels->lanes : 1;
+
+	// canonical copies of one block of problems, padded to a whole number of
+	// lanes
+	double lat1[BatchBlockSize];
+	double lon1[BatchBlockSize];
+	double alpha1[BatchBlockSize];
+	double s[BatchBlockSize];
+	double lat2[BatchBlockSize];
+	double lon2[BatchBlockSize];
+	double alpha2[BatchBlockSize];
+
+	for (std::size_t offset = 0; offset < count; offset += BatchBlockSize) {
+		std::size_t n = std::min(BatchBlockSize, count - offset);
+		for (std::size_t i = 0; i < n; ++i) {
+			alpha1[i] = startBearings[offset + i];
+			if (isnan(alpha1[i])) {
+				throw InvalidAzimuthException();
+			}
+			lat1[i] = startLatitudes[offset + i];
+			lon1[i] = startLongitudes[offset + i];
+			s[i] = distances[offset + i];
+		}
+		GlobalCoordinates::canonicalize(n, lat1, lon1);
+
+		std::size_t padded = (n + lanes - 1) / lanes * lanes;
+		for (std::size_t i = n; i < padded; ++i) {
+			lat1[i] = lat1[n - 1];
+			lon1[i] = lon1[n - 1];
+			alpha1[i] = alpha1[n - 1];
+			s[i] = s[n - 1];
+		}
 
-		prevSigma = sigma;
+		if (kernels) {
+			kernels->direct(a, b, f, errorTolerance, maxIterations, padded,
+					lat1, lon1, alpha1, s, lat2, lon2, alpha2);
+		} else {
+			for (std::size_t i = 0; i < n; ++i) {
+				GeodesicLine line(ellipsoid, lat1[i], lon1[i], alpha1[i]);
+				line.solve(s[i], errorTolerance, maxIterations, lat2[i],
+						lon2[i], alpha2[i]);
+			}
+		}
+
+		GlobalCoordinates::canonicalize(n, lat2, lon2);
+		std::copy(lat2, lat2 + n, endLatitudes + offset);
+		std::copy(lon2, lon2 + n, endLongitudes + offset);
+		if (endBearings) {
+			std::copy(alpha2, alpha2 + n, endBearings + offset);
+		}
 	}
+}
 
-	sigmaM2 = 2.0 * sigma1 + sigma;
-	cosSigmaM2 = cos(sigmaM2);
-	cos2SigmaM2 = cosSigmaM2 * cosSigmaM2;
-
-	double cosSigma = cos(sigma);
-	sinSigma = sin(sigma);
-
-	// eq. 8
-	double phi2 = atan2(
-			sinU1 * cosSigma + cosU1 * sinSigma * cosAlpha1,
-			(1.0 - f)
-					* sqrt(
-							sin2Alpha
-									+ pow(
-											sinU1 * sinSigma
-													- cosU1 * cosSigma
-															* cosAlpha1, 2.0)));
-
-	// eq. 9
-	// This fixes the pole crossing defect spotted by Matt Feemster. When a
-	// path passes a pole and essentially crosses a line of latitude twice -
-	// once in each direction - the longitude calculation got messed up. Using
-	// atan2 instead of atan fixes the defect. The change is in the next 3
-	// lines.
-	// double tanLambda = sinSigma * sinAlpha1 / (cosU1 * cosSigma - sinU1 * sinSigma * cosAlpha1);
-	// double lambda = atan(tanLambda);
-	double lambda = atan2(sinSigma * sinAlpha1,
-			(cosU1 * cosSigma - sinU1 * sinSigma * cosAlpha1));
-
-	// eq. 10
-	double C = (f / 16) * cos2Alpha * (4 + f * (4 - 3 * cos2Alpha));
-
-	// eq. 11
-	double L = lambda
-			- (1 - C) * f * sinAlpha
-					* (sigma
-							+ C * sinSigma
-									* (cosSigmaM2
-											+ C * cosSigma
-													* (-1 + 2 * cos2SigmaM2)));
-
-	// eq. 12
-	double alpha2 = atan2(sinAlpha,
-			-sinU1 * sinSigma + cosU1 * cosSigma * cosAlpha1);
-
-	// build result
-	double latitude = Angle::toDegrees(phi2);
-	double longitude = start.getLongitude() + Angle::toDegrees(L);
-
-	endBearing = Angle::toDegrees(alpha2);
-
-	return GlobalCoordinates::Ptr(new GlobalCoordinates(latitude, longitude));
+void GeodeticCalculator::reducePoint(double axisRatio, double latitude,
+		double longitude, double &sinU, double &cosU, double &lambda) {
+	double phi = Angle::toRadians(latitude);
+	double tanU = axisRatio * tan(phi);
+	double U = atan(tanU);
+	sinU = sin(U);
+	cosU = cos(U);
+	lambda = Angle::toRadians(longitude);
 }
 
-GeodeticCurve::Ptr GeodeticCalculator::calculateGeodeticCurve(
-		Ellipsoid::ConstPtr ellipsoid, const GlobalCoordinates &start,
-		const GlobalCoordinates &end, double const errorTolerance,
-		int const maxIterations) {
+void GeodeticCalculator::solveInverse(const Ellipsoid &ellipsoid,
+		double startLatitude, double startLongitude, double endLatitude,
+		double endLongitude, double const errorTolerance,
+		int const maxIterations, double &s, double &alpha1, double &alpha2) {
+	double axisRatio = ellipsoid.getAxisRatio();
+	double sinU1, cosU1, lambda1;
+	double sinU2, cosU2, lambda2;
+	reducePoint(axisRatio, startLatitude, startLongitude, sinU1, cosU1,
+			lambda1);
+	reducePoint(axisRatio, endLatitude, endLongitude, sinU2, cosU2, lambda2);
+	solveReducedInverse(ellipsoid.getSemiMinorAxis(),
+			ellipsoid.getFlattening(),
+			ellipsoid.getSecondEccentricitySquared(), sinU1, cosU1, lambda1,
+			sinU2, cosU2, lambda2, errorTolerance, maxIterations, s, alpha1,
+			alpha2);
+}
+
+void GeodeticCalculator::solveTimedInverse(double axisRatio, double b,
+		double f, double secondEccentricitySquared, double startLatitude,
+		double startLongitude, double endLatitude, double endLongitude,
+		double const errorTolerance, int const maxIterations, double &s,
+		double &alpha1, double &alpha2) {
+	GEODESY_STATS_TIMER(SolverStats::Inverse);
+	double sinU1, cosU1, lambda1;
+	double sinU2, cosU2, lambda2;
+	reducePoint(axisRatio, startLatitude, startLongitude, sinU1, cosU1,
+			lambda1);
+	reducePoint(axisRatio, endLatitude, endLongitude, sinU2, cosU2, lambda2);
+	solveReducedInverse(b, f, secondEccentricitySquared, sinU1, cosU1,
+			lambda1, sinU2, cosU2, lambda2, errorTolerance, maxIterations, s,
+			alpha1, alpha2);
+}
+
+void GeodeticCalculator::solveReducedInverse(double b, double f,
+		double secondEccentricitySquared, double sinU1, double cosU1,
+		double lambda1, double sinU2, double cosU2, double lambda2,
+		double const errorTolerance, int const maxIterations, double &s,
+		double &alpha1, double &alpha2) {
 	//
 	// All equation numbers refer back to Vincenty's publication:
 	// See http://www.ngs.noaa.gov/PUBS_LIB/inverse.pdf
 	//
 
-	// get constants
-	double a = ellipsoid->getSemiMajorAxis();
-	double b = ellipsoid->getSemiMinorAxis();
-	double f = ellipsoid->getFlattening();
-
-	// get parameters as radians
-	double phi1 = Angle::toRadians(start.getLatitude());
-	double lambda1 = Angle::toRadians(start.getLongitude());
-	double phi2 = Angle::toRadians(end.getLatitude());
-	double lambda2 = Angle::toRadians(end.getLongitude());
-
 	// calculations
-	double a2 = a * a;
-	double b2 = b * b;
-	double a2b2b2 = (a2 - b2) / b2;
+	double a2b2b2 = secondEccentricitySquared;
 
 	double omega = lambda2 - lambda1;
 
-	double tanphi1 = tan(phi1);
-	double tanU1 = (1.0 - f) * tanphi1;
-	double U1 = atan(tanU1);
-	double sinU1 = sin(U1);
-	double cosU1 = cos(U1);
-
-	double tanphi2 = tan(phi2);
-	double tanU2 = (1.0 - f) * tanphi2;
-	double U2 = atan(tanU2);
-	double sinU2 = sin(U2);
-	double cosU2 = cos(U2);
-
 	double sinU1sinU2 = sinU1 * sinU2;
 	double cosU1sinU2 = cosU1 * sinU2;
 	double sinU1cosU2 = sinU1 * cosU2;
@@ -230,12 +224,15 @@ GeodeticCurve::Ptr GeodeticCalculator::calculateGeodeticCurve(
 	double deltasigma = 0.0;
 	double lambda0;
 	bool converged = false;
+	int iterations = 0;
 
 	for (int i = 0; i < maxIterations; i++) {
+		++iterations;
 		lambda0 = lambda;
 
-		double sinlambda = sin(lambda);
-		double coslambda = cos(lambda);
+		double sinlambda;
+		double coslambda;
+		fastmath::sincos(lambda, sinlambda, coslambda);
 
 		// eq. 14
 		double sin2sigma = (cosU2 * sinlambda * cosU2 * sinlambda)
@@ -247,14 +244,12 @@ GeodeticCurve::Ptr GeodeticCalculator::calculateGeodeticCurve(
 		double cossigma = sinU1sinU2 + (cosU1cosU2 * coslambda);
 
 		// eq. 16
-		sigma = atan2(sinsigma, cossigma);
+		sigma = fastmath::atan2(sinsigma, cossigma);
 
 		// eq. 17 Careful! sin2sigma might be almost 0!
 		double sinalpha =
 				(sin2sigma == 0) ? 0.0 : cosU1cosU2 * sinlambda / sinsigma;
-		double alpha = asin(sinalpha);
-		double cosalpha = cos(alpha);
-		double cos2alpha = cosalpha * cosalpha;
+		double cos2alpha = 1.0 - sinalpha * sinalpha;
 
 		// eq. 18 Careful! cos2alpha might be almost 0!
 		double cos2sigmam =
@@ -303,16 +298,17 @@ GeodeticCurve::Ptr GeodeticCalculator::calculateGeodeticCurve(
 	}
 
 	// eq. 19
-	double s = b * A * (sigma - deltasigma);
-	double alpha1;
-	double alpha2;
+	s = b * A * (sigma - deltasigma);
+
+	GEODESY_STATS_RECORD(SolverStats::Inverse, iterations, converged,
+			!converged && sinU1 != sinU2);
 
 	// didn't converge? must be N/S
 	if (!converged) {
-		if (phi1 > phi2) {
+		if (sinU1 > sinU2) {
 			alpha1 = 180.0;
 			alpha2 = 0.0;
-		} else if (phi1 < phi2) {
+		} else if (sinU1 < sinU2) {
 			alpha1 = 0.0;
 			alpha2 = 180.0;
 		} else {
@@ -327,16 +323,20 @@ GeodeticCurve::Ptr GeodeticCalculator::calculateGeodeticCurve(
 
 		double radians;
 
+		double sinlambda;
+		double coslambda;
+		fastmath::sincos(lambda, sinlambda, coslambda);
+
 		// eq. 20
-		radians = atan2(cosU2 * sin(lambda),
-				(cosU1sinU2 - sinU1cosU2 * cos(lambda)));
+		radians = fastmath::atan2(cosU2 * sinlambda,
+				(cosU1sinU2 - sinU1cosU2 * coslambda));
 		if (radians < 0.0)
 			radians += TwoPi;
 		alpha1 = Angle::toDegrees(radians);
 
 		// eq. 21
-		radians = atan2(cosU1 * sin(lambda),
-				(-sinU1cosU2 + cosU1sinU2 * cos(lambda))) + M_PI;
+		radians = fastmath::atan2(cosU1 * sinlambda,
+				(-sinU1cosU2 + cosU1sinU2 * coslambda)) + M_PI;
 		if (radians < 0.0)
 			radians += TwoPi;
 		alpha2 = Angle::toDegrees(radians);
@@ -346,35 +346,383 @@ GeodeticCurve::Ptr GeodeticCalculator::calculateGeodeticCurve(
 		alpha1 -= 360.0;
 	if (alpha2 >= 360.0)
 		alpha2 -= 360.0;
+}
 
-	return GeodeticCurve::Ptr(new GeodeticCurve(s, alpha1, alpha2));
+GeodeticCurveValue GeodeticCalculator::calculateGeodeticCurve(
+		const Ellipsoid &ellipsoid, const GlobalCoordinates &start,
+		const GlobalCoordinates &end, double const errorTolerance,
+		int const maxIterations) {
+	return calculateGeodeticCurve(ellipsoid, start, end, Vincenty,
+			errorTolerance, maxIterations);
 }
-GeodeticMeasurement::Ptr GeodeticCalculator::calculateGeodeticMeasurement(
-		Ellipsoid::ConstPtr refEllipsoid, const GlobalPosition &start,
-		const GlobalPosition &end) {
+
+GeodeticCurveValue GeodeticCalculator::calculateGeodeticCurve(
+		const Ellipsoid &ellipsoid, const GlobalCoordinates &start,
+		const GlobalCoordinates &end, InverseMethod method,
+		double const errorTolerance, int const maxIterations) {
+	GEODESY_STATS_TIMER(SolverStats::Inverse);
+	GeodeticCurveValue curve;
+	switch (method) {
+	case Karney:
+		return KarneyInverse(ellipsoid).calculateGeodeticCurve(start, end);
+	case AndoyerLambert:
+		ApproximateInverse::andoyerLambert(ellipsoid.getSemiMajorAxis(),
+				ellipsoid.getFlattening(), start.getLatitude(),
+				start.getLongitude(), end.getLatitude(), end.getLongitude(),
+				curve.ellipsoidalDistance, curve.azimuth, curve.reverseAzimuth);
+		break;
+	case Haversine:
+		ApproximateInverse::haversine(ellipsoid.getSemiMajorAxis(),
+				ellipsoid.getSemiMinorAxis(), start.getLatitude(),
+				start.getLongitude(), end.getLatitude(), end.getLongitude(),
+				curve.ellipsoidalDistance, curve.azimuth, curve.reverseAzimuth);
+		break;
+	default:
+		solveInverse(ellipsoid, start.getLatitude(), start.getLongitude(),
+				end.getLatitude(), end.getLongitude(), errorTolerance,
+				maxIterations, curve.ellipsoidalDistance, curve.azimuth,
+				curve.reverseAzimuth);
+		break;
+	}
+
+	return curve;
+}
+
+GeodeticCurve::Ptr GeodeticCalculator::calculateGeodeticCurve(
+		const Ellipsoid::ConstPtr &ellipsoid, const GlobalCoordinates &start,
+		const GlobalCoordinates &end, double const errorTolerance,
+		int const maxIterations) {
+	return calculateGeodeticCurve(ellipsoid, start, end, Vincenty,
+			errorTolerance, maxIterations);
+}
+
+GeodeticCurve::Ptr GeodeticCalculator::calculateGeodeticCurve(
+		const Ellipsoid::ConstPtr &ellipsoid, const GlobalCoordinates &start,
+		const GlobalCoordinates &end, InverseMethod method,
+		double const errorTolerance, int const maxIterations) {
+	GeodeticCurveValue curve = calculateGeodeticCurve(*ellipsoid, start, end,
+			method, errorTolerance, maxIterations);
+
+	return GeodeticCurve::Ptr(
+			new GeodeticCurve(curve.ellipsoidalDistance, curve.azimuth,
+					curve.reverseAzimuth));
+}
+
+void GeodeticCalculator::calculateGeodeticCurves(
+		const Ellipsoid::ConstPtr &ellipsoid, std::size_t count,
+		const double *startLatitudes, const double *startLongitudes,
+		const double *endLatitudes, const double *endLongitudes,
+		double *ellipsoidalDistances, double *azimuths,
+		double *reverseAzimuths, double const errorTolerance,
+		int const maxIterations) {
+	calculateGeodeticCurves(*ellipsoid, count, startLatitudes, startLongitudes,
+			endLatitudes, endLongitudes, ellipsoidalDistances, azimuths,
+			reverseAzimuths, Vincenty, errorTolerance, maxIterations);
+}
+
+void GeodeticCalculator::calculateGeodeticCurves(const Ellipsoid &ellipsoid,
+		std::size_t count, const double *startLatitudes,
+		const double *startLongitudes, const double *endLatitudes,
+		const double *endLongitudes, double *ellipsoidalDistances,
+		double *azimuths, double *reverseAzimuths,
+		double const errorTolerance, int const maxIterations) {
+	calculateGeodeticCurves(ellipsoid, count, startLatitudes, startLongitudes,
+			endLatitudes, endLongitudes, ellipsoidalDistances, azimuths,
+			reverseAzimuths, Vincenty, errorTolerance, maxIterations);
+}
+
+void GeodeticCalculator::calculateGeodeticCurves(
+		const Ellipsoid::ConstPtr &ellipsoid, std::size_t count,
+		const double *startLatitudes, const double *startLongitudes,
+		const double *endLatitudes, const double *endLongitudes,
+		double *ellipsoidalDistances, double *azimuths,
+		double *reverseAzimuths, InverseMethod method,
+		double const errorTolerance, int const maxIterations) {
+	calculateGeodeticCurves(*ellipsoid, count, startLatitudes, startLongitudes,
+			endLatitudes, endLongitudes, ellipsoidalDistances, azimuths,
+			reverseAzimuths, method, errorTolerance, maxIterations);
+}
+
+void GeodeticCalculator::calculateGeodeticCurves(const Ellipsoid &ellipsoid,
+		std::size_t count, const double *startLatitudes,
+		const double *startLongitudes, const double *endLatitudes,
+		const double *endLongitudes, double *ellipsoidalDistances,
+		double *azimuths, double *reverseAzimuths, InverseMethod method,
+		double const errorTolerance, int const maxIterations) {
+	// only Karney's method needs its series coefficients
+	if (method == Karney) {
+		KarneyInverse karney(ellipsoid);
+		solveCurves(ellipsoid, &karney, count, startLatitudes,
+				startLongitudes, endLatitudes, endLongitudes,
+				ellipsoidalDistances, azimuths, reverseAzimuths, method,
+				errorTolerance, maxIterations);
+	} else {
+		solveCurves(ellipsoid, 0, count, startLatitudes, startLongitudes,
+				endLatitudes, endLongitudes, ellipsoidalDistances, azimuths,
+				reverseAzimuths, method, errorTolerance, maxIterations);
+	}
+}
+
+void GeodeticCalculator::solveCurves(const Ellipsoid &ellipsoid,
+		const KarneyInverse *karney, std::size_t count,
+		const double *startLatitudes, const double *startLongitudes,
+		const double *endLatitudes, const double *endLongitudes,
+		double *ellipsoidalDistances, double *azimuths,
+		double *reverseAzimuths, InverseMethod method,
+		double const errorTolerance, int const maxIterations) {
+	double a = ellipsoid.getSemiMajorAxis();
+	double b = ellipsoid.getSemiMinorAxis();
+	double f = ellipsoid.getFlattening();
+
+	const simd::Kernels *kernels =
+			method == Vincenty ? simd::bestKernels() : 0;
+	std::size_t lanes = kernels ? kernels->lanes : 1;
+
+	// canonical copies of one block of pairs, padded to a whole number of lanes
+	double lat1[BatchBlockSize];
+	double lon1[BatchBlockSize];
+	double lat2[BatchBlockSize];
+	double lon2[BatchBlockSize];
+	double s[BatchBlockSize];
+	double alpha1[BatchBlockSize];
+	double alpha2[BatchBlockSize];
+
+	for (std::size_t offset = 0; offset < count; offset += BatchBlockSize) {
+		std::size_t n = std::min(BatchBlockSize, count - offset);
+		for (std::size_t i = 0; i < n; ++i) {
+			lat1[i] = startLatitudes[offset + i];
+			lon1[i] = startLongitudes[offset + i];
+			lat2[i] = endLatitudes[offset + i];
+			lon2[i] = endLongitudes[offset + i];
+		}
+		GlobalCoordinates::canonicalize(n, lat1, lon1);
+		GlobalCoordinates::canonicalize(n, lat2, lon2);
+
+		std::size_t padded = (n + lanes - 1) / lanes * lanes;
+		for (std::size_t i = n; i < padded; ++i) {
+			lat1[i] = lat1[n - 1];
+			lon1[i] = lon1[n - 1];
+			lat2[i] = lat2[n - 1];
+			lon2[i] = lon2[n - 1];
+		}
+
+		if (method == Karney) {
+			for (std::size_t i = 0; i < n; ++i) {
+				karney->solve(lat1[i], lon1[i], lat2[i], lon2[i], s[i],
+						alpha1[i], alpha2[i]);
+			}
+		} else if (method == AndoyerLambert) {
+			for (std::size_t i = 0; i < n; ++i) {
+				ApproximateInverse::andoyerLambert(a, f, lat1[i], lon1[i],
+						lat2[i], lon2[i], s[i], alpha1[i], alpha2[i]);
+			}
+		} else if (method == Haversine) {
+			for (std::size_t i = 0; i < n; ++i) {
+				ApproximateInverse::haversine(a, b, lat1[i], lon1[i], lat2[i],
+						lon2[i], s[i], alpha1[i], alpha2[i]);
+			}
+		} else if (kernels) {
+			kernels->inverse(a, b, f, errorTolerance, maxIterations, padded,
+					lat1, lon1, lat2, lon2, s, alpha1, alpha2);
+		} else {
+			for (std::size_t i = 0; i < n; ++i) {
+				solveInverse(ellipsoid, lat1[i], lon1[i], lat2[i], lon2[i],
+						errorTolerance, maxIterations, s[i], alpha1[i],
+						alpha2[i]);
+			}
+		}
+
+		std::copy(s, s + n, ellipsoidalDistances + offset);
+		if (azimuths) {
+			std::copy(alpha1, alpha1 + n, azimuths + offset);
+		}
+		if (reverseAzimuths) {
+			std::copy(alpha2, alpha2 + n, reverseAzimuths + offset);
+		}
+	}
+}
+
+/**
+ * Write count points of the geodesic of curve from start to end, step meters
+ * apart but for the last one, which is end.
+ */
+static void writeWaypoints(const Ellipsoid &ellipsoid,
+		const GlobalCoordinates &start, const GlobalCoordinates &end,
+		const GeodeticCurveValue &curve, double step, std::size_t count,
+		double *latitudes, double *longitudes, double *bearings,
+		double const errorTolerance, int const maxIterations) {
+	// coincident points, all at the start
+	if (curve.ellipsoidalDistance == 0) {
+		std::fill(latitudes, latitudes + count, start.getLatitude());
+		std::fill(longitudes, longitudes + count, start.getLongitude());
+		if (bearings) {
+			std::fill(bearings, bearings + count, curve.azimuth);
+		}
+		return;
+	}
+	if (isnan(curve.azimuth)) {
+		double nan = numeric_limits<double>::quiet_NaN();
+		std::fill(latitudes, latitudes + count, nan);
+		std::fill(longitudes, longitudes + count, nan);
+		if (bearings) {
+			std::fill(bearings, bearings + count, nan);
+		}
+		return;
+	}
+
+	GeodesicLine line(ellipsoid, start, curve.azimuth);
+	for (std::size_t i = 0; i < count; ++i) {
+		double distance = i + 1 < count ? i * step : curve.ellipsoidalDistance;
+		GeodeticDestinationValue point = line.calculatePosition(distance,
+				errorTolerance, maxIterations);
+		latitudes[i] = point.latitude;
+		longitudes[i] = point.longitude;
+		if (bearings) {
+			bearings[i] = point.endBearing;
+		}
+	}
+
+	// the ends exactly as given
+	latitudes[0] = start.getLatitude();
+	longitudes[0] = start.getLongitude();
+	if (count > 1) {
+		latitudes[count - 1] = end.getLatitude();
+		longitudes[count - 1] = end.getLongitude();
+	}
+}
+
+double GeodeticCalculator::calculateWaypoints(const Ellipsoid &ellipsoid,
+		const GlobalCoordinates &start, const GlobalCoordinates &end,
+		std::size_t count, double *latitudes, double *longitudes,
+		double *bearings, InverseMethod method, double const errorTolerance,
+		int const maxIterations) {
+	GeodeticCurveValue curve = calculateGeodeticCurve(ellipsoid, start, end,
+			method, errorTolerance, maxIterations);
+	if (count > 0) {
+		double step =
+				count > 1 ? curve.ellipsoidalDistance / (count - 1) : 0.0;
+		writeWaypoints(ellipsoid, start, end, curve, step, count, latitudes,
+				longitudes, bearings, errorTolerance, maxIterations);
+	}
+	return curve.ellipsoidalDistance;
+}
+
+std::size_t GeodeticCalculator::calculateWaypointsBySpacing(
+		const Ellipsoid &ellipsoid, const GlobalCoordinates &start,
+		const GlobalCoordinates &end, double spacing, std::size_t maxCount,
+		double *latitudes, double *longitudes, double *bearings,
+		InverseMethod method, double const errorTolerance,
+		int const maxIterations) {
+	if (!(spacing > 0)) {
+		return 0;
+	}
+	GeodeticCurveValue curve = calculateGeodeticCurve(ellipsoid, start, end,
+			method, errorTolerance, maxIterations);
+
+	// the intervals of spacing meters, the last one shorter or equal, plus
+	// the start
+	double intervals = ceil(curve.ellipsoidalDistance / spacing);
+	if (isnan(intervals)) {
+		intervals = 0;
+	}
+	if (!(intervals < maxCount)) {
+		return intervals < numeric_limits<std::size_t>::max() ?
+				static_cast<std::size_t>(intervals) + 1 :
+				numeric_limits<std::size_t>::max();
+	}
+	std::size_t count = static_cast<std::size_t>(intervals) + 1;
+	writeWaypoints(ellipsoid, start, end, curve, spacing, count, latitudes,
+			longitudes, bearings, errorTolerance, maxIterations);
+	return count;
+}
+
+void GeodeticCalculator::reducePosition(double axisRatio,
+		const GlobalPosition &position, ReducedPosition &reduced) {
+	reduced.phi = Angle::toRadians(position.getLatitude());
+	reducePoint(axisRatio, position.getLatitude(), position.getLongitude(),
+			reduced.sinU, reduced.cosU, reduced.lambda);
+	reduced.elevation = position.getElevation();
+}
+
+void GeodeticCalculator::solveReducedMeasurement(
+		const Ellipsoid &refEllipsoid, const ReducedPosition &start,
+		const ReducedPosition &end, double const errorTolerance,
+		int const maxIterations, GeodeticMeasurementValue &measurement) {
 	// calculate elevation differences
-	double elev1 = start.getElevation();
-	double elev2 = end.getElevation();
+	double elev1 = start.elevation;
+	double elev2 = end.elevation;
 	double elev12 = (elev1 + elev2) / 2.0;
 
 	// calculate latitude differences
-	double phi1 = Angle::toRadians(start.getLatitude());
-	double phi2 = Angle::toRadians(end.getLatitude());
-	double phi12 = (phi1 + phi2) / 2.0;
+	double phi12 = (start.phi + end.phi) / 2.0;
+
+	// calculate a new ellipsoid to accommodate average elevation, only its
+	// semi minor axis is needed so there is no need to build an Ellipsoid
+	double f = refEllipsoid.getFlattening();
+	double a = refEllipsoid.getSemiMajorAxis()
+			+ elev12 * (1.0 + f * sin(phi12));
+	double b = refEllipsoid.getAxisRatio() * a;
+
+	// calculate the curve at the average elevation, the reduced latitudes
+	// and the second eccentricity only depend on the flattening which the
+	// new ellipsoid shares
+	solveReducedInverse(b, f, refEllipsoid.getSecondEccentricitySquared(),
+			start.sinU, start.cosU, start.lambda, end.sinU, end.cosU,
+			end.lambda, errorTolerance, maxIterations,
+			measurement.ellipsoidalDistance, measurement.azimuth,
+			measurement.reverseAzimuth);
+
+	// complete the measurement
+	measurement.elevationChange = elev2 - elev1;
+	measurement.pointToPointDistance = sqrt(
+			measurement.ellipsoidalDistance * measurement.ellipsoidalDistance
+					+ measurement.elevationChange
+							* measurement.elevationChange);
+}
+
+void GeodeticCalculator::solveMeasurement(const Ellipsoid &refEllipsoid,
+		const GlobalPosition &start, const GlobalPosition &end,
+		double const errorTolerance, int const maxIterations,
+		GeodeticMeasurementValue &measurement) {
+	double axisRatio = refEllipsoid.getAxisRatio();
+	ReducedPosition reducedStart;
+	ReducedPosition reducedEnd;
+	reducePosition(axisRatio, start, reducedStart);
+	reducePosition(axisRatio, end, reducedEnd);
+	solveReducedMeasurement(refEllipsoid, reducedStart, reducedEnd,
+			errorTolerance, maxIterations, measurement);
+}
 
-	// calculate a new ellipsoid to accommodate average elevation
-	double refA = refEllipsoid->getSemiMajorAxis();
-	double f = refEllipsoid->getFlattening();
-	double a = refA + elev12 * (1.0 + f * sin(phi12));
-	Ellipsoid::ConstPtr ellipsoid = Ellipsoid::fromAAndF(a, f);
+GeodeticMeasurementValue GeodeticCalculator::calculateGeodeticMeasurement(
+		const Ellipsoid &refEllipsoid, const GlobalPosition &start,
+		const GlobalPosition &end) {
+	GeodeticMeasurementValue measurement;
+	solveMeasurement(refEllipsoid, start, end, 1E-13, 20, measurement);
+
+	return measurement;
+}
 
-	// calculate the curve at the average elevation
-	GeodeticCurve::Ptr averageCurve = calculateGeodeticCurve(ellipsoid, start,
-			end);
+void GeodeticCalculator::calculateGeodeticMeasurements(
+		const Ellipsoid &refEllipsoid, std::size_t count,
+		const GlobalPosition *starts, const GlobalPosition *ends,
+		GeodeticMeasurementValue *measurements, double const errorTolerance,
+		int const maxIterations) {
+	for (std::size_t i = 0; i < count; ++i) {
+		solveMeasurement(refEllipsoid, starts[i], ends[i], errorTolerance,
+				maxIterations, measurements[i]);
+	}
+}
+
+GeodeticMeasurement::Ptr GeodeticCalculator::calculateGeodeticMeasurement(
+		const Ellipsoid::ConstPtr &refEllipsoid, const GlobalPosition &start,
+		const GlobalPosition &end) {
+	GeodeticMeasurementValue measurement = calculateGeodeticMeasurement(
+			*refEllipsoid, start, end);
 
-	// return the measurement
 	return GeodeticMeasurement::Ptr(
-			new GeodeticMeasurement(*averageCurve, elev2 - elev1));
+			new GeodeticMeasurement(measurement.ellipsoidalDistance,
+					measurement.azimuth, measurement.reverseAzimuth,
+					measurement.elevationChange));
 }
 
 } // geodesy
@@ -30,6 +30,7 @@
 #define GEODESY_GEODETIC_CALCULATOR
 
 #include <cmath>
+#include <cstddef>
 #include <tr1/memory>
 #include <exception>
 
@@ -45,6 +46,11 @@
  */
 namespace geodesy {
 
+template<class Tag>
+class GeodeticCalculatorT;
+
+class KarneyInverse;
+
 /**
  * Thrown when azimuth is NaN.
  */
@@ -62,6 +68,20 @@ public:
 	}
 };
 
+/**
+ * Outcome of the direct geodetic problem as a plain, trivially copyable value.
+ */
+struct GeodeticDestinationValue {
+	/** Latitude of the destination in degrees (canonical). */
+	double latitude;
+
+	/** Longitude of the destination in degrees (canonical). */
+	double longitude;
+
+	/** Bearing at the destination in degrees. */
+	double endBearing;
+};
+
 /**
  * <p>
  * Implementation of Thaddeus Vincenty's algorithms to solve the direct and
@@ -69,6 +89,11 @@ public:
  * publication on the NOAA website:
  * </p>
  * See http://www.ngs.noaa.gov/PUBS_LIB/inverse.pdf
+ * <p>
+ * The ellipsoid is passed by reference, as an Ellipsoid or as its
+ * Ellipsoid::ConstPtr, and no call copies the pointer: threads sharing an
+ * ellipsoid never write to its reference count.
+ * </p>
  *
  */
 class GeodeticCalculator {
@@ -76,6 +101,42 @@ public:
 	typedef std::tr1::shared_ptr<GeodeticCalculator> Ptr;
 	typedef std::tr1::shared_ptr<GeodeticCalculator const> ConstPtr;
 
+	/**
+	 * The algorithm used to solve the inverse problem, from the most accurate
+	 * and expensive to the cheapest. The closed form approximations are
+	 * described in ApproximateInverse.
+	 */
+	enum InverseMethod {
+		/**
+		 * Vincenty's iteration on lambda. Fast, but for nearly antipodal points
+		 * it may not converge, in which case the azimuths are replaced by a due
+		 * north or south guess and the distance is wrong.
+		 */
+		Vincenty,
+
+		/**
+		 * Karney's method, see KarneyInverse. Converges for every pair of
+		 * points in a bounded number of steps; errorTolerance and
+		 * maxIterations don't apply.
+		 */
+		Karney,
+
+		/**
+		 * Lambert's formula for long lines, a single pass with no iteration.
+		 * The distance is within 1.4 m per 1000 km up to 10000 km and 500 m
+		 * up to 19000 km, the azimuths within 0.2 degrees up to 10000 km.
+		 * errorTolerance and maxIterations don't apply.
+		 */
+		AndoyerLambert,
+
+		/**
+		 * The haversine formula on a sphere of the mean radius, the cheapest.
+		 * The distance is within 0.56% and the azimuths within 0.2 degrees up
+		 * to 10000 km. errorTolerance and maxIterations don't apply.
+		 */
+		Haversine
+	};
+
 	virtual ~GeodeticCalculator();
 
 	/**
@@ -93,12 +154,92 @@ public:
 	 * @return the ending location
 	 */
 	static GlobalCoordinates::Ptr
-	calculateEndingGlobalCoordinates(Ellipsoid::ConstPtr ellipsoid,
+	calculateEndingGlobalCoordinates(const Ellipsoid::ConstPtr &ellipsoid,
 			const GlobalCoordinates &start, double startBearing,
 			double distance, double &endBearing, double const errorTolerance =
 					1E-13, int const maxIterations = 20)
 					throw (InvalidAzimuthException);
 
+	/**
+	 * Same as calculateEndingGlobalCoordinates() above, but returns the
+	 * destination and final bearing by value and allocates nothing.
+	 *
+	 * @param ellipsoid reference ellipsoid to use
+	 * @param start starting location
+	 * @param startBearing starting bearing (degrees)
+	 * @param distance distance to travel (meters)
+	 * @param errorTolerance once the change in sigma reaches this value, stop iterating
+	 * @param maxIterations maximum number of iterations, even if the error tolerance is not met
+	 * @return the ending location and bearing
+	 */
+	static GeodeticDestinationValue
+	calculateEndingGlobalCoordinates(const Ellipsoid &ellipsoid,
+			const GlobalCoordinates &start, double startBearing,
+			double distance, double const errorTolerance = 1E-13,
+			int const maxIterations = 20) throw (InvalidAzimuthException);
+
+	/**
+	 * Calculate the destinations and final bearings of many direct problems.
+	 * This is the batch form of calculateEndingGlobalCoordinates() for
+	 * structure-of-arrays input: problem i starts at (startLatitudes[i],
+	 * startLongitudes[i]) and travels distances[i] meters on a starting bearing
+	 * of startBearings[i]. The ending coordinates are canonicalized the same way
+	 * GlobalCoordinates does, and the results are written to caller-owned
+	 * arrays. No memory is allocated.
+	 *
+	 * When the processor supports it the problems are solved several at a time
+	 * with SIMD instructions (see VincentySimd.hpp).
+	 *
+	 * @param ellipsoid reference ellipsoid to use
+	 * @param count number of problems
+	 * @param startLatitudes starting latitudes (degrees)
+	 * @param startLongitudes starting longitudes (degrees)
+	 * @param startBearings starting bearings (degrees)
+	 * @param distances distances to travel (meters)
+	 * @param endLatitudes ending latitudes in degrees (output array)
+	 * @param endLongitudes ending longitudes in degrees (output array)
+	 * @param endBearings bearings at destination in degrees (output array, may
+	 *          be NULL)
+	 * @param errorTolerance once the change in sigma reaches this value, stop iterating
+	 * @param maxIterations maximum number of iterations, even if the error tolerance is not met
+	 * @throws InvalidAzimuthException if a starting bearing is NaN, results
+	 *           for the blocks before it may already have been written
+	 */
+	static void calculateEndingGlobalCoordinates(
+			const Ellipsoid::ConstPtr &ellipsoid, std::size_t count,
+			const double *startLatitudes, const double *startLongitudes,
+			const double *startBearings, const double *distances,
+			double *endLatitudes, double *endLongitudes, double *endBearings,
+			double const errorTolerance = 1E-13, int const maxIterations = 20)
+					throw (InvalidAzimuthException);
+
+	/**
+	 * Same as calculateEndingGlobalCoordinates() above, but takes the
+	 * ellipsoid by reference, for callers that keep it alive themselves.
+	 *
+	 * @param ellipsoid reference ellipsoid to use
+	 * @param count number of problems
+	 * @param startLatitudes starting latitudes (degrees)
+	 * @param startLongitudes starting longitudes (degrees)
+	 * @param startBearings starting bearings (degrees)
+	 * @param distances distances to travel (meters)
+	 * @param endLatitudes ending latitudes in degrees (output array)
+	 * @param endLongitudes ending longitudes in degrees (output array)
+	 * @param endBearings bearings at destination in degrees (output array, may
+	 *          be NULL)
+	 * @param errorTolerance once the change in sigma reaches this value, stop iterating
+	 * @param maxIterations maximum number of iterations, even if the error tolerance is not met
+	 * @throws InvalidAzimuthException if a starting bearing is NaN, results
+	 *           for the blocks before it may already have been written
+	 */
+	static void calculateEndingGlobalCoordinates(const Ellipsoid &ellipsoid,
+			std::size_t count, const double *startLatitudes,
+			const double *startLongitudes, const double *startBearings,
+			const double *distances, double *endLatitudes,
+			double *endLongitudes, double *endBearings,
+			double const errorTolerance = 1E-13, int const maxIterations = 20)
+					throw (InvalidAzimuthException);
+
 	/**
 	 * Calculate the geodetic curve between two points on a specified reference
 	 * ellipsoid. This is the solution to the inverse geodetic problem.
@@ -111,8 +252,220 @@ public:
 	 * @return the curve
 	 */
 	static GeodeticCurve::Ptr calculateGeodeticCurve(
-			Ellipsoid::ConstPtr ellipsoid, const GlobalCoordinates &start,
-			const GlobalCoordinates &end, double const errorTolerance = 1E-13,
+			const Ellipsoid::ConstPtr &ellipsoid,
+			const GlobalCoordinates &start, const GlobalCoordinates &end,
+			double const errorTolerance = 1E-13, int const maxIterations = 20);
+
+	/**
+	 * Same as calculateGeodeticCurve() above, but returns the curve by value and
+	 * allocates nothing.
+	 *
+	 * @param ellipsoid reference ellipsoid to use
+	 * @param start starting coordinates
+	 * @param end ending coordinates
+	 * @param errorTolerance once the change in lambda reaches this value, stop iterating
+	 * @param maxIterations maximum number of iterations, even if the error tolerance is not met
+	 * @return the curve
+	 */
+	static GeodeticCurveValue calculateGeodeticCurve(const Ellipsoid &ellipsoid,
+			const GlobalCoordinates &start, const GlobalCoordinates &end,
+			double const errorTolerance = 1E-13, int const maxIterations = 20);
+
+	/**
+	 * Same as calculateGeodeticCurve() above with a choice of algorithm.
+	 *
+	 * @param ellipsoid reference ellipsoid to use
+	 * @param start starting coordinates
+	 * @param end ending coordinates
+	 * @param method the algorithm
+	 * @param errorTolerance once the change in lambda reaches this value, stop iterating
+	 * @param maxIterations maximum number of iterations, even if the error tolerance is not met
+	 * @return the curve
+	 */
+	static GeodeticCurveValue calculateGeodeticCurve(const Ellipsoid &ellipsoid,
+			const GlobalCoordinates &start, const GlobalCoordinates &end,
+			InverseMethod method, double const errorTolerance = 1E-13,
+			int const maxIterations = 20);
+
+	/**
+	 * Same as calculateGeodeticCurve() above with a choice of algorithm.
+	 *
+	 * @param ellipsoid reference ellipsoid to use
+	 * @param start starting coordinates
+	 * @param end ending coordinates
+	 * @param method the algorithm
+	 * @param errorTolerance once the change in lambda reaches this value, stop iterating
+	 * @param maxIterations maximum number of iterations, even if the error tolerance is not met
+	 * @return the curve
+	 */
+	static GeodeticCurve::Ptr calculateGeodeticCurve(
+			const Ellipsoid::ConstPtr &ellipsoid,
+			const GlobalCoordinates &start, const GlobalCoordinates &end,
+			InverseMethod method, double const errorTolerance = 1E-13,
+			int const maxIterations = 20);
+
+	/**
+	 * Calculate the geodetic curves between many pairs of points on a specified
+	 * reference ellipsoid. This is the batch form of calculateGeodeticCurve()
+	 * for structure-of-arrays input: pair i runs from (startLatitudes[i],
+	 * startLongitudes[i]) to (endLatitudes[i], endLongitudes[i]). The angles are
+	 * canonicalized the same way GlobalCoordinates does, and the results are
+	 * written to caller-owned arrays. No memory is allocated.
+	 *
+	 * When the processor supports it the pairs are solved several at a time
+	 * with SIMD instructions (see VincentySimd.hpp). The results then agree
+	 * with calculateGeodeticCurve() to well under a micrometer and 1e-9
+	 * degrees rather than bit for bit.
+	 *
+	 * @param ellipsoid reference ellipsoid to use
+	 * @param count number of pairs
+	 * @param startLatitudes starting latitudes (degrees)
+	 * @param startLongitudes starting longitudes (degrees)
+	 * @param endLatitudes ending latitudes (degrees)
+	 * @param endLongitudes ending longitudes (degrees)
+	 * @param ellipsoidalDistances ellipsoidal distances in meters (output array)
+	 * @param azimuths azimuths in degrees (output array, may be NULL)
+	 * @param reverseAzimuths reverse azimuths in degrees (output array, may be
+	 *          NULL)
+	 * @param errorTolerance once the change in lambda reaches this value, stop iterating
+	 * @param maxIterations maximum number of iterations, even if the error tolerance is not met
+	 */
+	static void calculateGeodeticCurves(const Ellipsoid::ConstPtr &ellipsoid,
+			std::size_t count, const double *startLatitudes,
+			const double *startLongitudes, const double *endLatitudes,
+			const double *endLongitudes, double *ellipsoidalDistances,
+			double *azimuths, double *reverseAzimuths,
+			double const errorTolerance = 1E-13, int const maxIterations = 20);
+
+	/**
+	 * Same as calculateGeodeticCurves() above, but takes the ellipsoid by
+	 * reference, for callers that keep it alive themselves.
+	 *
+	 * @param ellipsoid reference ellipsoid to use
+	 * @param count number of pairs
+	 * @param startLatitudes starting latitudes (degrees)
+	 * @param startLongitudes starting longitudes (degrees)
+	 * @param endLatitudes ending latitudes (degrees)
+	 * @param endLongitudes ending longitudes (degrees)
+	 * @param ellipsoidalDistances ellipsoidal distances in meters (output array)
+	 * @param azimuths azimuths in degrees (output array, may be NULL)
+	 * @param reverseAzimuths reverse azimuths in degrees (output array, may be
+	 *          NULL)
+	 * @param errorTolerance once the change in lambda reaches this value, stop iterating
+	 * @param maxIterations maximum number of iterations, even if the error tolerance is not met
+	 */
+	static void calculateGeodeticCurves(const Ellipsoid &ellipsoid,
+			std::size_t count, const double *startLatitudes,
+			const double *startLongitudes, const double *endLatitudes,
+			const double *endLongitudes, double *ellipsoidalDistances,
+			double *azimuths, double *reverseAzimuths,
+			double const errorTolerance = 1E-13, int const maxIterations = 20);
+
+	/**
+	 * Same as calculateGeodeticCurves() above with a choice of algorithm. The
+	 * SIMD kernels only implement Vincenty's method, the other methods are
+	 * solved one pair at a time.
+	 *
+	 * @param ellipsoid reference ellipsoid to use
+	 * @param count number of pairs
+	 * @param startLatitudes starting latitudes (degrees)
+	 * @param startLongitudes starting longitudes (degrees)
+	 * @param endLatitudes ending latitudes (degrees)
+	 * @param endLongitudes ending longitudes (degrees)
+	 * @param ellipsoidalDistances ellipsoidal distances in meters (output array)
+	 * @param azimuths azimuths in degrees (output array, may be NULL)
+	 * @param reverseAzimuths reverse azimuths in degrees (output array, may be
+	 *          NULL)
+	 * @param method the algorithm
+	 * @param errorTolerance once the change in lambda reaches this value, stop iterating
+	 * @param maxIterations maximum number of iterations, even if the error tolerance is not met
+	 */
+	static void calculateGeodeticCurves(const Ellipsoid::ConstPtr &ellipsoid,
+			std::size_t count, const double *startLatitudes,
+			const double *startLongitudes, const double *endLatitudes,
+			const double *endLongitudes, double *ellipsoidalDistances,
+			double *azimuths, double *reverseAzimuths, InverseMethod method,
+			double const errorTolerance = 1E-13, int const maxIterations = 20);
+
+	/**
+	 * Same as calculateGeodeticCurves() above, but takes the ellipsoid by
+	 * reference, for callers that keep it alive themselves.
+	 *
+	 * @param ellipsoid reference ellipsoid to use
+	 * @param count number of pairs
+	 * @param startLatitudes starting latitudes (degrees)
+	 * @param startLongitudes starting longitudes (degrees)
+	 * @param endLatitudes ending latitudes (degrees)
+	 * @param endLongitudes ending longitudes (degrees)
+	 * @param ellipsoidalDistances ellipsoidal distances in meters (output array)
+	 * @param azimuths azimuths in degrees (output array, may be NULL)
+	 * @param reverseAzimuths reverse azimuths in degrees (output array, may be
+	 *          NULL)
+	 * @param method the algorithm
+	 * @param errorTolerance once the change in lambda reaches this value, stop iterating
+	 * @param maxIterations maximum number of iterations, even if the error tolerance is not met
+	 */
+	static void calculateGeodeticCurves(const Ellipsoid &ellipsoid,
+			std::size_t count, const double *startLatitudes,
+			const double *startLongitudes, const double *endLatitudes,
+			const double *endLongitudes, double *ellipsoidalDistances,
+			double *azimuths, double *reverseAzimuths, InverseMethod method,
+			double const errorTolerance = 1E-13, int const maxIterations = 20);
+
+	/**
+	 * Calculate count points evenly spaced along the geodesic from start to
+	 * end: point i is i / (count - 1) of the way, so the first point is start
+	 * and the last is end. The inverse problem is solved once and the points
+	 * are positions along a single GeodesicLine, written to caller-owned
+	 * arrays. No memory is allocated.
+	 *
+	 * @param ellipsoid reference ellipsoid to use
+	 * @param start starting coordinates
+	 * @param end ending coordinates
+	 * @param count number of points, 1 gives start alone
+	 * @param latitudes latitudes in degrees (output array)
+	 * @param longitudes longitudes in degrees (output array)
+	 * @param bearings bearings of the geodesic at the points in degrees
+	 *          (output array, may be NULL)
+	 * @param method the algorithm of the inverse problem, which sets how
+	 *          closely the points follow the geodesic; Karney for nearly
+	 *          antipodal points
+	 * @param errorTolerance once the change in lambda or sigma reaches this value, stop iterating
+	 * @param maxIterations maximum number of iterations, even if the error tolerance is not met
+	 * @return the ellipsoidal distance from start to end (meters)
+	 */
+	static double calculateWaypoints(const Ellipsoid &ellipsoid,
+			const GlobalCoordinates &start, const GlobalCoordinates &end,
+			std::size_t count, double *latitudes, double *longitudes,
+			double *bearings = 0, InverseMethod method = Vincenty,
+			double const errorTolerance = 1E-13, int const maxIterations = 20);
+
+	/**
+	 * Calculate points every spacing meters along the geodesic from start to
+	 * end, starting at start and followed by end, so that only the last
+	 * interval may be shorter. Like calculateWaypoints() the inverse problem
+	 * is solved once and no memory is allocated.
+	 *
+	 * @param ellipsoid reference ellipsoid to use
+	 * @param start starting coordinates
+	 * @param end ending coordinates
+	 * @param spacing distance between the points (meters, positive)
+	 * @param maxCount size of the output arrays
+	 * @param latitudes latitudes in degrees (output array)
+	 * @param longitudes longitudes in degrees (output array)
+	 * @param bearings bearings of the geodesic at the points in degrees
+	 *          (output array, may be NULL)
+	 * @param method the algorithm of the inverse problem
+	 * @param errorTolerance once the change in lambda or sigma reaches this value, stop iterating
+	 * @param maxIterations maximum number of iterations, even if the error tolerance is not met
+	 * @return the number of points of the geodesic, which are only written if
+	 *         that is at most maxCount, or 0 if spacing isn't positive
+	 */
+	static std::size_t calculateWaypointsBySpacing(const Ellipsoid &ellipsoid,
+			const GlobalCoordinates &start, const GlobalCoordinates &end,
+			double spacing, std::size_t maxCount, double *latitudes,
+			double *longitudes, double *bearings = 0, InverseMethod method =
+					Vincenty, double const errorTolerance = 1E-13,
 			int const maxIterations = 20);
 
 	/**
@@ -136,14 +489,150 @@ public:
 	 * @return the measurement
 	 */
 	static GeodeticMeasurement::Ptr
-	calculateGeodeticMeasurement(Ellipsoid::ConstPtr refEllipsoid,
+	calculateGeodeticMeasurement(const Ellipsoid::ConstPtr &refEllipsoid,
 			const GlobalPosition &start, const GlobalPosition &end);
 
+	/**
+	 * Same as calculateGeodeticMeasurement() above, but returns the measurement
+	 * by value. The elevation adjusted ellipsoid is never built, only its axes
+	 * are computed, so nothing is allocated.
+	 *
+	 * @param refEllipsoid reference ellipsoid to use
+	 * @param start starting position
+	 * @param end ending position
+	 * @return the measurement
+	 */
+	static GeodeticMeasurementValue
+	calculateGeodeticMeasurement(const Ellipsoid &refEllipsoid,
+			const GlobalPosition &start, const GlobalPosition &end);
+
+	/**
+	 * Calculate the three dimensional geodetic measurements between pairs of
+	 * positions, as calculateGeodeticMeasurement() does for one pair. The
+	 * elevation adjusted axes are derived for every pair from the reference
+	 * ellipsoid and nothing is allocated, so the results are bit for bit those
+	 * of calculateGeodeticMeasurement() with the same tolerance.
+	 *
+	 * @param refEllipsoid reference ellipsoid to use
+	 * @param count number of pairs
+	 * @param starts starting positions
+	 * @param ends ending positions
+	 * @param measurements the measurements (output array)
+	 * @param errorTolerance once the change in lambda reaches this value, stop iterating
+	 * @param maxIterations maximum number of iterations, even if the error tolerance is not met
+	 */
+	static void calculateGeodeticMeasurements(const Ellipsoid &refEllipsoid,
+			std::size_t count, const GlobalPosition *starts,
+			const GlobalPosition *ends, GeodeticMeasurementValue *measurements,
+			double const errorTolerance = 1E-13, int const maxIterations = 20);
+
 private:
+	friend class DistanceMatrix;
+	friend class TrackAccumulator;
+	template<class Tag>
+	friend class GeodeticCalculatorT;
+
+	/**
+	 * The terms of a canonical position that the measurements it takes part
+	 * in depend on, see reducePosition().
+	 */
+	struct ReducedPosition {
+		/** Latitude (radians). */
+		double phi;
+		double sinU;
+		double cosU;
+		/** Longitude (radians). */
+		double lambda;
+		/** Elevation (meters). */
+		double elevation;
+	};
+
 	// no instances
 	GeodeticCalculator() {
 	}
 
+	/**
+	 * Compute the sine and cosine of the reduced latitude and the longitude in
+	 * radians of a canonical point, the terms of the inverse problem that
+	 * depend on one point only, for an ellipsoid whose axis ratio b / a is
+	 * axisRatio.
+	 */
+	static void reducePoint(double axisRatio, double latitude,
+			double longitude, double &sinU, double &cosU, double &lambda);
+
+	/**
+	 * Solve the inverse problem for one pair of canonical coordinates. This is
+	 * shared by the single and batch entry points so that neither needs to
+	 * build objects to get at the math.
+	 */
+	static void solveInverse(const Ellipsoid &ellipsoid, double startLatitude,
+			double startLongitude, double endLatitude, double endLongitude,
+			double const errorTolerance, int const maxIterations, double &s,
+			double &alpha1, double &alpha2);
+
+	/**
+	 * The batch inverse problem behind calculateGeodeticCurves(), karney is
+	 * only used, and only needs to be built, for Karney's method.
+	 */
+	static void solveCurves(const Ellipsoid &ellipsoid,
+			const KarneyInverse *karney, std::size_t count,
+			const double *startLatitudes, const double *startLongitudes,
+			const double *endLatitudes, const double *endLongitudes,
+			double *ellipsoidalDistances, double *azimuths,
+			double *reverseAzimuths, InverseMethod method,
+			double const errorTolerance, int const maxIterations);
+
+	/**
+	 * solveInverse() on the ellipsoid described by its axis ratio, b, f and
+	 * the square of its second eccentricity, timed as a single problem. The
+	 * timer is here rather than in GeodeticCalculatorT, so that timing
+	 * depends on how the library was built and not on the defines of its
+	 * users.
+	 */
+	static void solveTimedInverse(double axisRatio, double b, double f,
+			double secondEccentricitySquared, double startLatitude,
+			double startLongitude, double endLatitude, double endLongitude,
+			double const errorTolerance, int const maxIterations, double &s,
+			double &alpha1, double &alpha2);
+
+	/**
+	 * Solve the inverse problem between two points given by reducePoint() on
+	 * the ellipsoid described by b, f and the square of its second
+	 * eccentricity.
+	 */
+	static void solveReducedInverse(double b, double f,
+			double secondEccentricitySquared, double sinU1, double cosU1,
+			double lambda1, double sinU2, double cosU2, double lambda2,
+			double const errorTolerance, int const maxIterations, double &s,
+			double &alpha1, double &alpha2);
+
+	/**
+	 * Compute the terms of a position for an ellipsoid whose axis ratio b / a
+	 * is axisRatio. They don't depend on the semi major axis, so they hold
+	 * whatever elevation the ellipsoid is adjusted to for a measurement.
+	 */
+	static void reducePosition(double axisRatio, const GlobalPosition &position,
+			ReducedPosition &reduced);
+
+	/**
+	 * Measure between two positions given by reducePosition() on the
+	 * reference ellipsoid adjusted to their mean elevation. The adjusted
+	 * ellipsoid has the same flattening, so it shares every derived constant
+	 * but the axes with the reference.
+	 */
+	static void solveReducedMeasurement(const Ellipsoid &refEllipsoid,
+			const ReducedPosition &start, const ReducedPosition &end,
+			double const errorTolerance, int const maxIterations,
+			GeodeticMeasurementValue &measurement);
+
+	/**
+	 * Measure between two positions, see solveReducedMeasurement().
+	 */
+	static void solveMeasurement(const Ellipsoid &refEllipsoid,
+			const GlobalPosition &start, const GlobalPosition &end,
+			double const errorTolerance, int const maxIterations,
+			GeodeticMeasurementValue &measurement);
+
 };
 
 } // geodesy
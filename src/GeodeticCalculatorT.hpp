@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#ifndef GEODETICCALCULATORT_HPP_
+#define GEODETICCALCULATORT_HPP_
+
+#include "Ellipsoid.hpp"
+#include "GeodesicLine.hpp"
+#include "GeodeticCalculator.hpp"
+#include "GeodeticCurve.hpp"
+#include "GeodeticMeasurement.hpp"
+#include "GlobalCoordinates.hpp"
+#include "GlobalPosition.hpp"
+
+namespace geodesy {
+
+/**
+ * Tags naming the common reference ellipsoids for GeodeticCalculatorT. A tag
+ * gives the semi major axis (meters) and the flattening of its ellipsoid as
+ * inline functions of constants, so that they are known where they are used.
+ * Any class with the same two functions can serve as a tag.
+ */
+struct WGS84Tag {
+	static double semiMajorAxis() {
+		return 6378137.0;
+	}
+	static double flattening() {
+		return 1.0 / 298.257223563;
+	}
+};
+
+struct GRS80Tag {
+	static double semiMajorAxis() {
+		return 6378137.0;
+	}
+	static double flattening() {
+		return 1.0 / 298.257222101;
+	}
+};
+
+struct GRS67Tag {
+	static double semiMajorAxis() {
+		return 6378160.0;
+	}
+	static double flattening() {
+		return 1.0 / 298.25;
+	}
+};
+
+struct WGS72Tag {
+	static double semiMajorAxis() {
+		return 6378135.0;
+	}
+	static double flattening() {
+		return 1.0 / 298.26;
+	}
+};
+
+struct Clarke1858Tag {
+	static double semiMajorAxis() {
+		return 6378293.645;
+	}
+	static double flattening() {
+		return 1.0 / 294.26;
+	}
+};
+
+struct Clarke1880Tag {
+	static double semiMajorAxis() {
+		return 6378249.145;
+	}
+	static double flattening() {
+		return 1.0 / 293.465;
+	}
+};
+
+struct SphereTag {
+	static double semiMajorAxis() {
+		return 6371000.0;
+	}
+	static double flattening() {
+		return 0.0;
+	}
+};
+
+/**
+ * <p>
+ * GeodeticCalculator for an ellipsoid fixed at compile time by a tag, for
+ * callers that only ever use one. The methods take no ellipsoid, so there is
+ * no Ellipsoid::ConstPtr to copy. calculateGeodeticCurve() doesn't read an
+ * Ellipsoid at all: it derives the constants from the tag with the same
+ * expressions Ellipsoid uses, in the caller, where the compiler folds them.
+ * The other methods hand getEllipsoid() to GeodeticCalculator by reference.
+ * The results are bit for bit those of GeodeticCalculator with
+ * getEllipsoid().
+ * </p>
+ * <p>
+ * Only Vincenty's method is offered. getEllipsoid() gives the shared
+ * Ellipsoid of the tag for everything else.
+ * </p>
+ */
+template<class Tag>
+class GeodeticCalculatorT {
+public:
+	/**
+	 * Get the ellipsoid of the tag, the instance Ellipsoid::intern() shares.
+	 * @return
+	 */
+	static const Ellipsoid &getEllipsoid() {
+		static Ellipsoid::ConstPtr ellipsoid = Ellipsoid::intern(
+				Tag::semiMajorAxis(), Tag::flattening());
+		return *ellipsoid;
+	}
+
+	/**
+	 * Same as GeodeticCalculator::calculateGeodeticCurve() on getEllipsoid().
+	 *
+	 * @param start starting coordinates
+	 * @param end ending coordinates
+	 * @param errorTolerance once the change in lambda reaches this value, stop iterating
+	 * @param maxIterations maximum number of iterations, even if the error tolerance is not met
+	 * @return the geodetic curve
+	 */
+	static GeodeticCurveValue calculateGeodeticCurve(
+			const GlobalCoordinates &start, const GlobalCoordinates &end,
+			double const errorTolerance = 1E-13, int const maxIterations = 20) {
+		GeodeticCurveValue curve;
+		GeodeticCalculator::solveTimedInverse(axisRatio(), semiMinorAxis(),
+				Tag::flattening(), secondEccentricitySquared(),
+				start.getLatitude(), start.getLongitude(), end.getLatitude(),
+				end.getLongitude(), errorTolerance, maxIterations,
+				curve.ellipsoidalDistance, curve.azimuth, curve.reverseAzimuth);
+		return curve;
+	}
+
+	/**
+	 * Same as GeodeticCalculator::calculateEndingGlobalCoordinates() on
+	 * getEllipsoid().
+	 *
+	 * @param start starting location
+	 * @param startBearing starting bearing (degrees)
+	 * @param distance distance to travel (meters)
+	 * @param errorTolerance once the change in sigma reaches this value, stop iterating
+	 * @param maxIterations maximum number of iterations, even if the error tolerance is not met
+	 * @return the ending location and bearing
+	 */
+	static GeodeticDestinationValue calculateEndingGlobalCoordinates(
+			const GlobalCoordinates &start, double startBearing,
+			double distance, double const errorTolerance = 1E-13,
+			int const maxIterations = 20) throw (InvalidAzimuthException) {
+		return GeodeticCalculator::calculateEndingGlobalCoordinates(
+				getEllipsoid(), start, startBearing, distance, errorTolerance,
+				maxIterations);
+	}
+
+	/**
+	 * Same as GeodeticCalculator::calculateGeodeticMeasurement() on
+	 * getEllipsoid().
+	 *
+	 * @param start starting position
+	 * @param end ending position
+	 * @return the measurement
+	 */
+	static GeodeticMeasurementValue calculateGeodeticMeasurement(
+			const GlobalPosition &start, const GlobalPosition &end) {
+		return GeodeticCalculator::calculateGeodeticMeasurement(
+				getEllipsoid(), start, end);
+	}
+
+private:
+	// no instances
+	GeodeticCalculatorT() {
+	}
+
+	static double axisRatio() {
+		return 1.0 - Tag::flattening();
+	}
+
+	static double semiMinorAxis() {
+		return axisRatio() * Tag::semiMajorAxis();
+	}
+
+	static double secondEccentricitySquared() {
+		double a2 = Tag::semiMajorAxis() * Tag::semiMajorAxis();
+		double b2 = semiMinorAxis() * semiMinorAxis();
+		return (a2 - b2) / b2;
+	}
+
+};
+
+/** The calculator most callers want. */
+typedef GeodeticCalculatorT<WGS84Tag> WGS84Calculator;
+
+}
+
+#endif /* GEODETICCALCULATORT_HPP_ */
@@ -34,6 +34,21 @@
 
 namespace geodesy {
 
+/**
+ * Plain value form of a GeodeticCurve, trivially copyable so that it can be
+ * returned by value and stored in arrays without any allocation.
+ */
+struct GeodeticCurveValue {
+	/** Ellipsoidal distance (in meters). */
+	double ellipsoidalDistance;
+
+	/** Azimuth (degrees from north). */
+	double azimuth;
+
+	/** Reverse azimuth (degrees from north). */
+	double reverseAzimuth;
+};
+
 /**
  * This is the outcome of a geodetic calculation. It represents the path and
  * ellipsoidal distance between two GlobalCoordinates for a specified reference
@@ -35,6 +35,30 @@
 
 namespace geodesy {
 
+/**
+ * Plain value form of a GeodeticMeasurement, trivially copyable so that it can
+ * be returned by value and stored in arrays without any allocation.
+ */
+struct GeodeticMeasurementValue {
+	/** Ellipsoidal distance (in meters). */
+	double ellipsoidalDistance;
+
+	/** Azimuth (degrees from north). */
+	double azimuth;
+
+	/** Reverse azimuth (degrees from north). */
+	double reverseAzimuth;
+
+	/**
+	 * The elevation change, in meters, going from the starting to the ending
+	 * point.
+	 */
+	double elevationChange;
+
+	/** The distance traveled, in meters, going from one point to the next. */
+	double pointToPointDistance;
+};
+
 /**
  * A geodetic measurement.
  */
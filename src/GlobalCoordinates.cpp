@@ -39,30 +39,68 @@ GlobalCoordinates::~GlobalCoordinates() {
 }
 
 void GlobalCoordinates::canonicalize() {
-	mLatitude = fmod((mLatitude + 180), 360);
-	if (mLatitude < 0) {
-		mLatitude += 360;
+	canonicalize(mLatitude, mLongitude);
+}
+
+void GlobalCoordinates::canonicalize(double &latitude, double &longitude) {
+	if (isCanonical(latitude, longitude)) {
+		return;
+	}
+
+	latitude = fmod((latitude + 180), 360);
+	if (latitude < 0) {
+		latitude += 360;
 	}
-	mLatitude -= 180;
-
-	if (mLatitude > 90) {
-		mLatitude = 180 - mLatitude;
-		mLongitude += 180;
-	} else if (mLatitude < -90) {
-		mLatitude = -180 - mLatitude;
-		mLongitude += 180;
+	latitude -= 180;
+
+	if (latitude > 90) {
+		latitude = 180 - latitude;
+		longitude += 180;
+	} else if (latitude < -90) {
+		latitude = -180 - latitude;
+		longitude += 180;
 	}
 
-	mLongitude = fmod((mLongitude + 180), 360);
-	if (mLongitude <= 0) {
-		mLongitude += 360;
+	longitude = fmod((longitude + 180), 360);
+	if (longitude <= 0) {
+		longitude += 360;
 	}
-	mLongitude -= 180;
+	longitude -= 180;
 }
 
-GlobalCoordinates::GlobalCoordinates(double latitude, double longitude) :
+void GlobalCoordinates::canonicalize(std::size_t count, double *latitudes,
+		double *longitudes) {
+	canonicalize(count, latitudes, longitudes, 1);
+}
+
+void GlobalCoordinates::canonicalize(std::size_t count, double *latitudes,
+		double *longitudes, std::size_t stride) {
+	const std::size_t Block = 8;
+
+	std::size_t i = 0;
+	for (; i + Block <= count; i += Block) {
+		bool canonical = true;
+		for (std::size_t j = i; j < i + Block; ++j) {
+			canonical &= isCanonical(latitudes[j * stride],
+					longitudes[j * stride]);
+		}
+		if (!canonical) {
+			for (std::size_t j = i; j < i + Block; ++j) {
+				canonicalize(latitudes[j * stride], longitudes[j * stride]);
+			}
+		}
+	}
+	for (; i < count; ++i) {
+		canonicalize(latitudes[i * stride], longitudes[i * stride]);
+	}
+}
+
+GlobalCoordinates::GlobalCoordinates(double latitude, double longitude,
+		Canonicalization canonicalization) :
 		mLatitude(latitude), mLongitude(longitude) {
-	canonicalize();
+	if (canonicalization == Canonicalize) {
+		canonicalize();
+	}
 }
 
 double GlobalCoordinates::getLatitude() const {
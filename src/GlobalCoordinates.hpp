@@ -29,6 +29,7 @@
 #ifndef GLOBALCOORDINATES_HPP_
 #define GLOBALCOORDINATES_HPP_
 
+#include <cstddef>
 #include <ostream>
 #include <tr1/memory>
 
@@ -54,15 +55,32 @@ public:
 	typedef std::tr1::shared_ptr<GlobalCoordinates> Ptr;
 	typedef std::tr1::shared_ptr<GlobalCoordinates const> ConstPtr;
 
+	/**
+	 * Whether a constructor canonicalizes the angles it is given.
+	 */
+	enum Canonicalization {
+		/** Canonicalize the angles. */
+		Canonicalize,
+		/**
+		 * Store the angles as they are. The caller guarantees they are already
+		 * canonical, for example because they came from another
+		 * GlobalCoordinates or from the batch methods of GeodeticCalculator.
+		 */
+		AssumeCanonical
+	};
+
 	virtual ~GlobalCoordinates();
 
 	/**
-	 * Construct a new GlobalCoordinates. Angles will be canonicalized.
+	 * Construct a new GlobalCoordinates. Angles will be canonicalized unless
+	 * the caller passes AssumeCanonical.
 	 *
 	 * @param latitude latitude in degrees
 	 * @param longitude longitude in degrees
+	 * @param canonicalization whether to canonicalize the angles
 	 */
-	GlobalCoordinates(double latitude, double longitude);
+	GlobalCoordinates(double latitude, double longitude,
+			Canonicalization canonicalization = Canonicalize);
 
 	/**
 	 * Get latitude.
@@ -129,6 +147,62 @@ public:
 	 */
 	bool operator>=(const GlobalCoordinates &other) const;
 
+	/**
+	 * Canonicalize a latitude and longitude pair in place such that:
+	 *
+	 * <pre>
+	 * -90 &lt;= latitude &lt;= +90 - 180 &lt; longitude &lt;= +180
+	 * </pre>
+	 *
+	 * This is the same normalization applied by the constructor and the
+	 * setters, available for callers working with raw angles.
+	 *
+	 * @param latitude latitude in degrees (input and output value)
+	 * @param longitude longitude in degrees (input and output value)
+	 */
+	static void canonicalize(double &latitude, double &longitude);
+
+	/**
+	 * Canonicalize count latitude and longitude pairs in place, with the same
+	 * result as calling canonicalize() on each pair. The range check is done
+	 * for a block of pairs at a time without branches, so arrays that are
+	 * already canonical, the usual case, are only read; the fmod() path is
+	 * taken only for blocks that contain an outlier.
+	 *
+	 * @param count the number of pairs
+	 * @param latitudes latitudes in degrees (input and output values)
+	 * @param longitudes longitudes in degrees (input and output values)
+	 */
+	static void canonicalize(std::size_t count, double *latitudes,
+			double *longitudes);
+
+	/**
+	 * The array form of canonicalize() above for pairs that are not packed,
+	 * such as the members of an array of structures: pair i is
+	 * latitudes[i * stride] and longitudes[i * stride].
+	 *
+	 * @param count the number of pairs
+	 * @param latitudes latitudes in degrees (input and output values)
+	 * @param longitudes longitudes in degrees (input and output values)
+	 * @param stride distance between consecutive pairs, in doubles
+	 */
+	static void canonicalize(std::size_t count, double *latitudes,
+			double *longitudes, std::size_t stride);
+
+	/**
+	 * Check whether a latitude and longitude pair is already canonical. NaN
+	 * angles are not.
+	 *
+	 * @param latitude latitude in degrees
+	 * @param longitude longitude in degrees
+	 * @return true if canonicalize() would leave the pair as it is
+	 */
+	static bool isCanonical(double latitude, double longitude) {
+		// bitwise and keeps the check free of branches
+		return (latitude >= -90) & (latitude <= 90) & (longitude > -180)
+				& (longitude <= 180);
+	}
+
 private:
 	/** Latitude in degrees. Negative latitude is southern hemisphere. */
 	double mLatitude;
@@ -34,14 +34,15 @@ GlobalPosition::~GlobalPosition() {
 }
 
 GlobalPosition::GlobalPosition(double latitude, double longitude,
-		double elevation) :
-		GlobalCoordinates(latitude, longitude), mElevation(elevation) {
+		double elevation, Canonicalization canonicalization) :
+		GlobalCoordinates(latitude, longitude, canonicalization), mElevation(
+				elevation) {
 }
 
 GlobalPosition::GlobalPosition(const GlobalCoordinates &coords,
 		double elevation) :
-		GlobalCoordinates(coords.getLatitude(), coords.getLongitude()), mElevation(
-				elevation) {
+		GlobalCoordinates(coords.getLatitude(), coords.getLongitude(),
+				AssumeCanonical), mElevation(elevation) {
 }
 
 double GlobalPosition::getElevation() const {
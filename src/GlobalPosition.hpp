@@ -60,8 +60,11 @@ public:
 	 * @param latitude latitude in degrees
 	 * @param longitude longitude in degrees
 	 * @param elevation elevation, in meters, above the reference ellipsoid
+	 * @param canonicalization whether to canonicalize the angles, see
+	 *        GlobalCoordinates
 	 */
-	GlobalPosition(double latitude, double longitude, double elevation);
+	GlobalPosition(double latitude, double longitude, double elevation,
+			Canonicalization canonicalization = Canonicalize);
 
 	/**
 	 * Creates a new instance of GlobalPosition.
@@ -0,0 +1,791 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#include "KarneyInverse.hpp"
+#include "SolverStats.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace geodesy {
+
+using namespace std;
+
+//
+// All the series and the structure of the solution follow Karney's paper and
+// his GeographicLib, http://geographiclib.sourceforge.net
+//
+
+static const double Degree = M_PI / 180.0;
+
+/** Smallest number whose square is still normal. */
+static const double Tiny = sqrt(numeric_limits<double>::min());
+static const double Tol0 = numeric_limits<double>::epsilon();
+static const double Tol1 = 200 * Tol0;
+static const double Tol2 = sqrt(Tol0);
+static const double TolB = Tol0 * Tol2;
+static const double XThresh = 1000 * Tol2;
+
+/** Number of Newton steps before falling back to bisection only. */
+static const int MaxIterations1 = 20;
+
+/** Enough bisections to get down to the last bit. */
+static const int MaxIterations2 = MaxIterations1
+		+ numeric_limits<double>::digits + 10;
+
+/**
+ * Evaluate the polynomial p[0] x^n + ... + p[n].
+ */
+static inline double polyval(int n, const double *p, double x) {
+	double y = n < 0 ? 0 : *p++;
+	while (--n >= 0) {
+		y = y * x + *p++;
+	}
+	return y;
+}
+
+static inline void norm(double &x, double &y) {
+	double r = hypot(x, y);
+	x /= r;
+	y /= r;
+}
+
+/**
+ * x + y and the rounding error of the sum in t.
+ */
+static inline double sum(double u, double v, double &t) {
+	double s = u + v;
+	double up = s - v;
+	double vpp = s - up;
+	up -= u;
+	vpp -= v;
+	t = -(up + vpp);
+	return s;
+}
+
+/**
+ * Round tiny angles so that they are exact multiples of a small power of two,
+ * which keeps points very close to the equator on it.
+ */
+static inline double angRound(double x) {
+	static const double z = 1 / 16.0;
+	if (x == 0) {
+		return 0;
+	}
+	volatile double y = fabs(x);
+	// the compiler mustn't simplify z - (z - y) to y
+	y = y < z ? z - (z - y) : y;
+	return x < 0 ? -y : y;
+}
+
+/**
+ * y - x in degrees, reduced to [-180, 180] and computed exactly before
+ * rounding.
+ */
+static inline double angDiff(double x, double y) {
+	double t;
+	double d = remainder(sum(remainder(-x, 360.0), remainder(y, 360.0), t),
+			360.0);
+	if (d == -180) {
+		d = 180;
+	}
+	return d == 180 && t > 0 ? -180 + t : d + t;
+}
+
+/**
+ * sin and cos of an angle in degrees, exact for multiples of 90.
+ */
+static inline void sincosd(double x, double &sinx, double &cosx) {
+	int q = 0;
+	double r = remquo(x, 90.0, &q) * Degree;
+	double s = sin(r);
+	double c = cos(r);
+	switch (static_cast<unsigned>(q) & 3U) {
+	case 0U:
+		sinx = s;
+		cosx = c;
+		break;
+	case 1U:
+		sinx = c;
+		cosx = -s;
+		break;
+	case 2U:
+		sinx = -s;
+		cosx = -c;
+		break;
+	default:
+		sinx = -c;
+		cosx = s;
+		break;
+	}
+	if (x != 0) {
+		sinx += 0.0;
+		cosx += 0.0;
+	}
+}
+
+/**
+ * atan2 in degrees, exact for the four axes.
+ */
+static inline double atan2d(double y, double x) {
+	int q = 0;
+	if (fabs(y) > fabs(x)) {
+		swap(x, y);
+		q = 2;
+	}
+	if (signbit(x)) {
+		x = -x;
+		++q;
+	}
+	double angle = atan2(y, x) / Degree;
+	switch (q) {
+	case 1:
+		angle = copysign(180.0, y) - angle;
+		break;
+	case 2:
+		angle = 90 - angle;
+		break;
+	case 3:
+		angle = -90 + angle;
+		break;
+	default:
+		break;
+	}
+	return angle;
+}
+
+/**
+ * Evaluate sum(c[i] sin(2 i x), i, 1, n) by Clenshaw summation.
+ */
+static inline double sinSeries(double sinx, double cosx, const double c[],
+		int n) {
+	c += n + 1;
+	double ar = 2 * (cosx - sinx) * (cosx + sinx);
+	double y0 = n & 1 ? *--c : 0;
+	double y1 = 0;
+	n /= 2;
+	while (n--) {
+		y1 = ar * y0 - y1 + *--c;
+		y0 = ar * y1 - y0 + *--c;
+	}
+	return 2 * sinx * cosx * y0;
+}
+
+/**
+ * (1 - eps) A1 - 1
+ */
+static inline double a1m1(double eps) {
+	static const double coeff[] = { 1, 4, 64, 0, 256 };
+	double t = polyval(3, coeff, eps * eps) / coeff[4];
+	return (t + eps) / (1 - eps);
+}
+
+/**
+ * The coefficients C1[l] in c[1] to c[6].
+ */
+static inline void c1(double eps, double c[]) {
+	static const double coeff[] = {
+		-1, 6, -16, 32,
+		-9, 64, -128, 2048,
+		9, -16, 768,
+		3, -5, 512,
+		-7, 1280,
+		-7, 2048
+	};
+	double eps2 = eps * eps;
+	double d = eps;
+	int o = 0;
+	for (int l = 1; l <= 6; ++l) {
+		int m = (6 - l) / 2;
+		c[l] = d * polyval(m, coeff + o, eps2) / coeff[o + m + 1];
+		o += m + 2;
+		d *= eps;
+	}
+}
+
+/**
+ * (1 + eps) A2 - 1
+ */
+static inline double a2m1(double eps) {
+	static const double coeff[] = { -11, -28, -192, 0, 256 };
+	double t = polyval(3, coeff, eps * eps) / coeff[4];
+	return (t - eps) / (1 + eps);
+}
+
+/**
+ * The coefficients C2[l] in c[1] to c[6].
+ */
+static inline void c2(double eps, double c[]) {
+	static const double coeff[] = {
+		1, 2, 16, 32,
+		35, 64, 384, 2048,
+		15, 80, 768,
+		7, 35, 512,
+		63, 1280,
+		77, 2048
+	};
+	double eps2 = eps * eps;
+	double d = eps;
+	int o = 0;
+	for (int l = 1; l <= 6; ++l) {
+		int m = (6 - l) / 2;
+		c[l] = d * polyval(m, coeff + o, eps2) / coeff[o + m + 1];
+		o += m + 2;
+		d *= eps;
+	}
+}
+
+/**
+ * Solve k^4 + 2 k^3 - (x^2 + y^2 - 1) k^2 - 2 y^2 k - y^2 = 0 for the
+ * positive root k.
+ */
+static double astroid(double x, double y) {
+	double p = x * x;
+	double q = y * y;
+	double r = (p + q - 1) / 6;
+	if (q == 0 && r <= 0) {
+		// y = 0 with |x| <= 1
+		return 0;
+	}
+
+	double S = p * q / 4;
+	double r2 = r * r;
+	double r3 = r * r2;
+	// zero on the evolute p^(1/3) + q^(1/3) = 1
+	double disc = S * (S + 2 * r3);
+	double u = r;
+	if (disc >= 0) {
+		double T3 = S + r3;
+		// pick the sign of the sqrt that avoids cancellation
+		T3 += T3 < 0 ? -sqrt(disc) : sqrt(disc);
+		double T = cbrt(T3);
+		u += T + (T != 0 ? r2 / T : 0);
+	} else {
+		// T is complex but u is real
+		double ang = atan2(sqrt(-disc), -(S + r3));
+		u += 2 * r * cos(ang / 3);
+	}
+	double v = sqrt(u * u + q);
+	double uv = u < 0 ? q / (v - u) : u + v;
+	double w = (uv - q) / (2 * v);
+	return uv / (sqrt(uv + w * w) + w);
+}
+
+KarneyInverse::KarneyInverse(const Ellipsoid &ellipsoid) :
+		mSemiMajorAxis(ellipsoid.getSemiMajorAxis()), mSemiMinorAxis(
+				ellipsoid.getSemiMinorAxis()), mFlattening(
+				ellipsoid.getFlattening()) {
+	double f = mFlattening;
+	mF1 = ellipsoid.getAxisRatio();
+	mEp2 = ellipsoid.getEccentricitySquared() / (mF1 * mF1);
+	mN = ellipsoid.getThirdFlattening();
+	mEtol2 = 0.1 * Tol2
+			/ sqrt(max(0.001, fabs(f)) * min(1.0, 1 - f / 2) / 2);
+
+	// A3 as a polynomial in eps, coefficients polynomials in n
+	static const double a3Coeff[] = {
+		-3, 128,
+		-2, -3, 64,
+		-1, -3, -1, 16,
+		3, -1, -2, 8,
+		1, -1, 2,
+		1, 1
+	};
+	int o = 0;
+	int k = 0;
+	for (int j = Order - 1; j >= 0; --j) {
+		int m = min(Order - j - 1, j);
+		mA3x[k++] = polyval(m, a3Coeff + o, mN) / a3Coeff[o + m + 1];
+		o += m + 2;
+	}
+
+	// C3[l] as polynomials in eps, coefficients polynomials in n
+	static const double c3Coeff[] = {
+		3, 128,
+		2, 5, 128,
+		-1, 3, 3, 64,
+		-1, 0, 1, 8,
+		-1, 1, 4,
+		5, 256,
+		1, 3, 128,
+		-3, -2, 3, 64,
+		1, -3, 2, 32,
+		7, 512,
+		-10, 9, 384,
+		5, -9, 5, 192,
+		7, 512,
+		-14, 7, 512,
+		21, 2560
+	};
+	o = 0;
+	k = 0;
+	for (int l = 1; l < Order; ++l) {
+		for (int j = Order - 1; j >= l; --j) {
+			int m = min(Order - j - 1, j);
+			mC3x[k++] = polyval(m, c3Coeff + o, mN) / c3Coeff[o + m + 1];
+			o += m + 2;
+		}
+	}
+}
+
+KarneyInverse::~KarneyInverse() {
+}
+
+double KarneyInverse::a3(double eps) const {
+	return polyval(Order - 1, mA3x, eps);
+}
+
+void KarneyInverse::c3(double eps, double c[]) const {
+	double mult = 1;
+	int o = 0;
+	for (int l = 1; l < Order; ++l) {
+		int m = Order - l - 1;
+		mult *= eps;
+		c[l] = mult * polyval(m, mC3x + o, eps);
+		o += m + 1;
+	}
+}
+
+/**
+ * The distance (if distance is set) and the reduced length, both divided by
+ * b.
+ */
+void KarneyInverse::lengths(double eps, double sig12, double ssig1,
+		double csig1, double dn1, double ssig2, double csig2, double dn2,
+		bool distance, double &s12b, double &m12b) const {
+	double ca[Order + 1];
+	double cb[Order + 1];
+
+	double A1 = a1m1(eps);
+	c1(eps, ca);
+	double A2 = a2m1(eps);
+	c2(eps, cb);
+	double m0x = A1 - A2;
+	A1 = 1 + A1;
+	A2 = 1 + A2;
+
+	double J12;
+	if (distance) {
+		double B1 = sinSeries(ssig2, csig2, ca, Order)
+				- sinSeries(ssig1, csig1, ca, Order);
+		s12b = A1 * (sig12 + B1);
+		double B2 = sinSeries(ssig2, csig2, cb, Order)
+				- sinSeries(ssig1, csig1, cb, Order);
+		J12 = m0x * sig12 + (A1 * B1 - A2 * B2);
+	} else {
+		for (int l = 1; l <= Order; ++l) {
+			cb[l] = A1 * ca[l] - A2 * cb[l];
+		}
+		J12 = m0x * sig12
+				+ (sinSeries(ssig2, csig2, cb, Order)
+						- sinSeries(ssig1, csig1, cb, Order));
+	}
+	// the parentheses make coincident points cancel exactly
+	m12b = dn2 * (csig1 * ssig2) - dn1 * (ssig1 * csig2)
+			- csig1 * csig2 * J12;
+}
+
+/**
+ * Find a starting azimuth for Newton's method. For short lines the problem
+ * is solved outright and sigma12 is returned, otherwise -1.
+ */
+double KarneyInverse::inverseStart(double sbet1, double cbet1, double sbet2,
+		double cbet2, double lam12, double slam12, double clam12,
+		double &salp1, double &calp1, double &salp2, double &calp2,
+		double &dnm) const {
+	double sig12 = -1;
+	// bet12 = bet2 - bet1 in [0, pi), bet12a = bet2 + bet1 in (-pi, 0]
+	double sbet12 = sbet2 * cbet1 - cbet2 * sbet1;
+	double cbet12 = cbet2 * cbet1 + sbet2 * sbet1;
+	double sbet12a = sbet2 * cbet1 + cbet2 * sbet1;
+	bool shortline = cbet12 >= 0 && sbet12 < 0.5 && cbet2 * lam12 < 0.5;
+	double somg12, comg12;
+	if (shortline) {
+		double sbetm2 = (sbet1 + sbet2) * (sbet1 + sbet2);
+		sbetm2 /= sbetm2 + (cbet1 + cbet2) * (cbet1 + cbet2);
+		dnm = sqrt(1 + mEp2 * sbetm2);
+		double omg12 = lam12 / (mF1 * dnm);
+		somg12 = sin(omg12);
+		comg12 = cos(omg12);
+	} else {
+		somg12 = slam12;
+		comg12 = clam12;
+	}
+
+	salp1 = cbet2 * somg12;
+	calp1 = comg12 >= 0 ?
+			sbet12 + cbet2 * sbet1 * somg12 * somg12 / (1 + comg12) :
+			sbet12a - cbet2 * sbet1 * somg12 * somg12 / (1 - comg12);
+
+	double ssig12 = hypot(salp1, calp1);
+	double csig12 = sbet1 * sbet2 + cbet1 * cbet2 * comg12;
+
+	if (shortline && ssig12 < mEtol2) {
+		// really short lines
+		salp2 = cbet1 * somg12;
+		calp2 = sbet12
+				- cbet1 * sbet2
+						* (comg12 >= 0 ?
+								somg12 * somg12 / (1 + comg12) : 1 - comg12);
+		norm(salp2, calp2);
+		sig12 = atan2(ssig12, csig12);
+	} else if (fabs(mN) > 0.1 || csig12 >= 0
+			|| ssig12 >= 6 * fabs(mN) * M_PI * cbet1 * cbet1 || mFlattening < 0) {
+		// the zeroth order spherical approximation is good enough
+	} else {
+		// nearly antipodal, scale lam12 and bet2 to x, y coordinates where the
+		// antipodal point is at the origin and the singular point at y = 0,
+		// x = -1
+		double lam12x = atan2(-slam12, -clam12);
+		double k2 = sbet1 * sbet1 * mEp2;
+		double eps = k2 / (2 * (1 + sqrt(1 + k2)) + k2);
+		double lamscale = mFlattening * cbet1 * a3(eps) * M_PI;
+		double betscale = lamscale * cbet1;
+		double x = lam12x / lamscale;
+		double y = sbet12a / betscale;
+
+		if (y > -Tol1 && x > -1 - XThresh) {
+			// strip near the cut
+			salp1 = min(1.0, -x);
+			calp1 = -sqrt(1 - salp1 * salp1);
+		} else {
+			double k = astroid(x, y);
+			double omg12a = lamscale * (-x * k / (1 + k));
+			somg12 = sin(omg12a);
+			comg12 = -cos(omg12a);
+			// update the spherical estimate with omg12 instead of lam12
+			salp1 = cbet2 * somg12;
+			calp1 = sbet12a
+					- cbet2 * sbet1 * somg12 * somg12 / (1 - comg12);
+		}
+	}
+	// sanity check on the starting guess, written to let NaN through
+	if (!(salp1 <= 0)) {
+		norm(salp1, calp1);
+	} else {
+		salp1 = 1;
+		calp1 = 0;
+	}
+	return sig12;
+}
+
+/**
+ * The longitude difference reached by setting off with azimuth alpha1, minus
+ * the target, and with diffp its derivative with respect to alpha1.
+ */
+double KarneyInverse::lambda12(double sbet1, double cbet1, double dn1,
+		double sbet2, double cbet2, double dn2, double salp1, double calp1,
+		double slam120, double clam120, double &salp2, double &calp2,
+		double &sig12, double &ssig1, double &csig1, double &ssig2,
+		double &csig2, double &eps, bool diffp, double &dlam12) const {
+	if (sbet1 == 0 && calp1 == 0) {
+		// break the degeneracy of the equatorial line
+		calp1 = -Tiny;
+	}
+
+	// sin(alp1) * cos(bet1) = sin(alp0)
+	double salp0 = salp1 * cbet1;
+	double calp0 = hypot(calp1, salp1 * sbet1);
+
+	// tan(bet1) = tan(sig1) * cos(alp1)
+	// tan(omg1) = sin(alp0) * tan(sig1)
+	ssig1 = sbet1;
+	double somg1 = salp0 * sbet1;
+	csig1 = calp1 * cbet1;
+	double comg1 = csig1;
+	norm(ssig1, csig1);
+
+	// enforce the symmetries in the case |bet2| = -bet1, they would otherwise
+	// be singular for Newton's method
+	salp2 = cbet2 != cbet1 ? salp0 / cbet2 : salp1;
+	calp2 = cbet2 != cbet1 || fabs(sbet2) != -sbet1 ?
+			sqrt(
+					(calp1 * cbet1) * (calp1 * cbet1)
+							+ (cbet1 < -sbet1 ?
+									(cbet2 - cbet1) * (cbet1 + cbet2) :
+									(sbet1 - sbet2) * (sbet1 + sbet2)))
+					/ cbet2 :
+			fabs(calp1);
+	ssig2 = sbet2;
+	double somg2 = salp0 * sbet2;
+	csig2 = calp2 * cbet2;
+	double comg2 = csig2;
+	norm(ssig2, csig2);
+
+	// sig12 = sig2 - sig1, limited to [0, pi]
+	sig12 = atan2(max(0.0, csig1 * ssig2 - ssig1 * csig2),
+			csig1 * csig2 + ssig1 * ssig2);
+
+	// omg12 = omg2 - omg1, limited to [0, pi]
+	double somg12 = max(0.0, comg1 * somg2 - somg1 * comg2);
+	double comg12 = comg1 * comg2 + somg1 * somg2;
+	// eta = omg12 - lam120
+	double eta = atan2(somg12 * clam120 - comg12 * slam120,
+			comg12 * clam120 + somg12 * slam120);
+
+	double k2 = calp0 * calp0 * mEp2;
+	eps = k2 / (2 * (1 + sqrt(1 + k2)) + k2);
+	double c[Order];
+	c3(eps, c);
+	double B312 = sinSeries(ssig2, csig2, c, Order - 1)
+			- sinSeries(ssig1, csig1, c, Order - 1);
+	double domg12 = -mFlattening * a3(eps) * salp0 * (sig12 + B312);
+	double lam12 = eta + domg12;
+
+	if (diffp) {
+		if (calp2 == 0) {
+			dlam12 = -2 * mF1 * dn1 / sbet1;
+		} else {
+			double dummy;
+			lengths(eps, sig12, ssig1, csig1, dn1, ssig2, csig2, dn2, false,
+					dummy, dlam12);
+			dlam12 *= mF1 / (calp2 * cbet2);
+		}
+	}
+
+	return lam12;
+}
+
+GeodeticCurveValue KarneyInverse::calculateGeodeticCurve(
+		const GlobalCoordinates &start, const GlobalCoordinates &end) const {
+	GeodeticCurveValue curve;
+	solve(start.getLatitude(), start.getLongitude(), end.getLatitude(),
+			end.getLongitude(), curve.ellipsoidalDistance, curve.azimuth,
+			curve.reverseAzimuth);
+
+	return curve;
+}
+
+int KarneyInverse::solve(double lat1, double lon1, double lat2, double lon2,
+		double &s, double &alpha1, double &alpha2) const {
+	int iterations = 0;
+
+	// make the longitude difference positive
+	double lon12 = angDiff(lon1, lon2);
+	int lonsign = lon12 >= 0 ? 1 : -1;
+	lon12 = lonsign * angRound(lon12);
+	double lam12 = lon12 * Degree;
+	double slam12, clam12;
+	sincosd(lon12, slam12, clam12);
+
+	// if really close to the equator, treat as on the equator
+	lat1 = angRound(lat1);
+	lat2 = angRound(lat2);
+
+	// swap the points so that the one with the higher (absolute) latitude is
+	// point 1, then make lat1 <= -0
+	int swapp = fabs(lat1) < fabs(lat2) ? -1 : 1;
+	if (swapp < 0) {
+		lonsign *= -1;
+		swap(lat1, lat2);
+	}
+	int latsign = lat1 < 0 ? 1 : -1;
+	lat1 *= latsign;
+	lat2 *= latsign;
+
+	// now 0 <= lon12 <= 180, -90 <= lat1 <= -0 and lat1 <= lat2 <= -lat1
+
+	double sbet1, cbet1, sbet2, cbet2;
+	sincosd(lat1, sbet1, cbet1);
+	sbet1 *= mF1;
+	// cbet1 = +epsilon at the poles
+	norm(sbet1, cbet1);
+	cbet1 = max(Tiny, cbet1);
+
+	sincosd(lat2, sbet2, cbet2);
+	sbet2 *= mF1;
+	norm(sbet2, cbet2);
+	cbet2 = max(Tiny, cbet2);
+
+	// force bet2 = +/- bet1 exactly when the difference vanishes, see
+	// lambda12()
+	if (cbet1 < -sbet1) {
+		if (cbet2 == cbet1) {
+			sbet2 = sbet2 < 0 ? sbet1 : -sbet1;
+		}
+	} else {
+		if (fabs(sbet2) == -sbet1) {
+			cbet2 = cbet1;
+		}
+	}
+
+	double dn1 = sqrt(1 + mEp2 * sbet1 * sbet1);
+	double dn2 = sqrt(1 + mEp2 * sbet2 * sbet2);
+
+	double sig12, s12x, m12x;
+	double salp1, calp1, salp2, calp2;
+
+	bool meridian = lat1 == -90 || slam12 == 0;
+
+	if (meridian) {
+		// the end points are on a single full meridian, so the geodesic might
+		// lie on it
+		calp1 = clam12;
+		salp1 = slam12;
+		calp2 = 1;
+		salp2 = 0;
+
+		// tan(bet) = tan(sig) * cos(alp)
+		double ssig1 = sbet1, csig1 = calp1 * cbet1;
+		double ssig2 = sbet2, csig2 = calp2 * cbet2;
+
+		sig12 = atan2(max(0.0, csig1 * ssig2 - ssig1 * csig2),
+				csig1 * csig2 + ssig1 * ssig2);
+		lengths(mN, sig12, ssig1, csig1, dn1, ssig2, csig2, dn2, true, s12x,
+				m12x);
+		// sig12 > pi/2 with m12 < 0 is not a shortest path
+		if (sig12 < 1 || m12x >= 0) {
+			// and no negative lengths for short lines
+			if (sig12 < 3 * Tiny
+					|| (sig12 < Tol0 && (s12x < 0 || m12x < 0))) {
+				sig12 = m12x = s12x = 0;
+			}
+			s12x *= mSemiMinorAxis;
+		} else {
+			meridian = false;
+		}
+	}
+
+	if (!meridian && sbet1 == 0
+			&& (mFlattening <= 0 || lam12 <= M_PI - mFlattening * M_PI)) {
+		// the geodesic runs along the equator
+		calp1 = calp2 = 0;
+		salp1 = salp2 = 1;
+		s12x = mSemiMajorAxis * lam12;
+	} else if (!meridian) {
+		// the points are within a hemisphere bounded by a meridian and the
+		// geodesic is neither meridional nor equatorial
+		double dnm;
+		sig12 = inverseStart(sbet1, cbet1, sbet2, cbet2, lam12, slam12,
+				clam12, salp1, calp1, salp2, calp2, dnm);
+
+		if (sig12 >= 0) {
+			// short line, solved by inverseStart()
+			s12x = sig12 * mSemiMinorAxis * dnm;
+		} else {
+			// Newton's method on f(alp1) = lambda12(alp1) - lam12, which has
+			// one root in (0, pi) with a positive derivative. A bracket
+			// (alp1a, alp1b) of the root is kept and Newton's method falls
+			// back to its midpoint whenever a step goes the wrong way or
+			// leaves the bracket.
+			double ssig1 = 0, csig1 = 0, ssig2 = 0, csig2 = 0, eps = 0;
+			double salp1a = Tiny, calp1a = 1, salp1b = Tiny, calp1b = -1;
+			bool tripn = false;
+			bool tripb = false;
+			for (;; ++iterations) {
+				double dv = 0;
+				double v = lambda12(sbet1, cbet1, dn1, sbet2, cbet2, dn2,
+						salp1, calp1, slam12, clam12, salp2, calp2, sig12,
+						ssig1, csig1, ssig2, csig2, eps,
+						iterations < MaxIterations1, dv);
+				// reversed test to let NaN escape
+				if (tripb || !(fabs(v) >= (tripn ? 8 : 1) * Tol0)
+						|| iterations == MaxIterations2) {
+					break;
+				}
+				// update the bracket
+				if (v > 0
+						&& (iterations > MaxIterations1
+								|| calp1 / salp1 > calp1b / salp1b)) {
+					salp1b = salp1;
+					calp1b = calp1;
+				} else if (v < 0
+						&& (iterations > MaxIterations1
+								|| calp1 / salp1 < calp1a / salp1a)) {
+					salp1a = salp1;
+					calp1a = calp1;
+				}
+				if (iterations < MaxIterations1 && dv > 0) {
+					double dalp1 = -v / dv;
+					if (fabs(dalp1) < M_PI) {
+						double sdalp1 = sin(dalp1);
+						double cdalp1 = cos(dalp1);
+						double nsalp1 = salp1 * cdalp1 + calp1 * sdalp1;
+						if (nsalp1 > 0) {
+							calp1 = calp1 * cdalp1 - salp1 * sdalp1;
+							salp1 = nsalp1;
+							norm(salp1, calp1);
+							// convergence can be linear when the slope goes to
+							// zero, so test against epsilon from here on
+							tripn = fabs(v) <= 16 * Tol0;
+							continue;
+						}
+					}
+				}
+				// bisect
+				salp1 = (salp1a + salp1b) / 2;
+				calp1 = (calp1a + calp1b) / 2;
+				norm(salp1, calp1);
+				tripn = false;
+				tripb = (fabs(salp1a - salp1) + (calp1a - calp1) < TolB
+						|| fabs(salp1 - salp1b) + (calp1 - calp1b) < TolB);
+			}
+			lengths(eps, sig12, ssig1, csig1, dn1, ssig2, csig2, dn2, true,
+					s12x, m12x);
+			s12x *= mSemiMinorAxis;
+		}
+	}
+
+	GEODESY_STATS_RECORD(SolverStats::Inverse, iterations,
+			iterations < MaxIterations2, false);
+
+	// convert -0 to 0
+	s = 0 + s12x;
+
+	// undo the transformations to the canonical form
+	if (swapp < 0) {
+		swap(salp1, salp2);
+		swap(calp1, calp2);
+	}
+	salp1 *= swapp * lonsign;
+	calp1 *= swapp * latsign;
+	salp2 *= swapp * lonsign;
+	calp2 *= swapp * latsign;
+
+	// azimuth at the start and the reverse of the azimuth at the end, both in
+	// [0, 360)
+	alpha1 = atan2d(salp1, calp1);
+	if (alpha1 < 0) {
+		alpha1 += 360.0;
+	}
+	alpha2 = atan2d(-salp2, -calp2);
+	if (alpha2 < 0) {
+		alpha2 += 360.0;
+	}
+	if (alpha1 >= 360.0) {
+		alpha1 -= 360.0;
+	}
+	if (alpha2 >= 360.0) {
+		alpha2 -= 360.0;
+	}
+
+	return iterations;
+}
+
+}
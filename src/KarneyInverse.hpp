@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#ifndef KARNEYINVERSE_HPP_
+#define KARNEYINVERSE_HPP_
+
+#include <tr1/memory>
+
+#include "Ellipsoid.hpp"
+#include "GeodeticCurve.hpp"
+#include "GlobalCoordinates.hpp"
+
+namespace geodesy {
+
+/**
+ * <p>
+ * Charles Karney's solution of the inverse geodetic problem, see C. F. F.
+ * Karney, Algorithms for geodesics, J. Geodesy 87, 43-55 (2013),
+ * http://dx.doi.org/10.1007/s00190-012-0578-z
+ * </p>
+ * <p>
+ * The geodesic is found by Newton's method on the azimuth at the start,
+ * bracketed and falling back to bisection, using series in the third
+ * flattening to sixth order for the distance and longitude integrals. Unlike
+ * Vincenty's iteration it converges for every pair of points, including
+ * nearly antipodal ones, and the results are accurate to about 15 nanometers
+ * for the WGS84 ellipsoid. It usually needs 2 or 3 iterations and never more
+ * than 83.
+ * </p>
+ * <p>
+ * The terms that depend only on the ellipsoid are computed by the
+ * constructor, so keep an instance around when solving many problems on the
+ * same ellipsoid.
+ * </p>
+ */
+class KarneyInverse {
+public:
+	typedef std::tr1::shared_ptr<KarneyInverse> Ptr;
+	typedef std::tr1::shared_ptr<KarneyInverse const> ConstPtr;
+
+	/**
+	 * Prepare for solving problems on an ellipsoid.
+	 *
+	 * @param ellipsoid reference ellipsoid to use
+	 */
+	explicit KarneyInverse(const Ellipsoid &ellipsoid);
+
+	virtual ~KarneyInverse();
+
+	/**
+	 * Calculate the geodetic curve between two points.
+	 *
+	 * @param start starting coordinates
+	 * @param end ending coordinates
+	 * @return the curve, the azimuths are defined even for coincident points
+	 */
+	GeodeticCurveValue calculateGeodeticCurve(const GlobalCoordinates &start,
+			const GlobalCoordinates &end) const;
+
+	/**
+	 * Same as calculateGeodeticCurve() on raw canonical coordinates.
+	 *
+	 * @param startLatitude starting latitude (degrees)
+	 * @param startLongitude starting longitude (degrees)
+	 * @param endLatitude ending latitude (degrees)
+	 * @param endLongitude ending longitude (degrees)
+	 * @param s ellipsoidal distance in meters (output value)
+	 * @param alpha1 azimuth in degrees (output value)
+	 * @param alpha2 reverse azimuth in degrees (output value)
+	 * @return the number of Newton or bisection steps taken
+	 */
+	int solve(double startLatitude, double startLongitude,
+			double endLatitude, double endLongitude, double &s,
+			double &alpha1, double &alpha2) const;
+
+private:
+	/** Order of the series. */
+	static const int Order = 6;
+
+	double a3(double eps) const;
+
+	void c3(double eps, double c[]) const;
+
+	void lengths(double eps, double sig12, double ssig1, double csig1,
+			double dn1, double ssig2, double csig2, double dn2,
+			bool distance, double &s12b, double &m12b) const;
+
+	double inverseStart(double sbet1, double cbet1, double sbet2,
+			double cbet2, double lam12, double slam12, double clam12,
+			double &salp1, double &calp1, double &salp2, double &calp2,
+			double &dnm) const;
+
+	double lambda12(double sbet1, double cbet1, double dn1, double sbet2,
+			double cbet2, double dn2, double salp1, double calp1,
+			double slam120, double clam120, double &salp2, double &calp2,
+			double &sig12, double &ssig1, double &csig1, double &ssig2,
+			double &csig2, double &eps, bool diffp, double &dlam12) const;
+
+	/** Semi major axis (meters). */
+	double mSemiMajorAxis;
+
+	/** Semi minor axis (meters). */
+	double mSemiMinorAxis;
+
+	/** Flattening. */
+	double mFlattening;
+
+	/** 1 - f */
+	double mF1;
+
+	/** Second eccentricity squared. */
+	double mEp2;
+
+	/** Third flattening. */
+	double mN;
+
+	/** Threshold on sigma below which a line counts as really short. */
+	double mEtol2;
+
+	/** Coefficients of A3 as a polynomial in eps. */
+	double mA3x[Order];
+
+	/** Coefficients of C3 as polynomials in eps. */
+	double mC3x[(Order * (Order - 1)) / 2];
+
+};
+
+}
+
+#endif /* KARNEYINVERSE_HPP_ */
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#ifndef LATLON_HPP_
+#define LATLON_HPP_
+
+#include "GlobalCoordinates.hpp"
+#include "GlobalPosition.hpp"
+
+#include <cstddef>
+
+namespace geodesy {
+
+/**
+ * <p>
+ * Plain value form of GlobalCoordinates: two doubles, 16 bytes, no virtual
+ * table and no base class. It is trivially copyable, so arrays of it can be
+ * copied with memcpy(), written to files or placed in shared memory as they
+ * are.
+ * </p>
+ * <p>
+ * Unlike GlobalCoordinates it keeps whatever angles it is given. Values from
+ * fromGlobalCoordinates() are canonical, other values can be made so with
+ * canonicalize().
+ * </p>
+ */
+struct LatLon {
+	/** Latitude in degrees. Negative latitude is southern hemisphere. */
+	double latitude;
+
+	/** Longitude in degrees. Negative longitude is western hemisphere. */
+	double longitude;
+
+	/**
+	 * Copy the coordinates of a GlobalCoordinates.
+	 *
+	 * @param coordinates the coordinates
+	 * @return the canonical latitude and longitude
+	 */
+	static LatLon fromGlobalCoordinates(const GlobalCoordinates &coordinates) {
+		LatLon value = { coordinates.getLatitude(), coordinates.getLongitude() };
+		return value;
+	}
+
+	/**
+	 * Convert to GlobalCoordinates, which canonicalizes the angles.
+	 * @return
+	 */
+	GlobalCoordinates toGlobalCoordinates() const {
+		return GlobalCoordinates(latitude, longitude);
+	}
+
+	/**
+	 * Canonicalize the angles in place, see GlobalCoordinates::canonicalize().
+	 */
+	void canonicalize() {
+		GlobalCoordinates::canonicalize(latitude, longitude);
+	}
+
+	/**
+	 * Canonicalize an array in place, with the block at a time range check of
+	 * the array form of GlobalCoordinates::canonicalize().
+	 *
+	 * @param count the number of values
+	 * @param values the values (input and output)
+	 */
+	static void canonicalize(std::size_t count, LatLon *values) {
+		if (count > 0) {
+			GlobalCoordinates::canonicalize(count, &values[0].latitude,
+					&values[0].longitude, sizeof(LatLon) / sizeof(double));
+		}
+	}
+};
+
+/**
+ * Plain value form of GlobalPosition: three doubles, 24 bytes, trivially
+ * copyable like LatLon.
+ */
+struct LatLonAlt {
+	/** Latitude in degrees. Negative latitude is southern hemisphere. */
+	double latitude;
+
+	/** Longitude in degrees. Negative longitude is western hemisphere. */
+	double longitude;
+
+	/** Elevation, in meters, above the surface of the ellipsoid. */
+	double elevation;
+
+	/**
+	 * Copy the coordinates and elevation of a GlobalPosition.
+	 *
+	 * @param position the position
+	 * @return the canonical latitude and longitude, and the elevation
+	 */
+	static LatLonAlt fromGlobalPosition(const GlobalPosition &position) {
+		LatLonAlt value = { position.getLatitude(), position.getLongitude(),
+				position.getElevation() };
+		return value;
+	}
+
+	/**
+	 * Convert to GlobalPosition, which canonicalizes the angles.
+	 * @return
+	 */
+	GlobalPosition toGlobalPosition() const {
+		return GlobalPosition(latitude, longitude, elevation);
+	}
+
+	/**
+	 * Get the latitude and longitude.
+	 * @return
+	 */
+	LatLon getLatLon() const {
+		LatLon value = { latitude, longitude };
+		return value;
+	}
+
+	/**
+	 * Canonicalize the angles in place, see GlobalCoordinates::canonicalize().
+	 */
+	void canonicalize() {
+		GlobalCoordinates::canonicalize(latitude, longitude);
+	}
+};
+
+}
+
+#endif /* LATLON_HPP_ */
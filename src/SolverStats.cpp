@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#include "SolverStats.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <pthread.h>
+#include <time.h>
+
+namespace geodesy {
+
+using namespace std;
+
+const size_t SolverCounters::LatencyBuckets;
+
+unsigned long long SolverCounters::getLatencyPercentile(double fraction) const {
+	if (timedCalls == 0) {
+		return 0;
+	}
+	unsigned long long rank = static_cast<unsigned long long>(fraction
+			* timedCalls);
+	unsigned long long seen = 0;
+	for (size_t i = 0; i < LatencyBuckets; ++i) {
+		seen += latency[i];
+		if (seen > rank) {
+			return 2ULL << i;
+		}
+	}
+	return 2ULL << (LatencyBuckets - 1);
+}
+
+#ifdef GEODESY_STATS
+
+namespace {
+
+/**
+ * The counters of one thread. Only the owning thread writes them, other
+ * threads read them for snapshots, so relaxed atomic loads and stores are
+ * enough.
+ */
+struct ThreadStats {
+	SolverStatsSnapshot counters;
+	ThreadStats *previous;
+	ThreadStats *next;
+};
+
+inline unsigned long long load(const unsigned long long &counter) {
+	return __atomic_load_n(&counter, __ATOMIC_RELAXED);
+}
+
+inline void store(unsigned long long &counter, unsigned long long value) {
+	__atomic_store_n(&counter, value, __ATOMIC_RELAXED);
+}
+
+inline void add(unsigned long long &counter, unsigned long long value) {
+	store(counter, load(counter) + value);
+}
+
+/** Protects the list of threads and the retired counters. */
+pthread_mutex_t registryMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/** The blocks of the live threads. */
+ThreadStats *threads = 0;
+
+/** The sum of the counters of the threads that have exited. */
+SolverStatsSnapshot retired;
+
+pthread_once_t keyOnce = PTHREAD_ONCE_INIT;
+pthread_key_t key;
+
+__thread ThreadStats *current = 0;
+
+void accumulate(SolverCounters &to, const SolverCounters &from) {
+	to.solves += load(from.solves);
+	to.iterations += load(from.iterations);
+	to.maxIterations = max(to.maxIterations, load(from.maxIterations));
+	to.notConverged += load(from.notConverged);
+	to.antipodalFallbacks += load(from.antipodalFallbacks);
+	to.timedCalls += load(from.timedCalls);
+	to.totalNanoseconds += load(from.totalNanoseconds);
+	for (size_t i = 0; i < SolverCounters::LatencyBuckets; ++i) {
+		to.latency[i] += load(from.latency[i]);
+	}
+}
+
+void accumulate(SolverStatsSnapshot &to, const SolverStatsSnapshot &from) {
+	accumulate(to.inverse, from.inverse);
+	accumulate(to.direct, from.direct);
+}
+
+void clear(SolverCounters &counters) {
+	store(counters.solves, 0);
+	store(counters.iterations, 0);
+	store(counters.maxIterations, 0);
+	store(counters.notConverged, 0);
+	store(counters.antipodalFallbacks, 0);
+	store(counters.timedCalls, 0);
+	store(counters.totalNanoseconds, 0);
+	for (size_t i = 0; i < SolverCounters::LatencyBuckets; ++i) {
+		store(counters.latency[i], 0);
+	}
+}
+
+/**
+ * Fold the counters of an exiting thread into the retired ones.
+ */
+void retire(void *stats) {
+	ThreadStats *block = static_cast<ThreadStats *>(stats);
+	pthread_mutex_lock(&registryMutex);
+	accumulate(retired, block->counters);
+	if (block->previous) {
+		block->previous->next = block->next;
+	} else {
+		threads = block->next;
+	}
+	if (block->next) {
+		block->next->previous = block->previous;
+	}
+	pthread_mutex_unlock(&registryMutex);
+	delete block;
+}
+
+void createKey() {
+	pthread_key_create(&key, retire);
+}
+
+inline SolverCounters &threadCounters(SolverStats::Problem problem) {
+	if (!current) {
+		pthread_once(&keyOnce, createKey);
+		ThreadStats *block = new ThreadStats;
+		memset(block, 0, sizeof(*block));
+		pthread_mutex_lock(&registryMutex);
+		block->next = threads;
+		if (threads) {
+			threads->previous = block;
+		}
+		threads = block;
+		pthread_mutex_unlock(&registryMutex);
+		pthread_setspecific(key, block);
+		current = block;
+	}
+	return problem == SolverStats::Inverse ?
+			current->counters.inverse : current->counters.direct;
+}
+
+inline unsigned long long now() {
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return static_cast<unsigned long long>(ts.tv_sec) * 1000000000ULL
+			+ ts.tv_nsec;
+}
+
+}
+
+bool SolverStats::isEnabled() {
+	return true;
+}
+
+SolverStatsSnapshot SolverStats::getSnapshot() {
+	SolverStatsSnapshot snapshot;
+	memset(&snapshot, 0, sizeof(snapshot));
+	pthread_mutex_lock(&registryMutex);
+	accumulate(snapshot, retired);
+	for (ThreadStats *block = threads; block; block = block->next) {
+		accumulate(snapshot, block->counters);
+	}
+	pthread_mutex_unlock(&registryMutex);
+	return snapshot;
+}
+
+SolverStatsSnapshot SolverStats::getThreadSnapshot() {
+	SolverStatsSnapshot snapshot;
+	memset(&snapshot, 0, sizeof(snapshot));
+	if (current) {
+		accumulate(snapshot, current->counters);
+	}
+	return snapshot;
+}
+
+void SolverStats::reset() {
+	pthread_mutex_lock(&registryMutex);
+	memset(&retired, 0, sizeof(retired));
+	for (ThreadStats *block = threads; block; block = block->next) {
+		clear(block->counters.inverse);
+		clear(block->counters.direct);
+	}
+	pthread_mutex_unlock(&registryMutex);
+}
+
+void SolverStats::record(Problem problem, int iterations, bool converged,
+		bool fallback) {
+	SolverCounters &counters = threadCounters(problem);
+	unsigned long long n = iterations > 0 ? iterations : 0;
+	add(counters.solves, 1);
+	add(counters.iterations, n);
+	if (n > load(counters.maxIterations)) {
+		store(counters.maxIterations, n);
+	}
+	if (!converged) {
+		add(counters.notConverged, 1);
+	}
+	if (fallback) {
+		add(counters.antipodalFallbacks, 1);
+	}
+}
+
+void SolverStats::recordTime(Problem problem, unsigned long long nanoseconds) {
+	SolverCounters &counters = threadCounters(problem);
+	size_t bucket = nanoseconds ? 63 - __builtin_clzll(nanoseconds) : 0;
+	bucket = min(bucket, SolverCounters::LatencyBuckets - 1);
+	add(counters.timedCalls, 1);
+	add(counters.totalNanoseconds, nanoseconds);
+	add(counters.latency[bucket], 1);
+}
+
+SolverStats::Timer::Timer(Problem problem) :
+		mProblem(problem), mStart(now()) {
+}
+
+SolverStats::Timer::~Timer() {
+	recordTime(mProblem, now() - mStart);
+}
+
+#else
+
+bool SolverStats::isEnabled() {
+	return false;
+}
+
+SolverStatsSnapshot SolverStats::getSnapshot() {
+	SolverStatsSnapshot snapshot;
+	memset(&snapshot, 0, sizeof(snapshot));
+	return snapshot;
+}
+
+SolverStatsSnapshot SolverStats::getThreadSnapshot() {
+	return getSnapshot();
+}
+
+void SolverStats::reset() {
+}
+
+void SolverStats::record(Problem, int, bool, bool) {
+}
+
+void SolverStats::recordTime(Problem, unsigned long long) {
+}
+
+SolverStats::Timer::Timer(Problem problem) :
+		mProblem(problem), mStart(0) {
+}
+
+SolverStats::Timer::~Timer() {
+}
+
+#endif
+
+}
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#ifndef SOLVERSTATS_HPP_
+#define SOLVERSTATS_HPP_
+
+#include <cstddef>
+
+namespace geodesy {
+
+/**
+ * Counters for one kind of problem.
+ */
+struct SolverCounters {
+	/**
+	 * Number of buckets in the latency histogram. Bucket i counts the calls
+	 * that took from 2^i up to 2^(i+1) nanoseconds, the last bucket also
+	 * counts everything slower.
+	 */
+	static const std::size_t LatencyBuckets = 32;
+
+	/** Number of problems solved. */
+	unsigned long long solves;
+
+	/** Iterations summed over all solves. */
+	unsigned long long iterations;
+
+	/** The most iterations any single solve took. */
+	unsigned long long maxIterations;
+
+	/** Solves that ran out of iterations before converging. */
+	unsigned long long notConverged;
+
+	/**
+	 * Inverse solves that did not converge and fell back to a due north or
+	 * south azimuth (Vincenty's method only).
+	 */
+	unsigned long long antipodalFallbacks;
+
+	/** Number of timed calls. */
+	unsigned long long timedCalls;
+
+	/** Time spent in the timed calls (nanoseconds). */
+	unsigned long long totalNanoseconds;
+
+	/** Latency histogram of the timed calls. */
+	unsigned long long latency[LatencyBuckets];
+
+	/**
+	 * Estimate a percentile of the latency from the histogram.
+	 *
+	 * @param fraction the percentile as a fraction, 0.99 for p99
+	 * @return upper bound of the bucket holding the percentile (nanoseconds),
+	 *         0 if nothing was timed
+	 */
+	unsigned long long getLatencyPercentile(double fraction) const;
+};
+
+/**
+ * Counters for both problems.
+ */
+struct SolverStatsSnapshot {
+	/** Inverse problem, calculateGeodeticCurve() and friends. */
+	SolverCounters inverse;
+
+	/** Direct problem, calculateEndingGlobalCoordinates() and friends. */
+	SolverCounters direct;
+};
+
+/**
+ * <p>
+ * Instrumentation of the solvers, compiled in when the library is built with
+ * GEODESY_STATS defined (the GEODESY_STATS CMake option) and compiled out
+ * entirely otherwise.
+ * </p>
+ * <p>
+ * The scalar solvers count solves, iterations, solves that did not converge
+ * and the antipodal fallbacks of Vincenty's inverse, wherever they run. The
+ * SIMD kernels are not instrumented. The single problem entry points of
+ * GeodeticCalculator are timed as well.
+ * </p>
+ * <p>
+ * Each thread counts into its own block, so counting needs no locking and
+ * doesn't bounce cache lines between cores. A snapshot adds up the blocks of
+ * all threads, including threads that have exited.
+ * </p>
+ */
+class SolverStats {
+public:
+	/** The kinds of problem. */
+	enum Problem {
+		Inverse, Direct
+	};
+
+	/**
+	 * Find out whether the library was built with the instrumentation.
+	 * @return false if every snapshot will be all zeros
+	 */
+	static bool isEnabled();
+
+	/**
+	 * Get the counters summed over all threads.
+	 * @return the counters
+	 */
+	static SolverStatsSnapshot getSnapshot();
+
+	/**
+	 * Get the counters of the calling thread only.
+	 * @return the counters
+	 */
+	static SolverStatsSnapshot getThreadSnapshot();
+
+	/**
+	 * Zero the counters of all threads. Counts made while the reset runs may
+	 * survive it.
+	 */
+	static void reset();
+
+	/**
+	 * Count one solve on the calling thread.
+	 *
+	 * @param problem the kind of problem
+	 * @param iterations number of iterations taken
+	 * @param converged false if the solver ran out of iterations
+	 * @param fallback true if Vincenty's inverse fell back to a due north or
+	 *          south azimuth
+	 */
+	static void record(Problem problem, int iterations, bool converged,
+			bool fallback);
+
+	/**
+	 * Count one timed call on the calling thread.
+	 *
+	 * @param problem the kind of problem
+	 * @param nanoseconds time taken
+	 */
+	static void recordTime(Problem problem, unsigned long long nanoseconds);
+
+	/**
+	 * Times its own lifetime and records it with recordTime().
+	 */
+	class Timer {
+	public:
+		explicit Timer(Problem problem);
+		~Timer();
+	private:
+		Problem mProblem;
+		unsigned long long mStart;
+	};
+
+private:
+	// no instances
+	SolverStats() {
+	}
+};
+
+}
+
+/*
+ * Hooks for the solvers, they expand to nothing unless GEODESY_STATS is
+ * defined.
+ */
+#ifdef GEODESY_STATS
+#define GEODESY_STATS_RECORD(problem, iterations, converged, fallback) \
+	geodesy::SolverStats::record(problem, iterations, converged, fallback)
+#define GEODESY_STATS_TIMER(problem) \
+	geodesy::SolverStats::Timer statsTimer(problem)
+#else
+#define GEODESY_STATS_RECORD(problem, iterations, converged, fallback) \
+	((void) (iterations), (void) (converged), (void) (fallback))
+#define GEODESY_STATS_TIMER(problem) ((void) 0)
+#endif
+
+#endif /* SOLVERSTATS_HPP_ */
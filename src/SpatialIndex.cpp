@@ -0,0 +1,569 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#include "SpatialIndex.hpp"
+#include "Angle.hpp"
+#include "FastMath.hpp"
+#include "FileUtil.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <queue>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace geodesy {
+
+using namespace std;
+
+const std::size_t SpatialIndex::DefaultLeafSize;
+
+namespace {
+
+/**
+ * The chord bounds are loosened by this much (meters) so that rounding never
+ * prunes a point whose ellipsoidal distance is right at the limit.
+ */
+const double Slack = 1E-6;
+
+inline double square(double x) {
+	return x * x;
+}
+
+/**
+ * The chord is never longer than the ellipsoidal distance, but the
+ * approximate methods can give less than that: the haversine of the mean
+ * sphere is up to 0.45% short where the ellipsoid curves least, Andoyer-Lambert
+ * up to 500 m over 19000 km. The chord bounds are scaled by this so that no
+ * point the method puts within the limit is pruned.
+ */
+double chordScale(GeodeticCalculator::InverseMethod method) {
+	switch (method) {
+	case GeodeticCalculator::Haversine:
+		return 1.006;
+	case GeodeticCalculator::AndoyerLambert:
+		return 1.00003;
+	default:
+		return 1.0;
+	}
+}
+
+/** Orders point numbers by one cartesian coordinate. */
+class CoordinateLess {
+public:
+	explicit CoordinateLess(const vector<double> &coordinates) :
+			mCoordinates(coordinates) {
+	}
+
+	bool operator()(std::size_t a, std::size_t b) const {
+		return mCoordinates[a] < mCoordinates[b];
+	}
+
+private:
+	const vector<double> &mCoordinates;
+};
+
+bool closer(const SpatialIndex::Neighbor &a, const SpatialIndex::Neighbor &b) {
+	return a.ellipsoidalDistance < b.ellipsoidalDistance;
+}
+
+/**
+ * Start of the block, followed by the arrays: the boxes (6 nodeCount
+ * doubles), x, y, z, latitudes and longitudes (count doubles each), and the
+ * input positions (count 64 bit integers).
+ */
+struct Header {
+	char magic[8];
+	unsigned int version;
+	/** ByteOrder as written, to catch files from other architectures. */
+	unsigned int byteOrder;
+	unsigned long long count;
+	unsigned long long nodeCount;
+	unsigned int depth;
+	unsigned int reserved;
+	double semiMajorAxis;
+	double flattening;
+	unsigned long long padding;
+};
+
+const char Magic[8] = { 'G', 'E', 'O', 'I', 'N', 'D', 'E', 'X' };
+const unsigned int Version = 1;
+const unsigned int ByteOrder = 0x01020304;
+
+/**
+ * Size in bytes of the block of an index.
+ */
+std::size_t blockSize(std::size_t count, std::size_t nodeCount) {
+	return sizeof(Header) + sizeof(double) * (6 * nodeCount + 5 * count)
+			+ sizeof(unsigned long long) * count;
+}
+
+string errorMessage(const string &what, const string &path) {
+	return what + " " + path + ": " + strerror(errno);
+}
+
+}
+
+struct SpatialIndex::Pending {
+	/** Square of the chord distance to the box of the node. */
+	double boundSquared;
+	std::size_t node;
+	std::size_t begin;
+	std::size_t end;
+	unsigned depth;
+
+	/** Reversed, so that a priority_queue gives the closest box first. */
+	bool operator<(const Pending &other) const {
+		return boundSquared > other.boundSquared;
+	}
+};
+
+SpatialIndex::SpatialIndex() :
+		mMapping(0), mMappingSize(0) {
+}
+
+SpatialIndex::~SpatialIndex() {
+	if (mMapping) {
+		munmap(mMapping, mMappingSize);
+	}
+}
+
+SpatialIndex::SpatialIndex(Ellipsoid::ConstPtr ellipsoid,
+		const std::vector<GlobalCoordinates> &points, std::size_t leafSize) :
+		mEllipsoid(ellipsoid), mMapping(0), mMappingSize(0) {
+	vector<double> latitudes(points.size());
+	vector<double> longitudes(points.size());
+	for (std::size_t i = 0; i < points.size(); ++i) {
+		latitudes[i] = points[i].getLatitude();
+		longitudes[i] = points[i].getLongitude();
+	}
+	build(points.size(), points.empty() ? 0 : &latitudes[0],
+			points.empty() ? 0 : &longitudes[0], leafSize);
+}
+
+SpatialIndex::SpatialIndex(Ellipsoid::ConstPtr ellipsoid, std::size_t count,
+		const double *latitudes, const double *longitudes,
+		std::size_t leafSize) :
+		mEllipsoid(ellipsoid), mMapping(0), mMappingSize(0) {
+	build(count, latitudes, longitudes, leafSize);
+}
+
+SpatialIndex::Ptr SpatialIndex::open(const std::string &path)
+		throw (SpatialIndexFileException) {
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		throw SpatialIndexFileException(errorMessage("Can't open", path));
+	}
+	struct stat status;
+	if (fstat(fd, &status) != 0) {
+		string message = errorMessage("Can't stat", path);
+		close(fd);
+		throw SpatialIndexFileException(message);
+	}
+	std::size_t size = status.st_size;
+	if (size < sizeof(Header)) {
+		close(fd);
+		throw SpatialIndexFileException("Not a spatial index: " + path);
+	}
+
+	void *mapping = mmap(0, size, PROT_READ, MAP_SHARED, fd, 0);
+	if (mapping == MAP_FAILED) {
+		string message = errorMessage("Can't map", path);
+		close(fd);
+		throw SpatialIndexFileException(message);
+	}
+	close(fd);
+
+	SpatialIndex::Ptr index(new SpatialIndex());
+	index->mMapping = mapping;
+	index->mMappingSize = size;
+	string problem = index->attach(mapping, size);
+	if (!problem.empty()) {
+		throw SpatialIndexFileException(problem + ": " + path);
+	}
+	return index;
+}
+
+void SpatialIndex::save(const std::string &path) const
+		throw (SpatialIndexFileException) {
+	const void *data = mMapping ? mMapping : &mBlock[0];
+	std::size_t size = mMapping ? mMappingSize : mBlock.size() * sizeof(double);
+
+	// write a new file and rename it over the old one, processes that have
+	// the old one mapped keep reading it
+	string temporary = path + ".tmp";
+	FILE *file = fopen(temporary.c_str(), "wb");
+	if (!file) {
+		throw SpatialIndexFileException(
+				errorMessage("Can't create", temporary));
+	}
+	bool written = fwrite(data, 1, size, file) == size;
+	written = fileutil::closeSynced(file) && written;
+	if (!written) {
+		string message = errorMessage("Can't write", temporary);
+		remove(temporary.c_str());
+		throw SpatialIndexFileException(message);
+	}
+	if (rename(temporary.c_str(), path.c_str()) != 0) {
+		string message = errorMessage("Can't rename to", path);
+		remove(temporary.c_str());
+		throw SpatialIndexFileException(message);
+	}
+	if (!fileutil::syncDirectory(path)) {
+		throw SpatialIndexFileException(
+				errorMessage("Can't sync the directory of", path));
+	}
+}
+
+bool SpatialIndex::isMapped() const {
+	return mMapping != 0;
+}
+
+std::size_t SpatialIndex::getCount() const {
+	return mCount;
+}
+
+Ellipsoid::ConstPtr SpatialIndex::getEllipsoid() const {
+	return mEllipsoid;
+}
+
+void SpatialIndex::build(std::size_t count, const double *latitudes,
+		const double *longitudes, std::size_t leafSize) {
+	mSemiMajorAxis = mEllipsoid->getSemiMajorAxis();
+	mEccentricitySquared = mEllipsoid->getEccentricitySquared();
+
+	// all leaves at the same depth, with at most leafSize points each
+	leafSize = max(leafSize, static_cast<std::size_t>(1));
+	unsigned depth = 0;
+	while (count > 0 && ((count - 1) >> depth) + 1 > leafSize) {
+		++depth;
+	}
+	std::size_t nodeCount = (static_cast<std::size_t>(2) << depth) - 1;
+
+	Header header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, Magic, sizeof(Magic));
+	header.version = Version;
+	header.byteOrder = ByteOrder;
+	header.count = count;
+	header.nodeCount = nodeCount;
+	header.depth = depth;
+	header.semiMajorAxis = mSemiMajorAxis;
+	header.flattening = mEllipsoid->getFlattening();
+
+	std::size_t size = blockSize(count, nodeCount);
+	mBlock.assign(size / sizeof(double), 0.0);
+	char *block = reinterpret_cast<char *>(&mBlock[0]);
+	memcpy(block, &header, sizeof(header));
+	double *bounds = reinterpret_cast<double *>(block + sizeof(header));
+	double *points = bounds + 6 * nodeCount;
+	unsigned long long *indices =
+			reinterpret_cast<unsigned long long *>(points + 5 * count);
+
+	vector<double> lat(count);
+	vector<double> lon(count);
+	vector<double> x(count);
+	vector<double> y(count);
+	vector<double> z(count);
+	vector<std::size_t> order(count);
+	std::copy(latitudes, latitudes + count, lat.begin());
+	std::copy(longitudes, longitudes + count, lon.begin());
+	if (count > 0) {
+		GlobalCoordinates::canonicalize(count, &lat[0], &lon[0]);
+	}
+	for (std::size_t i = 0; i < count; ++i) {
+		toCartesian(lat[i], lon[i], x[i], y[i], z[i]);
+		order[i] = i;
+	}
+
+	mDepth = depth;
+	buildNode(0, 0, count, 0, order, x, y, z, bounds);
+
+	for (std::size_t i = 0; i < count; ++i) {
+		std::size_t j = order[i];
+		points[i] = x[j];
+		points[count + i] = y[j];
+		points[2 * count + i] = z[j];
+		points[3 * count + i] = lat[j];
+		points[4 * count + i] = lon[j];
+		indices[i] = j;
+	}
+
+	attach(block, size);
+}
+
+void SpatialIndex::buildNode(std::size_t node, std::size_t begin,
+		std::size_t end, unsigned depth, std::vector<std::size_t> &order,
+		const std::vector<double> &x, const std::vector<double> &y,
+		const std::vector<double> &z, double *bounds) {
+	double *box = bounds + 6 * node;
+	box[0] = box[1] = box[2] = numeric_limits<double>::infinity();
+	box[3] = box[4] = box[5] = -numeric_limits<double>::infinity();
+	for (std::size_t i = begin; i < end; ++i) {
+		std::size_t j = order[i];
+		box[0] = min(box[0], x[j]);
+		box[1] = min(box[1], y[j]);
+		box[2] = min(box[2], z[j]);
+		box[3] = max(box[3], x[j]);
+		box[4] = max(box[4], y[j]);
+		box[5] = max(box[5], z[j]);
+	}
+
+	if (depth == mDepth) {
+		return;
+	}
+
+	// split in halves across the widest extent
+	double dx = box[3] - box[0];
+	double dy = box[4] - box[1];
+	double dz = box[5] - box[2];
+	const vector<double> &axis = dx >= dy && dx >= dz ? x : (dy >= dz ? y : z);
+	std::size_t middle = begin + (end - begin) / 2;
+	nth_element(order.begin() + begin, order.begin() + middle,
+			order.begin() + end, CoordinateLess(axis));
+
+	buildNode(2 * node + 1, begin, middle, depth + 1, order, x, y, z, bounds);
+	buildNode(2 * node + 2, middle, end, depth + 1, order, x, y, z, bounds);
+}
+
+std::string SpatialIndex::attach(const void *data, std::size_t size) {
+	const char *block = static_cast<const char *>(data);
+	Header header;
+	memcpy(&header, block, sizeof(header));
+	if (memcmp(header.magic, Magic, sizeof(Magic)) != 0) {
+		return "Not a spatial index";
+	}
+	if (header.byteOrder != ByteOrder) {
+		return "Spatial index of another byte order";
+	}
+	if (header.version != Version) {
+		return "Unsupported spatial index version";
+	}
+
+	// the sizes must agree with each other and with the file, without
+	// overflowing
+	unsigned long long limit = size / sizeof(double);
+	if (header.depth >= 8 * sizeof(std::size_t) - 1
+			|| header.nodeCount != (2ULL << header.depth) - 1
+			|| header.count > limit || header.nodeCount > limit
+			|| blockSize(header.count, header.nodeCount) != size) {
+		return "Truncated or corrupt spatial index";
+	}
+
+	mCount = header.count;
+	mDepth = header.depth;
+	if (!mEllipsoid) {
+		mEllipsoid = Ellipsoid::intern(header.semiMajorAxis,
+				header.flattening);
+	}
+	mSemiMajorAxis = mEllipsoid->getSemiMajorAxis();
+	mEccentricitySquared = mEllipsoid->getEccentricitySquared();
+
+	mBounds = reinterpret_cast<const double *>(block + sizeof(header));
+	mX = mBounds + 6 * header.nodeCount;
+	mY = mX + mCount;
+	mZ = mY + mCount;
+	mLatitudes = mZ + mCount;
+	mLongitudes = mLatitudes + mCount;
+	mIndices = reinterpret_cast<const unsigned long long *>(mLongitudes
+			+ mCount);
+	return string();
+}
+
+void SpatialIndex::toCartesian(double latitude, double longitude, double &x,
+		double &y, double &z) const {
+	double sinPhi;
+	double cosPhi;
+	double sinLambda;
+	double cosLambda;
+	fastmath::sincos(Angle::toRadians(latitude), sinPhi, cosPhi);
+	fastmath::sincos(Angle::toRadians(longitude), sinLambda, cosLambda);
+
+	// radius of curvature in the prime vertical
+	double n = mSemiMajorAxis
+			/ sqrt(1.0 - mEccentricitySquared * sinPhi * sinPhi);
+	x = n * cosPhi * cosLambda;
+	y = n * cosPhi * sinLambda;
+	z = n * (1.0 - mEccentricitySquared) * sinPhi;
+}
+
+double SpatialIndex::boxDistanceSquared(std::size_t node, double x, double y,
+		double z) const {
+	const double *bounds = mBounds + 6 * node;
+	double dx = max(0.0, max(bounds[0] - x, x - bounds[3]));
+	double dy = max(0.0, max(bounds[1] - y, y - bounds[4]));
+	double dz = max(0.0, max(bounds[2] - z, z - bounds[5]));
+	return dx * dx + dy * dy + dz * dz;
+}
+
+void SpatialIndex::split(const Pending &parent, double x, double y, double z,
+		Pending children[2]) const {
+	std::size_t middle = parent.begin + (parent.end - parent.begin) / 2;
+	for (int c = 0; c < 2; ++c) {
+		children[c].node = 2 * parent.node + 1 + c;
+		children[c].begin = c == 0 ? parent.begin : middle;
+		children[c].end = c == 0 ? middle : parent.end;
+		children[c].depth = parent.depth + 1;
+		children[c].boundSquared = boxDistanceSquared(children[c].node, x, y,
+				z);
+	}
+}
+
+double SpatialIndex::solve(const GlobalCoordinates &target, std::size_t point,
+		GeodeticCalculator::InverseMethod method) const {
+	GeodeticCurveValue curve = GeodeticCalculator::calculateGeodeticCurve(
+			*mEllipsoid, target,
+			GlobalCoordinates(mLatitudes[point], mLongitudes[point],
+					GlobalCoordinates::AssumeCanonical), method);
+	return curve.ellipsoidalDistance;
+}
+
+std::vector<SpatialIndex::Neighbor> SpatialIndex::findNearest(
+		const GlobalCoordinates &target, std::size_t count,
+		GeodeticCalculator::InverseMethod method) const {
+	vector<Neighbor> results;
+	if (count == 0 || mCount == 0) {
+		return results;
+	}
+	results.reserve(min(count, mCount));
+
+	double x, y, z;
+	toCartesian(target.getLatitude(), target.getLongitude(), x, y, z);
+
+	// results is a max-heap on distance once full, limitSquared bounds the
+	// chord of anything that can still get in
+	double limitSquared = numeric_limits<double>::infinity();
+	double scale = chordScale(method);
+	priority_queue<Pending> pending;
+	Pending root = { boxDistanceSquared(0, x, y, z), 0, 0, mCount, 0 };
+	pending.push(root);
+
+	while (!pending.empty()) {
+		Pending next = pending.top();
+		pending.pop();
+		if (next.boundSquared > limitSquared) {
+			break;
+		}
+
+		if (next.depth < mDepth) {
+			Pending children[2];
+			split(next, x, y, z, children);
+			for (int c = 0; c < 2; ++c) {
+				if (children[c].boundSquared <= limitSquared) {
+					pending.push(children[c]);
+				}
+			}
+			continue;
+		}
+
+		for (std::size_t i = next.begin; i < next.end; ++i) {
+			double chordSquared = square(mX[i] - x) + square(mY[i] - y)
+					+ square(mZ[i] - z);
+			if (chordSquared > limitSquared) {
+				continue;
+			}
+
+			Neighbor neighbor = { mIndices[i], solve(target, i, method) };
+			if (results.size() < count) {
+				results.push_back(neighbor);
+				push_heap(results.begin(), results.end(), closer);
+			} else if (neighbor.ellipsoidalDistance
+					< results.front().ellipsoidalDistance) {
+				pop_heap(results.begin(), results.end(), closer);
+				results.back() = neighbor;
+				push_heap(results.begin(), results.end(), closer);
+			}
+			if (results.size() == count) {
+				limitSquared = square(
+						results.front().ellipsoidalDistance * scale + Slack);
+			}
+		}
+	}
+
+	sort_heap(results.begin(), results.end(), closer);
+	return results;
+}
+
+std::vector<SpatialIndex::Neighbor> SpatialIndex::findWithinRadius(
+		const GlobalCoordinates &target, double radius,
+		GeodeticCalculator::InverseMethod method) const {
+	vector<Neighbor> results;
+	if (mCount == 0 || !(radius >= 0.0)) {
+		return results;
+	}
+
+	double x, y, z;
+	toCartesian(target.getLatitude(), target.getLongitude(), x, y, z);
+	double limitSquared = square(radius * chordScale(method) + Slack);
+
+	vector<Pending> pending;
+	Pending root = { boxDistanceSquared(0, x, y, z), 0, 0, mCount, 0 };
+	if (root.boundSquared <= limitSquared) {
+		pending.push_back(root);
+	}
+
+	while (!pending.empty()) {
+		Pending next = pending.back();
+		pending.pop_back();
+
+		if (next.depth < mDepth) {
+			Pending children[2];
+			split(next, x, y, z, children);
+			for (int c = 0; c < 2; ++c) {
+				if (children[c].boundSquared <= limitSquared) {
+					pending.push_back(children[c]);
+				}
+			}
+			continue;
+		}
+
+		for (std::size_t i = next.begin; i < next.end; ++i) {
+			double chordSquared = square(mX[i] - x) + square(mY[i] - y)
+					+ square(mZ[i] - z);
+			if (chordSquared > limitSquared) {
+				continue;
+			}
+
+			Neighbor neighbor = { mIndices[i], solve(target, i, method) };
+			if (neighbor.ellipsoidalDistance <= radius) {
+				results.push_back(neighbor);
+			}
+		}
+	}
+
+	sort(results.begin(), results.end(), closer);
+	return results;
+}
+
+}
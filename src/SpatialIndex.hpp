@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#ifndef SPATIALINDEX_HPP_
+#define SPATIALINDEX_HPP_
+
+#include <cstddef>
+#include <exception>
+#include <string>
+#include <tr1/memory>
+#include <vector>
+
+#include "Ellipsoid.hpp"
+#include "GeodeticCalculator.hpp"
+#include "GlobalCoordinates.hpp"
+
+namespace geodesy {
+
+/**
+ * Thrown when a SpatialIndex can't be saved to or opened from a file.
+ */
+class SpatialIndexFileException: public std::exception {
+public:
+	explicit SpatialIndexFileException(const std::string &message) :
+			mMessage(message) {
+	}
+	virtual ~SpatialIndexFileException() throw () {
+	}
+	/**
+	 * @see exception::what()
+	 */
+	virtual const char * what() const throw () {
+		return mMessage.c_str();
+	}
+
+private:
+	std::string mMessage;
+};
+
+/**
+ * <p>
+ * Nearest neighbour and within radius queries over a fixed set of points,
+ * by ellipsoidal distance.
+ * </p>
+ * <p>
+ * The points are converted to earth centered cartesian coordinates and kept
+ * in a balanced kd-tree: each node splits its points in halves across the
+ * axis along which they spread the most and stores the box bounding them.
+ * The straight line (chord) between two points on the ellipsoid is never
+ * longer than the geodesic between them, so the distance from the query
+ * point to a box, and to a point, bounds the ellipsoidal distance from below.
+ * Boxes and points that can't beat the current results are pruned with these
+ * bounds, and GeodeticCalculator::calculateGeodeticCurve() is only called for
+ * the points that remain. The approximate methods can give less than the
+ * chord, so for them the bounds are loosened by their largest error.
+ * </p>
+ * <p>
+ * The tree is implicit: node i has children 2i+1 and 2i+2, each node covers
+ * a contiguous range of the reordered points, and all leaves are at the same
+ * depth, so the index is a handful of flat arrays. Queries don't modify the
+ * index and may run concurrently.
+ * </p>
+ * <p>
+ * The arrays are kept in one block laid out exactly as the file written by
+ * save(). open() maps such a file read-only and queries it in place, with no
+ * parsing and no copy: opening is immediate whatever the size of the index,
+ * pages are read from disk as queries touch them, and processes that open
+ * the same file share its pages. The file is in the byte order of the
+ * machine that wrote it.
+ * </p>
+ */
+class SpatialIndex {
+public:
+	typedef std::tr1::shared_ptr<SpatialIndex> Ptr;
+	typedef std::tr1::shared_ptr<SpatialIndex const> ConstPtr;
+
+	/** A point found by a query. */
+	struct Neighbor {
+		/** Position of the point in the set the index was built from. */
+		std::size_t index;
+		/** Ellipsoidal distance from the query point (meters). */
+		double ellipsoidalDistance;
+	};
+
+	/** Default maximum number of points per leaf. */
+	static const std::size_t DefaultLeafSize = 16;
+
+	/**
+	 * Build the index. The coordinates are copied.
+	 *
+	 * @param ellipsoid reference ellipsoid to use
+	 * @param points the points
+	 * @param leafSize maximum number of points per leaf
+	 */
+	SpatialIndex(Ellipsoid::ConstPtr ellipsoid,
+			const std::vector<GlobalCoordinates> &points,
+			std::size_t leafSize = DefaultLeafSize);
+
+	/**
+	 * Build the index from arrays of coordinates, which are copied and
+	 * canonicalized the same way GlobalCoordinates does.
+	 *
+	 * @param ellipsoid reference ellipsoid to use
+	 * @param count number of points
+	 * @param latitudes latitudes (degrees)
+	 * @param longitudes longitudes (degrees)
+	 * @param leafSize maximum number of points per leaf
+	 */
+	SpatialIndex(Ellipsoid::ConstPtr ellipsoid, std::size_t count,
+			const double *latitudes, const double *longitudes,
+			std::size_t leafSize = DefaultLeafSize);
+
+	virtual ~SpatialIndex();
+
+	/**
+	 * Map an index written by save().
+	 *
+	 * @param path the file
+	 * @return the index, valid until the last reference to it is released
+	 * @throws SpatialIndexFileException if the file can't be mapped or isn't
+	 *           an index written on a machine with the same byte order
+	 */
+	static SpatialIndex::Ptr open(const std::string &path)
+			throw (SpatialIndexFileException);
+
+	/**
+	 * Write the index to a file, to be mapped by open(). The file is replaced
+	 * atomically and is on disk when save() returns, so a crash leaves either
+	 * the old index or the new one.
+	 *
+	 * @param path the file, replaced if it exists
+	 * @throws SpatialIndexFileException if the file can't be written
+	 */
+	void save(const std::string &path) const
+			throw (SpatialIndexFileException);
+
+	/**
+	 * Tell if the index is a file mapped by open().
+	 * @return
+	 */
+	bool isMapped() const;
+
+	/**
+	 * Get the number of points.
+	 * @return
+	 */
+	std::size_t getCount() const;
+
+	/**
+	 * Get the reference ellipsoid.
+	 * @return
+	 */
+	Ellipsoid::ConstPtr getEllipsoid() const;
+
+	/**
+	 * Find the points closest to a target.
+	 *
+	 * @param target the query point
+	 * @param count number of points to find
+	 * @param method the algorithm for the ellipsoidal distances
+	 * @return the min(count, getCount()) closest points, closest first
+	 */
+	std::vector<Neighbor> findNearest(const GlobalCoordinates &target,
+			std::size_t count, GeodeticCalculator::InverseMethod method =
+					GeodeticCalculator::Vincenty) const;
+
+	/**
+	 * Find the points within a distance of a target.
+	 *
+	 * @param target the query point
+	 * @param radius the distance (meters)
+	 * @param method the algorithm for the ellipsoidal distances
+	 * @return the points at an ellipsoidal distance of at most radius,
+	 *         closest first
+	 */
+	std::vector<Neighbor> findWithinRadius(const GlobalCoordinates &target,
+			double radius, GeodeticCalculator::InverseMethod method =
+					GeodeticCalculator::Vincenty) const;
+
+private:
+	/** Pending subtree of a nearest neighbour search. */
+	struct Pending;
+
+	/** An index that still has to be mapped by open(). */
+	SpatialIndex();
+
+	// not copyable
+	SpatialIndex(const SpatialIndex &);
+	SpatialIndex &operator=(const SpatialIndex &);
+
+	void build(std::size_t count, const double *latitudes,
+			const double *longitudes, std::size_t leafSize);
+
+	void buildNode(std::size_t node, std::size_t begin, std::size_t end,
+			unsigned depth, std::vector<std::size_t> &order,
+			const std::vector<double> &x, const std::vector<double> &y,
+			const std::vector<double> &z, double *bounds);
+
+	/**
+	 * Check the layout of a block and point the arrays into it.
+	 *
+	 * @param data the block, 8 byte aligned
+	 * @param size size of the block in bytes
+	 * @return a description of the problem, empty if the block is valid
+	 */
+	std::string attach(const void *data, std::size_t size);
+
+	/**
+	 * Convert a canonical point to earth centered cartesian coordinates.
+	 */
+	void toCartesian(double latitude, double longitude, double &x, double &y,
+			double &z) const;
+
+	/**
+	 * Square of the distance from a cartesian point to the box of a node.
+	 */
+	double boxDistanceSquared(std::size_t node, double x, double y,
+			double z) const;
+
+	/**
+	 * The two children of an inner node, with their bounds.
+	 */
+	void split(const Pending &parent, double x, double y, double z,
+			Pending children[2]) const;
+
+	/**
+	 * Ellipsoidal distance from the target to a point in tree order.
+	 */
+	double solve(const GlobalCoordinates &target, std::size_t point,
+			GeodeticCalculator::InverseMethod method) const;
+
+	Ellipsoid::ConstPtr mEllipsoid;
+
+	/** Semi major axis (meters). */
+	double mSemiMajorAxis;
+
+	/** Square of the eccentricity. */
+	double mEccentricitySquared;
+
+	/** The block of a built index, unused when mapped. */
+	std::vector<double> mBlock;
+
+	/** The mapped file, NULL when built. */
+	void *mMapping;
+
+	/** Size of the mapped file in bytes. */
+	std::size_t mMappingSize;
+
+	/** Number of points. */
+	std::size_t mCount;
+
+	/** Depth of the leaves, the root is at depth 0. */
+	unsigned mDepth;
+
+	/** Box of every node, minimum x, y, z then maximum x, y, z. */
+	const double *mBounds;
+
+	/** The points in tree order. */
+	const double *mX;
+	const double *mY;
+	const double *mZ;
+	const double *mLatitudes;
+	const double *mLongitudes;
+
+	/** Position of every point in the input. */
+	const unsigned long long *mIndices;
+
+};
+
+}
+
+#endif /* SPATIALINDEX_HPP_ */
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#include "TrackAccumulator.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace geodesy {
+
+using namespace std;
+
+namespace {
+
+const double NaN = numeric_limits<double>::quiet_NaN();
+
+}
+
+TrackAccumulator::TrackAccumulator(Ellipsoid::ConstPtr refEllipsoid,
+		double errorTolerance, int maxIterations) :
+		mRefEllipsoid(refEllipsoid), mErrorTolerance(errorTolerance), mMaxIterations(
+				maxIterations) {
+	reset();
+}
+
+TrackAccumulator::~TrackAccumulator() {
+}
+
+void TrackAccumulator::add(const GlobalPosition &position) {
+	GeodeticCalculator::ReducedPosition reduced;
+	GeodeticCalculator::reducePosition(mRefEllipsoid->getAxisRatio(),
+			position, reduced);
+
+	if (mPositionCount > 0) {
+		GeodeticCalculator::solveReducedMeasurement(*mRefEllipsoid, mLast,
+				reduced, mErrorTolerance, mMaxIterations, mLastSegment);
+		accumulate(mLastSegment);
+	} else {
+		mLastSegment.ellipsoidalDistance = 0;
+		mLastSegment.azimuth = NaN;
+		mLastSegment.reverseAzimuth = NaN;
+		mLastSegment.elevationChange = 0;
+		mLastSegment.pointToPointDistance = 0;
+	}
+
+	mLast = reduced;
+	++mPositionCount;
+}
+
+void TrackAccumulator::add(size_t count, const GlobalPosition *positions,
+		GeodeticMeasurementValue *segments) {
+	for (size_t i = 0; i < count; ++i) {
+		add(positions[i]);
+		if (segments) {
+			segments[i] = mLastSegment;
+		}
+	}
+}
+
+void TrackAccumulator::accumulate(const GeodeticMeasurementValue &segment) {
+	mEllipsoidalLength += segment.ellipsoidalDistance;
+	mPointToPointLength += segment.pointToPointDistance;
+	if (segment.elevationChange > 0) {
+		mClimb += segment.elevationChange;
+	} else {
+		mDescent -= segment.elevationChange;
+	}
+	if (isnan(mInitialBearing) && segment.ellipsoidalDistance > 0) {
+		mInitialBearing = segment.azimuth;
+	}
+}
+
+void TrackAccumulator::reset() {
+	mPositionCount = 0;
+	mLastSegment.ellipsoidalDistance = NaN;
+	mLastSegment.azimuth = NaN;
+	mLastSegment.reverseAzimuth = NaN;
+	mLastSegment.elevationChange = NaN;
+	mLastSegment.pointToPointDistance = NaN;
+	mEllipsoidalLength = 0;
+	mPointToPointLength = 0;
+	mClimb = 0;
+	mDescent = 0;
+	mInitialBearing = NaN;
+}
+
+size_t TrackAccumulator::getPositionCount() const {
+	return mPositionCount;
+}
+
+size_t TrackAccumulator::getSegmentCount() const {
+	return mPositionCount > 0 ? mPositionCount - 1 : 0;
+}
+
+double TrackAccumulator::getEllipsoidalLength() const {
+	return mEllipsoidalLength;
+}
+
+double TrackAccumulator::getPointToPointLength() const {
+	return mPointToPointLength;
+}
+
+double TrackAccumulator::getClimb() const {
+	return mClimb;
+}
+
+double TrackAccumulator::getDescent() const {
+	return mDescent;
+}
+
+double TrackAccumulator::getInitialBearing() const {
+	return mInitialBearing;
+}
+
+const GeodeticMeasurementValue &TrackAccumulator::getLastSegment() const {
+	return mLastSegment;
+}
+
+}
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#ifndef TRACKACCUMULATOR_HPP_
+#define TRACKACCUMULATOR_HPP_
+
+#include <cstddef>
+#include <tr1/memory>
+
+#include "Ellipsoid.hpp"
+#include "GeodeticCalculator.hpp"
+#include "GeodeticMeasurement.hpp"
+#include "GlobalPosition.hpp"
+
+namespace geodesy {
+
+/**
+ * <p>
+ * Length and climb of a track, built up one fix at a time or in blocks of
+ * fixes, without keeping the fixes.
+ * </p>
+ * <p>
+ * Every segment between consecutive fixes is measured as
+ * GeodeticCalculator::calculateGeodeticMeasurement() would, on the reference
+ * ellipsoid adjusted to the mean elevation of the segment, and the results
+ * are bit for bit the same. The reduced latitude and the longitude in radians
+ * of a fix don't depend on that adjustment, so they are computed once, when
+ * the fix is added, and kept for the next segment instead of being computed
+ * again.
+ * </p>
+ * <p>
+ * Segments between identical fixes have no length and NaN azimuths, they
+ * add nothing to the totals.
+ * </p>
+ */
+class TrackAccumulator {
+public:
+	typedef std::tr1::shared_ptr<TrackAccumulator> Ptr;
+	typedef std::tr1::shared_ptr<TrackAccumulator const> ConstPtr;
+
+	/**
+	 * Start an empty track.
+	 *
+	 * @param refEllipsoid reference ellipsoid to use
+	 * @param errorTolerance once the change in lambda reaches this value, stop iterating
+	 * @param maxIterations maximum number of iterations, even if the error tolerance is not met
+	 */
+	explicit TrackAccumulator(Ellipsoid::ConstPtr refEllipsoid,
+			double errorTolerance = 1E-13, int maxIterations = 20);
+
+	virtual ~TrackAccumulator();
+
+	/**
+	 * Add the next fix of the track.
+	 *
+	 * @param position the fix
+	 */
+	void add(const GlobalPosition &position);
+
+	/**
+	 * Add the next fixes of the track, in order.
+	 *
+	 * @param count number of fixes
+	 * @param positions the fixes
+	 * @param segments the measurement of the segment ending at each fix
+	 *          (output array, may be NULL). The first fix of the track ends
+	 *          no segment, its entry has no length and NaN azimuths.
+	 */
+	void add(std::size_t count, const GlobalPosition *positions,
+			GeodeticMeasurementValue *segments = 0);
+
+	/**
+	 * Forget every fix and start an empty track.
+	 */
+	void reset();
+
+	/**
+	 * Get the number of fixes added.
+	 * @return
+	 */
+	std::size_t getPositionCount() const;
+
+	/**
+	 * Get the number of segments, one less than the number of fixes.
+	 * @return
+	 */
+	std::size_t getSegmentCount() const;
+
+	/**
+	 * Get the sum of the ellipsoidal distances of the segments.
+	 *
+	 * @return the length in meters
+	 */
+	double getEllipsoidalLength() const;
+
+	/**
+	 * Get the sum of the point-to-point distances of the segments, see
+	 * GeodeticMeasurement::getPointToPointDistance().
+	 *
+	 * @return the length in meters
+	 */
+	double getPointToPointLength() const;
+
+	/**
+	 * Get the sum of the elevation gained over the segments that climb.
+	 *
+	 * @return the climb in meters
+	 */
+	double getClimb() const;
+
+	/**
+	 * Get the sum of the elevation lost over the segments that descend.
+	 *
+	 * @return the descent in meters, positive
+	 */
+	double getDescent() const;
+
+	/**
+	 * Get the azimuth at the start of the first segment that has a length.
+	 *
+	 * @return the bearing in degrees, NaN until there is such a segment
+	 */
+	double getInitialBearing() const;
+
+	/**
+	 * Get the measurement of the last segment, with its azimuth and reverse
+	 * azimuth.
+	 *
+	 * @return the segment, with no length and NaN azimuths after the first
+	 *         fix and all NaN before it
+	 */
+	const GeodeticMeasurementValue &getLastSegment() const;
+
+private:
+	Ellipsoid::ConstPtr mRefEllipsoid;
+
+	double mErrorTolerance;
+
+	int mMaxIterations;
+
+	std::size_t mPositionCount;
+
+	/** The terms of the last fix. */
+	GeodeticCalculator::ReducedPosition mLast;
+
+	/**
+	 * Add a segment to the totals.
+	 */
+	void accumulate(const GeodeticMeasurementValue &segment);
+
+	GeodeticMeasurementValue mLastSegment;
+
+	double mEllipsoidalLength;
+
+	double mPointToPointLength;
+
+	double mClimb;
+
+	double mDescent;
+
+	double mInitialBearing;
+
+};
+
+}
+
+#endif /* TRACKACCUMULATOR_HPP_ */
@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#ifndef VECTORMATH_HPP_
+#define VECTORMATH_HPP_
+
+/**
+ * Branch free elementary functions used by the SIMD kernels.
+ *
+ * Everything here is a template over a lane type V. V must provide the usual
+ * arithmetic operators, a nested Mask type produced by its comparison
+ * operators (with &, | and ~), and the free functions select(), abs(),
+ * sqrt(), round(), floor(), mulAdd(), signBits(), xorSign() and any(). The
+ * lane types live next to the kernels that instantiate these templates, so
+ * each instruction set gets its own copy.
+ *
+ * The polynomials are the double precision ones from the Cephes library and
+ * are accurate to about one ulp over the ranges the geodetic kernels use. The
+ * functions ending in Reduced use shorter polynomials, and no division for
+ * the arc tangent, and are accurate to about 2E-11 absolute for sine and
+ * cosine and 3E-12 relative for the arc tangent, less than a tenth of a
+ * millimeter at the surface of the Earth.
+ */
+namespace geodesy {
+
+namespace simd {
+
+/** pi/2 split in three parts for Cody-Waite argument reduction. */
+static const double PiOver2Hi = 1.57079625129699707031e+00;
+static const double PiOver2Mid = 7.54978941586159635336e-08;
+static const double PiOver2Lo = 5.39030285815811905290e-15;
+
+static const double TwoOverPi = 6.36619772367581382433e-01;
+static const double Pi = 3.14159265358979311600e+00;
+static const double PiOver2 = 1.57079632679489655800e+00;
+static const double PiOver4 = 7.85398163397448278999e-01;
+/** The part of pi/2 that does not fit in PiOver2. */
+static const double PiOver2Tail = 6.12323399573676588613e-17;
+static const double TanPiOver8 = 4.14213562373095034920e-01;
+
+/** sin(x) = x + x^3 P(x^2) on [-pi/4, pi/4]. */
+static const double SinCoefficients[] = { 1.58962301576546568060e-10,
+		-2.50507477628578072866e-08, 2.75573136213857245213e-06,
+		-1.98412698295895385996e-04, 8.33333333332211858878e-03,
+		-1.66666666666666307295e-01 };
+
+/** cos(x) = 1 - x^2/2 + x^4 Q(x^2) on [-pi/4, pi/4]. */
+static const double CosCoefficients[] = { -1.13585365213876817300e-11,
+		2.08757008419747316778e-09, -2.75573141792967388112e-07,
+		2.48015872888517045348e-05, -1.38888888888730564116e-03,
+		4.16666666666665929218e-02 };
+
+/** atan(x) = x + x^3 P(x^2)/Q(x^2) on [-tan(pi/8), tan(pi/8)]. */
+static const double AtanNumerator[] = { -8.750608600031904122785e-01,
+		-1.615753718733365076637e+01, -7.500855792314704667340e+01,
+		-1.228866684490136173410e+02, -6.485021904942025371773e+01 };
+
+/** Q(x^2) above, the leading coefficient of 1.0 is implied. */
+static const double AtanDenominator[] = { 2.485846490142306297962e+01,
+		1.650270098316988542046e+02, 4.328810604912902668951e+02,
+		4.853903996359136964868e+02, 1.945506571482613964425e+02 };
+
+/** SinCoefficients shortened by one term, fitted on [-pi/4, pi/4]. */
+static const double ReducedSinCoefficients[] = { 2.72499258030597915064e-06,
+		-1.98400867353848463833e-04, 8.33333187471020815640e-03,
+		-1.66666666638552896096e-01 };
+
+/** CosCoefficients shortened by one term, fitted on [-pi/4, pi/4]. */
+static const double ReducedCosCoefficients[] = { -2.73009592039014691404e-07,
+		2.48006003771567283848e-05, -1.38888876720167893722e-03,
+		4.16666666643212002530e-02 };
+
+/**
+ * atan(x) = x + x^3 P(x^2) on [0, tan(pi/8)], a polynomial fitted instead of
+ * the rational function above.
+ */
+static const double ReducedAtanCoefficients[] = {
+		-4.04322482588716086704e-02, 7.13532512233067822693e-02,
+		-9.02898350035046259876e-02, 1.11074951357144735553e-01,
+		-1.42856125113870163768e-01, 1.99999989172885805910e-01,
+		-3.33333333314407287418e-01 };
+
+/**
+ * Evaluate a polynomial with Horner's rule.
+ * @param x the argument
+ * @param coefficients coefficients, highest order first
+ * @param degree degree of the polynomial
+ */
+template<class V>
+inline V polynomial(const V &x, const double *coefficients, int degree) {
+	V result(coefficients[0]);
+	for (int i = 1; i <= degree; ++i) {
+		result = mulAdd(result, x, V(coefficients[i]));
+	}
+	return result;
+}
+
+/**
+ * Same as polynomial() with an implied leading coefficient of 1.0.
+ */
+template<class V>
+inline V monicPolynomial(const V &x, const double *coefficients,
+		int degree) {
+	V result = x + V(coefficients[0]);
+	for (int i = 1; i < degree; ++i) {
+		result = mulAdd(result, x, V(coefficients[i]));
+	}
+	return result;
+}
+
+/**
+ * Sine and cosine of the same argument with the given polynomials, see
+ * sincos().
+ */
+template<class V>
+inline void sincosWith(const V &x, V &sine, V &cosine,
+		const double *sinCoefficients, const double *cosCoefficients,
+		int degree) {
+	typedef typename V::Mask Mask;
+
+	// x = j * pi/2 + r, |r| <= pi/4
+	V j = round(x * V(TwoOverPi));
+	V r = mulAdd(j, V(-PiOver2Hi), x);
+	r = mulAdd(j, V(-PiOver2Mid), r);
+	r = mulAdd(j, V(-PiOver2Lo), r);
+
+	V z = r * r;
+	V s = mulAdd(r * z, polynomial(z, sinCoefficients, degree), r);
+	V c = mulAdd(z * z, polynomial(z, cosCoefficients, degree),
+			mulAdd(z, V(-0.5), V(1.0)));
+
+	// quadrant 0..3 decides which polynomial gives which result and the signs
+	V quadrant = j - V(4.0) * floor(j * V(0.25));
+	Mask odd = (quadrant == V(1.0)) | (quadrant == V(3.0));
+	Mask negateSine = quadrant >= V(2.0);
+	Mask negateCosine = (quadrant == V(1.0)) | (quadrant == V(2.0));
+
+	V sv = select(odd, c, s);
+	V cv = select(odd, s, c);
+	sine = select(negateSine, -sv, sv);
+	cosine = select(negateCosine, -cv, cv);
+}
+
+/**
+ * Sine and cosine of the same argument. Arguments are reduced by multiples of
+ * pi/2, which keeps full accuracy up to a few thousand radians.
+ */
+template<class V>
+inline void sincos(const V &x, V &sine, V &cosine) {
+	sincosWith(x, sine, cosine, SinCoefficients, CosCoefficients, 5);
+}
+
+/**
+ * Same as sincos() with the reduced accuracy polynomials.
+ */
+template<class V>
+inline void sincosReduced(const V &x, V &sine, V &cosine) {
+	sincosWith(x, sine, cosine, ReducedSinCoefficients,
+			ReducedCosCoefficients, 3);
+}
+
+/**
+ * Arc tangent of an argument in [0, 1].
+ */
+template<class V>
+inline V atanUnit(const V &x) {
+	typedef typename V::Mask Mask;
+
+	// atan(x) = pi/4 + atan((x - 1) / (x + 1))
+	Mask reduce = x > V(TanPiOver8);
+	V t = select(reduce, (x - V(1.0)) / (x + V(1.0)), x);
+
+	V z = t * t;
+	V p = polynomial(z, AtanNumerator, 4)
+			/ monicPolynomial(z, AtanDenominator, 5);
+	V result = mulAdd(t * z, p, t);
+
+	return select(reduce, result + V(0.5 * PiOver2Tail) + V(PiOver4), result);
+}
+
+/**
+ * Same as atanUnit() with the reduced accuracy polynomial.
+ */
+template<class V>
+inline V atanUnitReduced(const V &x) {
+	typedef typename V::Mask Mask;
+
+	Mask reduce = x > V(TanPiOver8);
+	V t = select(reduce, (x - V(1.0)) / (x + V(1.0)), x);
+
+	V z = t * t;
+	V result = mulAdd(t * z, polynomial(z, ReducedAtanCoefficients, 6), t);
+
+	return select(reduce, result + V(PiOver4), result);
+}
+
+/**
+ * Four quadrant arc tangent, see atan2().
+ *
+ * @tparam Reduced use atanUnitReduced() instead of atanUnit()
+ */
+template<class V, bool Reduced>
+inline V atan2With(const V &y, const V &x) {
+	typedef typename V::Mask Mask;
+
+	V ay = abs(y);
+	V ax = abs(x);
+
+	// work with a ratio in [0, 1], both zero gives zero
+	Mask swap = ay > ax;
+	V numerator = select(swap, ax, ay);
+	V denominator = select(swap, ay, ax);
+	V ratio = select(denominator == V(0.0), V(0.0), numerator / denominator);
+
+	V t = Reduced ? atanUnitReduced(ratio) : atanUnit(ratio);
+	t = select(swap, (V(PiOver2) - t) + V(PiOver2Tail), t);
+	t = select(signBits(x), (V(Pi) - t) + V(2.0 * PiOver2Tail), t);
+
+	return xorSign(t, y);
+}
+
+/**
+ * Four quadrant arc tangent with the same conventions as atan2() from the
+ * C library, including signed zeros.
+ */
+template<class V>
+inline V atan2(const V &y, const V &x) {
+	return atan2With<V, false>(y, x);
+}
+
+/**
+ * Same as atan2() with the reduced accuracy polynomial.
+ */
+template<class V>
+inline V atan2Reduced(const V &y, const V &x) {
+	return atan2With<V, true>(y, x);
+}
+
+/**
+ * Arc sine, for arguments in [-1, 1].
+ */
+template<class V>
+inline V asin(const V &x) {
+	return atan2(x, sqrt((V(1.0) - x) * (V(1.0) + x)));
+}
+
+/**
+ * Same as asin() with the reduced accuracy polynomial.
+ */
+template<class V>
+inline V asinReduced(const V &x) {
+	return atan2Reduced(x, sqrt((V(1.0) - x) * (V(1.0) + x)));
+}
+
+} // simd
+
+} // geodesy
+
+#endif /* VECTORMATH_HPP_ */
@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#include "VincentySimd.hpp"
+
+#ifdef GEODESY_HAVE_AVX2
+
+#include <immintrin.h>
+
+#include "VincentyKernel.hpp"
+
+namespace geodesy {
+
+namespace simd {
+
+namespace {
+
+/**
+ * Four doubles in an AVX register. Masks are full width lane masks, of which
+ * only the sign bit matters to blendv and movemask.
+ */
+class Vec4 {
+public:
+	class Mask {
+	public:
+		explicit Mask(__m256d m) :
+				m(m) {
+		}
+		__m256d m;
+	};
+
+	static const std::size_t Size = 4;
+
+	Vec4() {
+	}
+	Vec4(double x) :
+			v(_mm256_set1_pd(x)) {
+	}
+	explicit Vec4(__m256d x) :
+			v(x) {
+	}
+
+	static Vec4 load(const double *p) {
+		return Vec4(_mm256_loadu_pd(p));
+	}
+	void store(double *p) const {
+		_mm256_storeu_pd(p, v);
+	}
+
+	__m256d v;
+};
+
+typedef Vec4::Mask Mask4;
+
+inline Vec4 operator+(const Vec4 &a, const Vec4 &b) {
+	return Vec4(_mm256_add_pd(a.v, b.v));
+}
+inline Vec4 operator-(const Vec4 &a, const Vec4 &b) {
+	return Vec4(_mm256_sub_pd(a.v, b.v));
+}
+inline Vec4 operator*(const Vec4 &a, const Vec4 &b) {
+	return Vec4(_mm256_mul_pd(a.v, b.v));
+}
+inline Vec4 operator/(const Vec4 &a, const Vec4 &b) {
+	return Vec4(_mm256_div_pd(a.v, b.v));
+}
+inline Vec4 operator-(const Vec4 &a) {
+	return Vec4(_mm256_xor_pd(a.v, _mm256_set1_pd(-0.0)));
+}
+
+inline Mask4 operator<(const Vec4 &a, const Vec4 &b) {
+	return Mask4(_mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ));
+}
+inline Mask4 operator>(const Vec4 &a, const Vec4 &b) {
+	return Mask4(_mm256_cmp_pd(a.v, b.v, _CMP_GT_OQ));
+}
+inline Mask4 operator>=(const Vec4 &a, const Vec4 &b) {
+	return Mask4(_mm256_cmp_pd(a.v, b.v, _CMP_GE_OQ));
+}
+inline Mask4 operator==(const Vec4 &a, const Vec4 &b) {
+	return Mask4(_mm256_cmp_pd(a.v, b.v, _CMP_EQ_OQ));
+}
+
+inline Mask4 operator&(const Mask4 &a, const Mask4 &b) {
+	return Mask4(_mm256_and_pd(a.m, b.m));
+}
+inline Mask4 operator|(const Mask4 &a, const Mask4 &b) {
+	return Mask4(_mm256_or_pd(a.m, b.m));
+}
+inline Mask4 operator~(const Mask4 &a) {
+	return Mask4(_mm256_xor_pd(a.m, _mm256_castsi256_pd(_mm256_set1_epi64x(-1))));
+}
+inline bool any(const Mask4 &a) {
+	return _mm256_movemask_pd(a.m) != 0;
+}
+
+inline Vec4 select(const Mask4 &m, const Vec4 &a, const Vec4 &b) {
+	return Vec4(_mm256_blendv_pd(b.v, a.v, m.m));
+}
+inline Vec4 abs(const Vec4 &a) {
+	return Vec4(_mm256_andnot_pd(_mm256_set1_pd(-0.0), a.v));
+}
+inline Vec4 sqrt(const Vec4 &a) {
+	return Vec4(_mm256_sqrt_pd(a.v));
+}
+inline Vec4 round(const Vec4 &a) {
+	return Vec4(_mm256_round_pd(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+}
+inline Vec4 floor(const Vec4 &a) {
+	return Vec4(_mm256_round_pd(a.v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC));
+}
+inline Vec4 mulAdd(const Vec4 &a, const Vec4 &b, const Vec4 &c) {
+	return Vec4(_mm256_fmadd_pd(a.v, b.v, c.v));
+}
+inline Mask4 signBits(const Vec4 &a) {
+	return Mask4(a.v);
+}
+inline Vec4 xorSign(const Vec4 &a, const Vec4 &sign) {
+	return Vec4(_mm256_xor_pd(a.v, _mm256_and_pd(sign.v, _mm256_set1_pd(-0.0))));
+}
+
+void inverseAvx2(double a, double b, double f, double errorTolerance,
+		int maxIterations, std::size_t count, const double *startLatitudes,
+		const double *startLongitudes, const double *endLatitudes,
+		const double *endLongitudes, double *ellipsoidalDistances,
+		double *azimuths, double *reverseAzimuths) {
+	for (std::size_t i = 0; i < count; i += Vec4::Size) {
+		solveInverse<Vec4>(a, b, f, errorTolerance, maxIterations,
+				startLatitudes + i, startLongitudes + i, endLatitudes + i,
+				endLongitudes + i, ellipsoidalDistances + i, azimuths + i,
+				reverseAzimuths + i);
+	}
+}
+
+void directAvx2(double a, double b, double f, double errorTolerance,
+		int maxIterations, std::size_t count, const double *startLatitudes,
+		const double *startLongitudes, const double *startBearings,
+		const double *distances, double *endLatitudes, double *endLongitudes,
+		double *endBearings) {
+	for (std::size_t i = 0; i < count; i += Vec4::Size) {
+		solveDirect<Vec4>(a, b, f, errorTolerance, maxIterations,
+				startLatitudes + i, startLongitudes + i, startBearings + i,
+				distances + i, endLatitudes + i, endLongitudes + i,
+				endBearings + i);
+	}
+}
+
+void preparedInverseAvx2(double a, double b, double f,
+		double errorTolerance, int maxIterations, std::size_t count,
+		const double *startSinU, const double *startCosU,
+		const double *startLambdas, const double *endSinU,
+		const double *endCosU, const double *endLambdas,
+		double *ellipsoidalDistances, double *azimuths,
+		double *reverseAzimuths) {
+	for (std::size_t i = 0; i < count; i += Vec4::Size) {
+		solvePreparedInverse<Vec4>(a, b, f, errorTolerance, maxIterations,
+				startSinU + i, startCosU + i, startLambdas + i, endSinU + i,
+				endCosU + i, endLambdas + i, ellipsoidalDistances + i,
+				azimuths + i, reverseAzimuths + i);
+	}
+}
+
+} // anonymous
+
+const Kernels Avx2Kernels = { "avx2", Vec4::Size, inverseAvx2, directAvx2,
+		preparedInverseAvx2 };
+
+} // simd
+
+} // geodesy
+
+#endif // GEODESY_HAVE_AVX2
@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#include "VincentySimd.hpp"
+
+#ifdef GEODESY_HAVE_AVX512
+
+#include <immintrin.h>
+
+#include "VincentyKernel.hpp"
+
+namespace geodesy {
+
+namespace simd {
+
+namespace {
+
+/**
+ * Eight doubles in an AVX-512 register. Masks are the native mask registers.
+ * Only AVX-512F instructions are used, so the bit operations on doubles go
+ * through the integer domain. Some of the unmasked intrinsics trip
+ * -Wuninitialized in GCC's own headers, their merge masked forms with a full
+ * mask are used instead.
+ */
+class Vec8 {
+public:
+	class Mask {
+	public:
+		explicit Mask(__mmask8 m) :
+				m(m) {
+		}
+		__mmask8 m;
+	};
+
+	static const std::size_t Size = 8;
+
+	Vec8() {
+	}
+	Vec8(double x) :
+			v(_mm512_set1_pd(x)) {
+	}
+	explicit Vec8(__m512d x) :
+			v(x) {
+	}
+
+	static Vec8 load(const double *p) {
+		return Vec8(_mm512_loadu_pd(p));
+	}
+	void store(double *p) const {
+		_mm512_storeu_pd(p, v);
+	}
+
+	__m512d v;
+};
+
+typedef Vec8::Mask Mask8;
+
+static const __mmask8 AllLanes = 0xFF;
+
+inline __m512i bits(__m512d a) {
+	return _mm512_castpd_si512(a);
+}
+inline __m512d fromBits(__m512i a) {
+	return _mm512_castsi512_pd(a);
+}
+inline __m512i signBit() {
+	return _mm512_set1_epi64(static_cast<long long>(0x8000000000000000ULL));
+}
+
+inline Vec8 operator+(const Vec8 &a, const Vec8 &b) {
+	return Vec8(_mm512_add_pd(a.v, b.v));
+}
+inline Vec8 operator-(const Vec8 &a, const Vec8 &b) {
+	return Vec8(_mm512_sub_pd(a.v, b.v));
+}
+inline Vec8 operator*(const Vec8 &a, const Vec8 &b) {
+	return Vec8(_mm512_mul_pd(a.v, b.v));
+}
+inline Vec8 operator/(const Vec8 &a, const Vec8 &b) {
+	return Vec8(_mm512_div_pd(a.v, b.v));
+}
+inline Vec8 operator-(const Vec8 &a) {
+	return Vec8(fromBits(_mm512_xor_si512(bits(a.v), signBit())));
+}
+
+inline Mask8 operator<(const Vec8 &a, const Vec8 &b) {
+	return Mask8(_mm512_cmp_pd_mask(a.v, b.v, _CMP_LT_OQ));
+}
+inline Mask8 operator>(const Vec8 &a, const Vec8 &b) {
+	return Mask8(_mm512_cmp_pd_mask(a.v, b.v, _CMP_GT_OQ));
+}
+inline Mask8 operator>=(const Vec8 &a, const Vec8 &b) {
+	return Mask8(_mm512_cmp_pd_mask(a.v, b.v, _CMP_GE_OQ));
+}
+inline Mask8 operator==(const Vec8 &a, const Vec8 &b) {
+	return Mask8(_mm512_cmp_pd_mask(a.v, b.v, _CMP_EQ_OQ));
+}
+
+inline Mask8 operator&(const Mask8 &a, const Mask8 &b) {
+	return Mask8(a.m & b.m);
+}
+inline Mask8 operator|(const Mask8 &a, const Mask8 &b) {
+	return Mask8(a.m | b.m);
+}
+inline Mask8 operator~(const Mask8 &a) {
+	return Mask8(static_cast<__mmask8>(~a.m));
+}
+inline bool any(const Mask8 &a) {
+	return a.m != 0;
+}
+
+inline Vec8 select(const Mask8 &m, const Vec8 &a, const Vec8 &b) {
+	return Vec8(_mm512_mask_blend_pd(m.m, b.v, a.v));
+}
+inline Vec8 abs(const Vec8 &a) {
+	return Vec8(fromBits(_mm512_mask_andnot_epi64(bits(a.v), AllLanes,
+			signBit(), bits(a.v))));
+}
+inline Vec8 sqrt(const Vec8 &a) {
+	return Vec8(_mm512_mask_sqrt_pd(a.v, AllLanes, a.v));
+}
+inline Vec8 round(const Vec8 &a) {
+	return Vec8(_mm512_mask_roundscale_pd(a.v, AllLanes, a.v,
+			_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+}
+inline Vec8 floor(const Vec8 &a) {
+	return Vec8(_mm512_mask_roundscale_pd(a.v, AllLanes, a.v,
+			_MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC));
+}
+inline Vec8 mulAdd(const Vec8 &a, const Vec8 &b, const Vec8 &c) {
+	return Vec8(_mm512_fmadd_pd(a.v, b.v, c.v));
+}
+inline Mask8 signBits(const Vec8 &a) {
+	return Mask8(_mm512_test_epi64_mask(bits(a.v), signBit()));
+}
+inline Vec8 xorSign(const Vec8 &a, const Vec8 &sign) {
+	return Vec8(fromBits(_mm512_xor_si512(bits(a.v),
+			_mm512_and_si512(bits(sign.v), signBit()))));
+}
+
+void inverseAvx512(double a, double b, double f, double errorTolerance,
+		int maxIterations, std::size_t count, const double *startLatitudes,
+		const double *startLongitudes, const double *endLatitudes,
+		const double *endLongitudes, double *ellipsoidalDistances,
+		double *azimuths, double *reverseAzimuths) {
+	for (std::size_t i = 0; i < count; i += Vec8::Size) {
+		solveInverse<Vec8>(a, b, f, errorTolerance, maxIterations,
+				startLatitudes + i, startLongitudes + i, endLatitudes + i,
+				endLongitudes + i, ellipsoidalDistances + i, azimuths + i,
+				reverseAzimuths + i);
+	}
+}
+
+void directAvx512(double a, double b, double f, double errorTolerance,
+		int maxIterations, std::size_t count, const double *startLatitudes,
+		const double *startLongitudes, const double *startBearings,
+		const double *distances, double *endLatitudes, double *endLongitudes,
+		double *endBearings) {
+	for (std::size_t i = 0; i < count; i += Vec8::Size) {
+		solveDirect<Vec8>(a, b, f, errorTolerance, maxIterations,
+				startLatitudes + i, startLongitudes + i, startBearings + i,
+				distances + i, endLatitudes + i, endLongitudes + i,
+				endBearings + i);
+	}
+}
+
+void preparedInverseAvx512(double a, double b, double f,
+		double errorTolerance, int maxIterations, std::size_t count,
+		const double *startSinU, const double *startCosU,
+		const double *startLambdas, const double *endSinU,
+		const double *endCosU, const double *endLambdas,
+		double *ellipsoidalDistances, double *azimuths,
+		double *reverseAzimuths) {
+	for (std::size_t i = 0; i < count; i += Vec8::Size) {
+		solvePreparedInverse<Vec8>(a, b, f, errorTolerance, maxIterations,
+				startSinU + i, startCosU + i, startLambdas + i, endSinU + i,
+				endCosU + i, endLambdas + i, ellipsoidalDistances + i,
+				azimuths + i, reverseAzimuths + i);
+	}
+}
+
+} // anonymous
+
+const Kernels Avx512Kernels = { "avx512", Vec8::Size, inverseAvx512, directAvx512,
+		preparedInverseAvx512 };
+
+} // simd
+
+} // geodesy
+
+#endif // GEODESY_HAVE_AVX512
@@ -0,0 +1,396 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#ifndef VINCENTYKERNEL_HPP_
+#define VINCENTYKERNEL_HPP_
+
+#include <limits>
+
+#include "VectorMath.hpp"
+
+/**
+ * Vincenty's formulae written against the lane types of VectorMath.hpp, so
+ * that one call solves V::Size problems at once. These are instantiated by
+ * the instruction set specific sources and are not meant to be used directly;
+ * see VincentySimd.hpp.
+ */
+namespace geodesy {
+
+namespace simd {
+
+static const double DegreesToRadians = 1.74532925199432954744e-02;
+static const double RadiansToDegrees = 5.72957795130823228646e+01;
+
+/**
+ * Solve V::Size inverse problems given the sine and cosine of the reduced
+ * latitudes and the longitudes in radians of the points, see
+ * solveInverse().
+ */
+template<class V>
+inline void solveReducedInverse(double a, double b, double f,
+		double errorTolerance, int maxIterations, V sinU1, V cosU1,
+		V lambda1, V sinU2, V cosU2, V lambda2, double *ellipsoidalDistances,
+		double *azimuths, double *reverseAzimuths) {
+	typedef typename V::Mask Mask;
+
+	// calculations
+	double a2 = a * a;
+	double b2 = b * b;
+	V a2b2b2((a2 - b2) / b2);
+	V flattening(f);
+
+	V omega = lambda2 - lambda1;
+
+	V sinU1sinU2 = sinU1 * sinU2;
+	V cosU1sinU2 = cosU1 * sinU2;
+	V sinU1cosU2 = sinU1 * cosU2;
+	V cosU1cosU2 = cosU1 * cosU2;
+
+	// eq. 13
+	V lambda = omega;
+
+	// intermediates we'll need to compute 's'
+	V A(0.0);
+	V B(0.0);
+	V sigma(0.0);
+	V deltasigma(0.0);
+	V zero(0.0);
+	V one(1.0);
+	V two(2.0);
+	V three(3.0);
+	V four(4.0);
+
+	Mask active = zero == zero;
+	Mask converged = ~active;
+
+	for (int i = 0; i < maxIterations && any(active); i++) {
+		V lambda0 = lambda;
+
+		V sinlambda, coslambda;
+		sincos(lambda, sinlambda, coslambda);
+
+		// eq. 14
+		V t = cosU1sinU2 - sinU1cosU2 * coslambda;
+		V sin2sigma = (cosU2 * sinlambda * cosU2 * sinlambda) + t * t;
+		V sinsigma = sqrt(sin2sigma);
+
+		// eq. 15
+		V cossigma = sinU1sinU2 + (cosU1cosU2 * coslambda);
+
+		// eq. 16
+		V newSigma = atan2(sinsigma, cossigma);
+
+		// eq. 17 Careful! sin2sigma might be almost 0!
+		V sinalpha = select(sin2sigma == zero, zero,
+				cosU1cosU2 * sinlambda / sinsigma);
+		V cos2alpha = one - sinalpha * sinalpha;
+
+		// eq. 18 Careful! cos2alpha might be almost 0!
+		V cos2sigmam = select(cos2alpha == zero, zero,
+				cossigma - two * sinU1sinU2 / cos2alpha);
+		V u2 = cos2alpha * a2b2b2;
+
+		V cos2sigmam2 = cos2sigmam * cos2sigmam;
+
+		// eq. 3
+		V newA = one
+				+ u2 / V(16384)
+						* (V(4096) + u2 * (V(-768) + u2 * (V(320) - V(175) * u2)));
+
+		// eq. 4
+		V newB = u2 / V(1024) * (V(256) + u2 * (V(-128) + u2 * (V(74) - V(47) * u2)));
+
+		// eq. 6
+		V newDeltasigma = newB * sinsigma
+				* (cos2sigmam
+						+ newB / four
+								* (cossigma * (two * cos2sigmam2 - one)
+										- newB / V(6.0) * cos2sigmam
+												* (four * sin2sigma - three)
+												* (four * cos2sigmam2 - three)));
+
+		// eq. 10
+		V C = flattening / V(16.0) * cos2alpha
+				* (four + flattening * (four - three * cos2alpha));
+
+		// eq. 11 (modified)
+		V newLambda = omega
+				+ (one - C) * flattening * sinalpha
+						* (newSigma
+								+ C * sinsigma
+										* (cos2sigmam
+												+ C * cossigma
+														* (two * cos2sigmam2
+																- one)));
+
+		// only lanes still iterating take the new values
+		lambda = select(active, newLambda, lambda);
+		A = select(active, newA, A);
+		B = select(active, newB, B);
+		sigma = select(active, newSigma, sigma);
+		deltasigma = select(active, newDeltasigma, deltasigma);
+
+		// see how much improvement we got
+		if (i > 1) {
+			V change = abs((lambda - lambda0) / lambda);
+			Mask done = active & (change < V(errorTolerance));
+			converged = converged | done;
+			active = active & ~done;
+		}
+	}
+
+	// eq. 19
+	V s = V(b) * A * (sigma - deltasigma);
+	s.store(ellipsoidalDistances);
+
+	V sinlambda, coslambda;
+	sincos(lambda, sinlambda, coslambda);
+
+	// eq. 20
+	V twoPi(2.0 * Pi);
+	V radians = atan2(cosU2 * sinlambda, cosU1sinU2 - sinU1cosU2 * coslambda);
+	radians = select(radians < zero, radians + twoPi, radians);
+	V alpha1 = radians * V(RadiansToDegrees);
+
+	// eq. 21
+	radians = atan2(cosU1 * sinlambda, cosU1sinU2 * coslambda - sinU1cosU2)
+			+ V(Pi);
+	radians = select(radians < zero, radians + twoPi, radians);
+	V alpha2 = radians * V(RadiansToDegrees);
+
+	// didn't converge? must be N/S
+	V nan(std::numeric_limits<double>::quiet_NaN());
+	V v0(0.0);
+	V v180(180.0);
+	Mask south = sinU1 > sinU2;
+	Mask north = sinU1 < sinU2;
+	V fallback1 = select(south, v180, select(north, v0, nan));
+	V fallback2 = select(south, v0, select(north, v180, nan));
+	alpha1 = select(converged, alpha1, fallback1);
+	alpha2 = select(converged, alpha2, fallback2);
+
+	V v360(360.0);
+	alpha1 = select(alpha1 >= v360, alpha1 - v360, alpha1);
+	alpha2 = select(alpha2 >= v360, alpha2 - v360, alpha2);
+
+	alpha1.store(azimuths);
+	alpha2.store(reverseAzimuths);
+}
+
+/**
+ * Solve V::Size inverse problems. The arrays must hold V::Size canonical
+ * coordinates each. The results match
+ * GeodeticCalculator::calculateGeodeticCurve() closely but not bit for bit;
+ * the reduced latitudes are found without tan() and atan(), and cos^2(alpha)
+ * is 1 - sin^2(alpha) rather than a round trip through asin() and cos().
+ *
+ * The iteration carries on until every lane has converged or maxIterations
+ * is reached. Once a lane converges its values are frozen while the other
+ * lanes keep going, so every lane sees exactly the iterations the scalar
+ * code would.
+ */
+template<class V>
+inline void solveInverse(double a, double b, double f,
+		double errorTolerance, int maxIterations, const double *startLatitudes,
+		const double *startLongitudes, const double *endLatitudes,
+		const double *endLongitudes, double *ellipsoidalDistances,
+		double *azimuths, double *reverseAzimuths) {
+	// get parameters as radians
+	V phi1 = V::load(startLatitudes) * V(DegreesToRadians);
+	V lambda1 = V::load(startLongitudes) * V(DegreesToRadians);
+	V phi2 = V::load(endLatitudes) * V(DegreesToRadians);
+	V lambda2 = V::load(endLongitudes) * V(DegreesToRadians);
+
+	// reduced latitudes, tan(U) = (1 - f) tan(phi) without the tan()
+	V oneMinusF(1.0 - f);
+	V sinPhi1, cosPhi1, sinPhi2, cosPhi2;
+	sincos(phi1, sinPhi1, cosPhi1);
+	sincos(phi2, sinPhi2, cosPhi2);
+	V y1 = oneMinusF * sinPhi1;
+	V h1 = sqrt(y1 * y1 + cosPhi1 * cosPhi1);
+	V y2 = oneMinusF * sinPhi2;
+	V h2 = sqrt(y2 * y2 + cosPhi2 * cosPhi2);
+
+	solveReducedInverse<V>(a, b, f, errorTolerance, maxIterations, y1 / h1,
+			cosPhi1 / h1, lambda1, y2 / h2, cosPhi2 / h2, lambda2,
+			ellipsoidalDistances, azimuths, reverseAzimuths);
+}
+
+/**
+ * Solve V::Size inverse problems between points prepared once up front, see
+ * PreparedInverseKernel in VincentySimd.hpp.
+ */
+template<class V>
+inline void solvePreparedInverse(double a, double b, double f,
+		double errorTolerance, int maxIterations, const double *startSinU,
+		const double *startCosU, const double *startLambdas,
+		const double *endSinU, const double *endCosU,
+		const double *endLambdas, double *ellipsoidalDistances,
+		double *azimuths, double *reverseAzimuths) {
+	solveReducedInverse<V>(a, b, f, errorTolerance, maxIterations,
+			V::load(startSinU), V::load(startCosU), V::load(startLambdas),
+			V::load(endSinU), V::load(endCosU), V::load(endLambdas),
+			ellipsoidalDistances, azimuths, reverseAzimuths);
+}
+
+/**
+ * Solve V::Size direct problems. The arrays must hold V::Size canonical
+ * starting coordinates each; the ending longitudes are not canonicalized.
+ * Lanes are iterated and frozen the same way as in solveInverse().
+ */
+template<class V>
+inline void solveDirect(double a, double b, double f, double errorTolerance,
+		int maxIterations, const double *startLatitudes,
+		const double *startLongitudes, const double *startBearings,
+		const double *distances, double *endLatitudes, double *endLongitudes,
+		double *endBearings) {
+	typedef typename V::Mask Mask;
+
+	double aSquared = a * a;
+	double bSquared = b * b;
+	V flattening(f);
+	V oneMinusF(1.0 - f);
+	V zero(0.0);
+	V one(1.0);
+	V two(2.0);
+	V three(3.0);
+	V four(4.0);
+
+	V phi1 = V::load(startLatitudes) * V(DegreesToRadians);
+	V alpha1 = V::load(startBearings) * V(DegreesToRadians);
+	V s = V::load(distances);
+
+	V sinAlpha1, cosAlpha1;
+	sincos(alpha1, sinAlpha1, cosAlpha1);
+
+	// reduced latitude, tan(U1) = (1 - f) tan(phi1) without the tan()
+	V sinPhi1, cosPhi1;
+	sincos(phi1, sinPhi1, cosPhi1);
+	V y1 = oneMinusF * sinPhi1;
+	V h1 = sqrt(y1 * y1 + cosPhi1 * cosPhi1);
+	V sinU1 = y1 / h1;
+	V cosU1 = cosPhi1 / h1;
+
+	// eq. 1
+	V sigma1 = atan2(sinU1, cosU1 * cosAlpha1);
+
+	// eq. 2
+	V sinAlpha = cosU1 * sinAlpha1;
+
+	V sin2Alpha = sinAlpha * sinAlpha;
+	V cos2Alpha = one - sin2Alpha;
+	V uSquared = cos2Alpha * V((aSquared - bSquared) / bSquared);
+
+	// eq. 3
+	V A = one
+			+ (uSquared / V(16384))
+					* (V(4096)
+							+ uSquared * (V(-768) + uSquared * (V(320) - V(175) * uSquared)));
+
+	// eq. 4
+	V B = (uSquared / V(1024))
+			* (V(256) + uSquared * (V(-128) + uSquared * (V(74) - V(47) * uSquared)));
+
+	// iterate until there is a negligible change in sigma
+	V sOverbA = s / (V(b) * A);
+	V sigma = sOverbA;
+	V prevSigma = sOverbA;
+
+	Mask active = zero == zero;
+
+	for (int iteration = 0; iteration < maxIterations && any(active);
+			++iteration) {
+		// eq. 5
+		V sigmaM2 = two * sigma1 + sigma;
+		V sinSigmaM2, cosSigmaM2;
+		sincos(sigmaM2, sinSigmaM2, cosSigmaM2);
+		V cos2SigmaM2 = cosSigmaM2 * cosSigmaM2;
+		V sinSigma, cosSigma;
+		sincos(sigma, sinSigma, cosSigma);
+
+		// eq. 6
+		V deltaSigma = B * sinSigma
+				* (cosSigmaM2
+						+ (B / four)
+								* (cosSigma * (two * cos2SigmaM2 - one)
+										- (B / V(6.0)) * cosSigmaM2
+												* (four * sinSigma * sinSigma - three)
+												* (four * cos2SigmaM2 - three)));
+
+		// eq. 7
+		sigma = select(active, sOverbA + deltaSigma, sigma);
+
+		// break after converging to tolerance
+		active = active & ~(abs(sigma - prevSigma) < V(errorTolerance));
+
+		prevSigma = select(active, sigma, prevSigma);
+	}
+
+	V sigmaM2 = two * sigma1 + sigma;
+	V sinSigmaM2, cosSigmaM2;
+	sincos(sigmaM2, sinSigmaM2, cosSigmaM2);
+	V cos2SigmaM2 = cosSigmaM2 * cosSigmaM2;
+
+	V sinSigma, cosSigma;
+	sincos(sigma, sinSigma, cosSigma);
+
+	// eq. 8
+	V x = sinU1 * sinSigma - cosU1 * cosSigma * cosAlpha1;
+	V phi2 = atan2(sinU1 * cosSigma + cosU1 * sinSigma * cosAlpha1,
+			oneMinusF * sqrt(sin2Alpha + x * x));
+
+	// eq. 9
+	V lambda = atan2(sinSigma * sinAlpha1,
+			cosU1 * cosSigma - sinU1 * sinSigma * cosAlpha1);
+
+	// eq. 10
+	V C = flattening / V(16.0) * cos2Alpha
+			* (four + flattening * (four - three * cos2Alpha));
+
+	// eq. 11
+	V L = lambda
+			- (one - C) * flattening * sinAlpha
+					* (sigma
+							+ C * sinSigma
+									* (cosSigmaM2
+											+ C * cosSigma * (two * cos2SigmaM2 - one)));
+
+	// eq. 12
+	V alpha2 = atan2(sinAlpha, cosU1 * cosSigma * cosAlpha1 - sinU1 * sinSigma);
+
+	// build result
+	(phi2 * V(RadiansToDegrees)).store(endLatitudes);
+	(V::load(startLongitudes) + L * V(RadiansToDegrees)).store(endLongitudes);
+	(alpha2 * V(RadiansToDegrees)).store(endBearings);
+}
+
+} // simd
+
+} // geodesy
+
+#endif /* VINCENTYKERNEL_HPP_ */
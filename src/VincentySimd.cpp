@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#include "VincentySimd.hpp"
+
+namespace geodesy {
+
+namespace simd {
+
+/**
+ * The kernels supported by this processor, detected once.
+ */
+class KernelTable {
+public:
+	KernelTable() :
+			mCount(0) {
+#if defined(GEODESY_HAVE_AVX2) || defined(GEODESY_HAVE_AVX512)
+		__builtin_cpu_init();
+#endif
+
+#ifdef GEODESY_HAVE_AVX512
+		if (__builtin_cpu_supports("avx512f")) {
+			mKernels[mCount++] = Avx512Kernels;
+		}
+#endif
+
+#ifdef GEODESY_HAVE_AVX2
+		if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+			mKernels[mCount++] = Avx2Kernels;
+		}
+#endif
+	}
+
+	const Kernels *get(std::size_t &count) const {
+		count = mCount;
+		return mCount > 0 ? mKernels : 0;
+	}
+
+private:
+	Kernels mKernels[2];
+	std::size_t mCount;
+};
+
+const Kernels *availableKernels(std::size_t &count) {
+	static const KernelTable table;
+	return table.get(count);
+}
+
+const Kernels *bestKernels() {
+	std::size_t count;
+	return availableKernels(count);
+}
+
+} // simd
+
+} // geodesy
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#ifndef VINCENTYSIMD_HPP_
+#define VINCENTYSIMD_HPP_
+
+#include <cstddef>
+
+/**
+ * Entry points of the SIMD versions of Vincenty's formulae. The kernels are
+ * built for each instruction set the compiler supports and picked at run time
+ * based on what the processor supports. The batch methods of
+ * GeodeticCalculator use them when available.
+ */
+namespace geodesy {
+
+namespace simd {
+
+/**
+ * Solve count inverse problems. count must be a multiple of the lane count of
+ * the kernel and the coordinates must be canonical (degrees). All outputs are
+ * written.
+ *
+ * @see GeodeticCalculator::calculateGeodeticCurves()
+ */
+typedef void (*InverseKernel)(double a, double b, double f,
+		double errorTolerance, int maxIterations, std::size_t count,
+		const double *startLatitudes, const double *startLongitudes,
+		const double *endLatitudes, const double *endLongitudes,
+		double *ellipsoidalDistances, double *azimuths,
+		double *reverseAzimuths);
+
+/**
+ * Solve count inverse problems between prepared points: the sine and cosine
+ * of the reduced latitude and the longitude in radians of each point. count
+ * must be a multiple of the lane count of the kernel. All outputs are
+ * written.
+ *
+ * @see DistanceMatrix
+ */
+typedef void (*PreparedInverseKernel)(double a, double b, double f,
+		double errorTolerance, int maxIterations, std::size_t count,
+		const double *startSinU, const double *startCosU,
+		const double *startLambdas, const double *endSinU,
+		const double *endCosU, const double *endLambdas,
+		double *ellipsoidalDistances, double *azimuths,
+		double *reverseAzimuths);
+
+/**
+ * Solve count direct problems. count must be a multiple of the lane count of
+ * the kernel and the starting coordinates must be canonical (degrees). The
+ * ending longitudes are not canonicalized. All outputs are written.
+ *
+ * @see GeodeticCalculator::calculateEndingGlobalCoordinates()
+ */
+typedef void (*DirectKernel)(double a, double b, double f,
+		double errorTolerance, int maxIterations, std::size_t count,
+		const double *startLatitudes, const double *startLongitudes,
+		const double *startBearings, const double *distances,
+		double *endLatitudes, double *endLongitudes, double *endBearings);
+
+/**
+ * The kernels built for one instruction set.
+ */
+struct Kernels {
+	/** Name of the instruction set. */
+	const char *name;
+
+	/** Number of problems solved per step. */
+	std::size_t lanes;
+
+	/** The inverse problem. */
+	InverseKernel inverse;
+
+	/** The direct problem. */
+	DirectKernel direct;
+
+	/** The inverse problem between prepared points. */
+	PreparedInverseKernel preparedInverse;
+};
+
+/** The largest lane count of any kernel, useful for padding. */
+static const std::size_t MaxLanes = 8;
+
+/**
+ * Get the kernels this processor can run, fastest first.
+ *
+ * @param count number of entries in the returned array (output value)
+ * @return the kernels, may be NULL if count is 0
+ */
+const Kernels *availableKernels(std::size_t &count);
+
+/**
+ * Get the fastest kernels this processor can run.
+ *
+ * @return the kernels or NULL if no SIMD kernels are available
+ */
+const Kernels *bestKernels();
+
+#ifdef GEODESY_HAVE_AVX2
+/** AVX2 and FMA, 4 lanes. */
+extern const Kernels Avx2Kernels;
+#endif
+
+#ifdef GEODESY_HAVE_AVX512
+/** AVX-512F, 8 lanes. */
+extern const Kernels Avx512Kernels;
+#endif
+
+} // simd
+
+} // geodesy
+
+#endif /* VINCENTYSIMD_HPP_ */
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#include "ApproximateInverseTest.hpp"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <ApproximateInverse.hpp>
+#include <GeodeticCalculator.hpp>
+#include <KarneyInverse.hpp>
+#include <cmath>
+
+using namespace geodesy;
+using namespace std;
+using namespace std::tr1;
+CPPUNIT_TEST_SUITE_REGISTRATION( ApproximateInverseTest );
+
+void ApproximateInverseTest::testHaversine() {
+	shared_ptr<const Ellipsoid> reference = Ellipsoid::WGS84();
+	double a = reference->getSemiMajorAxis();
+	double b = reference->getSemiMinorAxis();
+	double radius = (2 * a + b) / 3;
+	double s, alpha1, alpha2;
+
+	// along the equator
+	ApproximateInverse::haversine(a, b, 0, 10, 0, 20, s, alpha1, alpha2);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(radius * M_PI / 18, s, 0.000001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(90.0, alpha1, 0.0000000001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(270.0, alpha2, 0.0000000001);
+
+	// along a meridian, southward
+	ApproximateInverse::haversine(a, b, 50, 5, 40, 5, s, alpha1, alpha2);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(radius * M_PI / 18, s, 0.000001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(180.0, alpha1, 0.0000000001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, alpha2, 0.0000000001);
+
+	// coincident points
+	ApproximateInverse::haversine(a, b, 10, 20, 10, 20, s, alpha1, alpha2);
+	CPPUNIT_ASSERT_EQUAL(0.0, s);
+	CPPUNIT_ASSERT(!isnan(alpha1));
+	CPPUNIT_ASSERT(!isnan(alpha2));
+
+	// antipodal
+	ApproximateInverse::haversine(a, b, 30, 0, -30, 180, s, alpha1, alpha2);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(radius * M_PI, s, 0.000001);
+}
+
+void ApproximateInverseTest::testAndoyerLambert() {
+	shared_ptr<const Ellipsoid> reference = Ellipsoid::WGS84();
+	double a = reference->getSemiMajorAxis();
+	double f = reference->getFlattening();
+	double s, alpha1, alpha2;
+
+	// Lincoln Memorial to Eiffel Tower, Vincenty gives 6179016.136
+	ApproximateInverse::andoyerLambert(a, f, 38.88922, -77.04978, 48.85889,
+			2.29583, s, alpha1, alpha2);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(6179016.136, s, 10);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(51.76792142, alpha1, 0.2);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(291.75529334, alpha2, 0.2);
+
+	// along the equator the correction vanishes
+	ApproximateInverse::andoyerLambert(a, f, 0, 10, 0, 20, s, alpha1, alpha2);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(a * M_PI / 18, s, 0.000001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(90.0, alpha1, 0.0000000001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(270.0, alpha2, 0.0000000001);
+
+	// coincident and antipodal points stay finite
+	ApproximateInverse::andoyerLambert(a, f, 10, 20, 10, 20, s, alpha1,
+			alpha2);
+	CPPUNIT_ASSERT_EQUAL(0.0, s);
+	ApproximateInverse::andoyerLambert(a, f, 0, 0, 0, 180, s, alpha1, alpha2);
+	CPPUNIT_ASSERT(!isnan(s));
+	ApproximateInverse::andoyerLambert(a, f, 90, 0, -90, 0, s, alpha1, alpha2);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(20003931.458625, s, 1000);
+}
+
+void ApproximateInverseTest::testErrorBounds() {
+	shared_ptr<const Ellipsoid> reference = Ellipsoid::WGS84();
+	double a = reference->getSemiMajorAxis();
+	double b = reference->getSemiMinorAxis();
+	double f = reference->getFlattening();
+	KarneyInverse inverse(*reference);
+
+	// the documented worst cases on a grid of lines up to 10000 km
+	for (int lat1 = -85; lat1 <= 85; lat1 += 17) {
+		for (int lat2 = -85; lat2 <= 85; lat2 += 17) {
+			for (int lon2 = 0; lon2 <= 180; lon2 += 15) {
+				double s, alpha1, alpha2;
+				inverse.solve(lat1, 0, lat2, lon2, s, alpha1, alpha2);
+				if (s < 1000 || s > 10000000) {
+					continue;
+				}
+
+				double sh, ah1, ah2;
+				ApproximateInverse::haversine(a, b, lat1, 0, lat2, lon2, sh,
+						ah1, ah2);
+				CPPUNIT_ASSERT(fabs(sh - s) <= 0.0056 * s);
+
+				double sl, al1, al2;
+				ApproximateInverse::andoyerLambert(a, f, lat1, 0, lat2, lon2,
+						sl, al1, al2);
+				CPPUNIT_ASSERT(fabs(sl - s) <= 1.4E-6 * s);
+				CPPUNIT_ASSERT(fabs(remainder(al1 - alpha1, 360)) <= 0.2);
+				CPPUNIT_ASSERT(fabs(remainder(al2 - alpha2, 360)) <= 0.2);
+			}
+		}
+	}
+}
+
+void ApproximateInverseTest::testMethodSelection() {
+	shared_ptr<const Ellipsoid> reference = Ellipsoid::WGS84();
+	double a = reference->getSemiMajorAxis();
+	double b = reference->getSemiMinorAxis();
+	double f = reference->getFlattening();
+
+	const double lat1[] = { 38.88922, 0, -30, 10, 0 };
+	const double lon1[] = { -77.04978, 0, 0, 20, 370 };
+	const double lat2[] = { 48.85889, 0.5, 29.9, 10, 0 };
+	const double lon2[] = { 2.29583, 179.7, 179.8, 20, 180 };
+	const size_t count = sizeof(lat1) / sizeof(lat1[0]);
+
+	double distances[count];
+	double azimuths[count];
+	double reverseAzimuths[count];
+	GeodeticCalculator::calculateGeodeticCurves(reference, count, lat1, lon1,
+			lat2, lon2, distances, azimuths, reverseAzimuths,
+			GeodeticCalculator::Haversine);
+
+	for (size_t i = 0; i < count; ++i) {
+		GlobalCoordinates start(lat1[i], lon1[i]);
+		GlobalCoordinates end(lat2[i], lon2[i]);
+		double s, alpha1, alpha2;
+		ApproximateInverse::haversine(a, b, start.getLatitude(),
+				start.getLongitude(), end.getLatitude(), end.getLongitude(), s,
+				alpha1, alpha2);
+		CPPUNIT_ASSERT_EQUAL(s, distances[i]);
+		CPPUNIT_ASSERT_EQUAL(alpha1, azimuths[i]);
+		CPPUNIT_ASSERT_EQUAL(alpha2, reverseAzimuths[i]);
+
+		GeodeticCurveValue curve = GeodeticCalculator::calculateGeodeticCurve(
+				*reference, start, end, GeodeticCalculator::Haversine);
+		CPPUNIT_ASSERT_EQUAL(s, curve.ellipsoidalDistance);
+	}
+
+	GeodeticCalculator::calculateGeodeticCurves(reference, count, lat1, lon1,
+			lat2, lon2, distances, azimuths, reverseAzimuths,
+			GeodeticCalculator::AndoyerLambert);
+
+	for (size_t i = 0; i < count; ++i) {
+		GlobalCoordinates start(lat1[i], lon1[i]);
+		GlobalCoordinates end(lat2[i], lon2[i]);
+		double s, alpha1, alpha2;
+		ApproximateInverse::andoyerLambert(a, f, start.getLatitude(),
+				start.getLongitude(), end.getLatitude(), end.getLongitude(), s,
+				alpha1, alpha2);
+		CPPUNIT_ASSERT_EQUAL(s, distances[i]);
+		CPPUNIT_ASSERT_EQUAL(alpha1, azimuths[i]);
+		CPPUNIT_ASSERT_EQUAL(alpha2, reverseAzimuths[i]);
+
+		GeodeticCurve::Ptr curve = GeodeticCalculator::calculateGeodeticCurve(
+				reference, start, end, GeodeticCalculator::AndoyerLambert);
+		CPPUNIT_ASSERT_EQUAL(s, curve->getEllipsoidalDistance());
+		CPPUNIT_ASSERT_EQUAL(alpha1, curve->getAzimuth());
+		CPPUNIT_ASSERT_EQUAL(alpha2, curve->getReverseAzimuth());
+	}
+}
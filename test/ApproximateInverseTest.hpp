@@ -0,0 +1,29 @@
+#ifndef GEODESY_APPROXIMATE_INVERSE_TEST_HPP
+#define GEODESY_APPROXIMATE_INVERSE_TEST_HPP
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <ApproximateInverse.hpp>
+
+class ApproximateInverseTest: public CppUnit::TestFixture {
+
+CPPUNIT_TEST_SUITE( ApproximateInverseTest);
+
+		// list all test methods here
+		CPPUNIT_TEST(testHaversine);
+		CPPUNIT_TEST(testAndoyerLambert);
+		CPPUNIT_TEST(testErrorBounds);
+		CPPUNIT_TEST(testMethodSelection);
+
+	CPPUNIT_TEST_SUITE_END();
+
+protected:
+	void testHaversine();
+	void testAndoyerLambert();
+	void testErrorBounds();
+	void testMethodSelection();
+
+};
+
+#endif // GEODESY_APPROXIMATE_INVERSE_TEST_HPP
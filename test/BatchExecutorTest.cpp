@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#include "BatchExecutorTest.hpp"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <BatchExecutor.hpp>
+#include <GeodeticCalculator.hpp>
+#include <cmath>
+#include <vector>
+
+using namespace geodesy;
+using namespace std;
+using namespace std::tr1;
+CPPUNIT_TEST_SUITE_REGISTRATION( BatchExecutorTest );
+
+namespace {
+
+/**
+ * Counts how often each item is visited.
+ */
+class CountingTask: public BatchExecutor::Task {
+public:
+	explicit CountingTask(size_t count) :
+			mVisits(count, 0) {
+	}
+
+	virtual void run(size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			__sync_fetch_and_add(&mVisits[i], 1);
+		}
+	}
+
+	vector<int> mVisits;
+};
+
+/**
+ * Throws for the chunk containing item 0.
+ */
+class FailingTask: public BatchExecutor::Task {
+public:
+	virtual void run(size_t begin, size_t) {
+		if (begin == 0) {
+			throw InvalidAzimuthException();
+		}
+	}
+};
+
+/**
+ * Fill the arrays with pseudo-random points all over the globe.
+ */
+void randomPoints(size_t count, vector<double> &latitudes,
+		vector<double> &longitudes, unsigned seed) {
+	latitudes.resize(count);
+	longitudes.resize(count);
+	for (size_t i = 0; i < count; ++i) {
+		seed = seed * 1103515245 + 12345;
+		latitudes[i] = (seed % 1800000) / 10000.0 - 90;
+		seed = seed * 1103515245 + 12345;
+		longitudes[i] = (seed % 3600000) / 10000.0 - 180;
+	}
+}
+
+}
+
+void BatchExecutorTest::testCoversEveryItem() {
+	BatchExecutor executor(4);
+	CPPUNIT_ASSERT_EQUAL(4u, executor.getThreadCount());
+
+	// chunk sizes that do and don't divide the count, fewer chunks than
+	// threads, and an empty batch
+	const size_t counts[] = { 10007, 10000, 3, 0 };
+	const size_t chunkSizes[] = { 7, 100, 512, 1 };
+	for (size_t c = 0; c < 4; ++c) {
+		CountingTask task(counts[c]);
+		executor.run(task, counts[c], chunkSizes[c]);
+		for (size_t i = 0; i < counts[c]; ++i) {
+			CPPUNIT_ASSERT_EQUAL(1, task.mVisits[i]);
+		}
+	}
+
+	BatchExecutor automatic;
+	CPPUNIT_ASSERT(automatic.getThreadCount() > 0);
+}
+
+void BatchExecutorTest::testGeodeticCurves() {
+	shared_ptr<const Ellipsoid> reference = Ellipsoid::WGS84();
+
+	const size_t count = 5000;
+	vector<double> lat1, lon1, lat2, lon2;
+	randomPoints(count, lat1, lon1, 1);
+	randomPoints(count, lat2, lon2, 2);
+
+	vector<double> s(count), az1(count), az2(count);
+	BatchExecutor executor(3);
+	executor.calculateGeodeticCurves(reference, count, &lat1[0], &lon1[0],
+			&lat2[0], &lon2[0], &s[0], &az1[0], &az2[0]);
+
+	vector<double> expectedS(count), expectedAz1(count), expectedAz2(count);
+	GeodeticCalculator::calculateGeodeticCurves(reference, count, &lat1[0],
+			&lon1[0], &lat2[0], &lon2[0], &expectedS[0], &expectedAz1[0],
+			&expectedAz2[0]);
+
+	for (size_t i = 0; i < count; ++i) {
+		CPPUNIT_ASSERT_EQUAL(expectedS[i], s[i]);
+		CPPUNIT_ASSERT_EQUAL(expectedAz1[i], az1[i]);
+		CPPUNIT_ASSERT_EQUAL(expectedAz2[i], az2[i]);
+	}
+}
+
+void BatchExecutorTest::testEndingGlobalCoordinates() {
+	shared_ptr<const Ellipsoid> reference = Ellipsoid::WGS84();
+
+	const size_t count = 5000;
+	vector<double> lat, lon, bearing, distance;
+	randomPoints(count, lat, lon, 3);
+	randomPoints(count, bearing, distance, 4);
+	for (size_t i = 0; i < count; ++i) {
+		distance[i] = fabs(distance[i]) * 100000;
+	}
+
+	vector<double> endLat(count), endLon(count), endBearing(count);
+	BatchExecutor executor(3);
+	executor.calculateEndingGlobalCoordinates(reference, count, &lat[0],
+			&lon[0], &bearing[0], &distance[0], &endLat[0], &endLon[0],
+			&endBearing[0]);
+
+	vector<double> expectedLat(count), expectedLon(count), expectedBearing(
+			count);
+	GeodeticCalculator::calculateEndingGlobalCoordinates(reference, count,
+			&lat[0], &lon[0], &bearing[0], &distance[0], &expectedLat[0],
+			&expectedLon[0], &expectedBearing[0]);
+
+	for (size_t i = 0; i < count; ++i) {
+		CPPUNIT_ASSERT_EQUAL(expectedLat[i], endLat[i]);
+		CPPUNIT_ASSERT_EQUAL(expectedLon[i], endLon[i]);
+		CPPUNIT_ASSERT_EQUAL(expectedBearing[i], endBearing[i]);
+	}
+
+	// a NaN bearing is reported on the calling thread
+	bearing[count / 2] = nan("foo");
+	bool exception = false;
+	try {
+		executor.calculateEndingGlobalCoordinates(reference, count, &lat[0],
+				&lon[0], &bearing[0], &distance[0], &endLat[0], &endLon[0], 0);
+	} catch (InvalidAzimuthException &e) {
+		exception = true;
+	}
+	CPPUNIT_ASSERT_EQUAL_MESSAGE("Should have gotten an exception", true, exception);
+}
+
+void BatchExecutorTest::testGeodeticMeasurements() {
+	shared_ptr<const Ellipsoid> reference = Ellipsoid::WGS84();
+
+	const size_t count = 5000;
+	vector<double> lat1, lon1, lat2, lon2;
+	randomPoints(count, lat1, lon1, 5);
+	randomPoints(count, lat2, lon2, 6);
+
+	vector<GlobalPosition> starts;
+	vector<GlobalPosition> ends;
+	for (size_t i = 0; i < count; ++i) {
+		starts.push_back(GlobalPosition(lat1[i], lon1[i], lat1[i] * 50));
+		ends.push_back(GlobalPosition(lat2[i], lon2[i], lon2[i] * 20));
+	}
+
+	vector<GeodeticMeasurementValue> measurements(count);
+	BatchExecutor executor(3);
+	executor.calculateGeodeticMeasurements(*reference, count, &starts[0],
+			&ends[0], &measurements[0]);
+
+	vector<GeodeticMeasurementValue> expected(count);
+	GeodeticCalculator::calculateGeodeticMeasurements(*reference, count,
+			&starts[0], &ends[0], &expected[0]);
+
+	for (size_t i = 0; i < count; ++i) {
+		CPPUNIT_ASSERT_EQUAL(expected[i].ellipsoidalDistance,
+				measurements[i].ellipsoidalDistance);
+		CPPUNIT_ASSERT_EQUAL(expected[i].azimuth, measurements[i].azimuth);
+		CPPUNIT_ASSERT_EQUAL(expected[i].reverseAzimuth,
+				measurements[i].reverseAzimuth);
+		CPPUNIT_ASSERT_EQUAL(expected[i].pointToPointDistance,
+				measurements[i].pointToPointDistance);
+	}
+}
+
+void BatchExecutorTest::testFailingTask() {
+	BatchExecutor executor(2);
+	FailingTask task;
+	CPPUNIT_ASSERT_THROW(executor.run(task, 100, 10), BatchTaskException);
+
+	// the executor is still usable afterwards
+	CountingTask counting(100);
+	executor.run(counting, 100, 10);
+	for (size_t i = 0; i < 100; ++i) {
+		CPPUNIT_ASSERT_EQUAL(1, counting.mVisits[i]);
+	}
+}
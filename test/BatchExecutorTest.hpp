@@ -0,0 +1,31 @@
+#ifndef GEODESY_BATCH_EXECUTOR_TEST_HPP
+#define GEODESY_BATCH_EXECUTOR_TEST_HPP
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <BatchExecutor.hpp>
+
+class BatchExecutorTest: public CppUnit::TestFixture {
+
+CPPUNIT_TEST_SUITE( BatchExecutorTest);
+
+		// list all test methods here
+		CPPUNIT_TEST(testCoversEveryItem);
+		CPPUNIT_TEST(testGeodeticCurves);
+		CPPUNIT_TEST(testEndingGlobalCoordinates);
+		CPPUNIT_TEST(testGeodeticMeasurements);
+		CPPUNIT_TEST(testFailingTask);
+
+	CPPUNIT_TEST_SUITE_END();
+
+protected:
+	void testCoversEveryItem();
+	void testGeodeticCurves();
+	void testEndingGlobalCoordinates();
+	void testGeodeticMeasurements();
+	void testFailingTask();
+
+};
+
+#endif // GEODESY_BATCH_EXECUTOR_TEST_HPP
@@ -0,0 +1,289 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#include "ColumnarFileTest.hpp"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <ColumnarFile.hpp>
+#include <GeodeticCalculator.hpp>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace geodesy;
+using namespace std;
+CPPUNIT_TEST_SUITE_REGISTRATION( ColumnarFileTest );
+
+namespace {
+
+string temporaryPath() {
+	char path[] = "/tmp/ColumnarFileTestXXXXXX";
+	int fd = mkstemp(path);
+	CPPUNIT_ASSERT(fd >= 0);
+	close(fd);
+	return path;
+}
+
+}
+
+void ColumnarFileTest::testCoordinates() {
+	string path = temporaryPath();
+
+	// two full blocks and a partial one, from arrays and one at a time
+	const size_t count = 25;
+	vector<LatLon> coordinates(count);
+	for (size_t i = 0; i < count; ++i) {
+		coordinates[i].latitude = -60.0 + 5.123456789 * i;
+		coordinates[i].longitude = 170.0 - 13.987654321 * i;
+	}
+	ColumnarWriter writer(path, ColumnarFile::Coordinates,
+			ColumnarFile::Float64, 10);
+	writer.writeCoordinates(count - 1, &coordinates[0]);
+	writer.write(coordinates[count - 1].toGlobalCoordinates());
+	CPPUNIT_ASSERT_EQUAL(count, writer.getRowCount());
+	writer.close();
+
+	ColumnarReader::Ptr reader = ColumnarReader::open(path);
+	CPPUNIT_ASSERT_EQUAL(ColumnarFile::Coordinates, reader->getContent());
+	CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), reader->getColumnCount());
+	CPPUNIT_ASSERT_EQUAL(ColumnarFile::Float64, reader->getEncoding(0));
+	CPPUNIT_ASSERT_EQUAL(count, reader->getRowCount());
+	CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), reader->getBlockCount());
+	CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(20), reader->getBlockStart(2));
+	CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), reader->getBlockRowCount(2));
+
+	vector<double> latitudes(count);
+	vector<double> longitudes(count);
+	reader->readColumn(ColumnarFile::LatitudeColumn, &latitudes[0]);
+	reader->readColumn(ColumnarFile::LongitudeColumn, &longitudes[0]);
+	for (size_t i = 0; i < count; ++i) {
+		CPPUNIT_ASSERT_EQUAL(coordinates[i].latitude, latitudes[i]);
+		CPPUNIT_ASSERT_EQUAL(coordinates[i].longitude, longitudes[i]);
+	}
+
+	// ranges of the second block
+	CPPUNIT_ASSERT_EQUAL(latitudes[10], reader->getBlockMinimum(1, 0));
+	CPPUNIT_ASSERT_EQUAL(latitudes[19], reader->getBlockMaximum(1, 0));
+	CPPUNIT_ASSERT_EQUAL(longitudes[19], reader->getBlockMinimum(1, 1));
+	CPPUNIT_ASSERT_EQUAL(longitudes[10], reader->getBlockMaximum(1, 1));
+
+	double block[10];
+	reader->readBlock(1, ColumnarFile::LongitudeColumn, block);
+	CPPUNIT_ASSERT_EQUAL(longitudes[15], block[5]);
+	remove(path.c_str());
+}
+
+void ColumnarFileTest::testFixedPoint() {
+	string path = temporaryPath();
+
+	const double latitudes[] = { 90, -90, 38.88922, NAN, 0.123456789 };
+	const double longitudes[] = { 180, -179.9999999, -77.04978, 1, NAN };
+	const size_t count = sizeof(latitudes) / sizeof(latitudes[0]);
+	ColumnarWriter writer(path, ColumnarFile::Coordinates,
+			ColumnarFile::FixedPoint32);
+	writer.writeCoordinates(count, latitudes, longitudes);
+	writer.close();
+
+	ColumnarReader::Ptr reader = ColumnarReader::open(path);
+	CPPUNIT_ASSERT_EQUAL(ColumnarFile::FixedPoint32, reader->getEncoding(1));
+	double values[count];
+	reader->readColumn(ColumnarFile::LatitudeColumn, values);
+	CPPUNIT_ASSERT_EQUAL(90.0, values[0]);
+	CPPUNIT_ASSERT_EQUAL(-90.0, values[1]);
+	CPPUNIT_ASSERT_EQUAL(38.88922, values[2]);
+	CPPUNIT_ASSERT(isnan(values[3]));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.1234568, values[4], 1E-15);
+	CPPUNIT_ASSERT_EQUAL(-90.0, reader->getBlockMinimum(0, 0));
+	CPPUNIT_ASSERT_EQUAL(90.0, reader->getBlockMaximum(0, 0));
+
+	reader->readColumn(ColumnarFile::LongitudeColumn, values);
+	CPPUNIT_ASSERT_EQUAL(180.0, values[0]);
+	CPPUNIT_ASSERT_EQUAL(-179.9999999, values[1]);
+	CPPUNIT_ASSERT_EQUAL(-77.04978, values[2]);
+	CPPUNIT_ASSERT(isnan(values[4]));
+
+	// half the size of the doubles, plus the fixed overhead
+	ColumnarWriter doubles(path + ".doubles", ColumnarFile::Coordinates);
+	ColumnarWriter fixed(path + ".fixed", ColumnarFile::Coordinates,
+			ColumnarFile::FixedPoint32);
+	vector<double> many(1000, 45.0);
+	doubles.writeCoordinates(many.size(), &many[0], &many[0]);
+	fixed.writeCoordinates(many.size(), &many[0], &many[0]);
+	doubles.close();
+	fixed.close();
+	ifstream doublesFile((path + ".doubles").c_str(), ios::binary | ios::ate);
+	ifstream fixedFile((path + ".fixed").c_str(), ios::binary | ios::ate);
+	CPPUNIT_ASSERT_EQUAL(static_cast<long>(8000),
+			static_cast<long>(doublesFile.tellg() - fixedFile.tellg()));
+	remove((path + ".doubles").c_str());
+	remove((path + ".fixed").c_str());
+
+	// azimuths cover [0, 360)
+	ColumnarWriter curves(path, ColumnarFile::Curves,
+			ColumnarFile::FixedPoint32);
+	GeodeticCurveValue curve = { 1000.5, 359.9999999, 0 };
+	curves.write(curve);
+	curves.close();
+	reader = ColumnarReader::open(path);
+	CPPUNIT_ASSERT_EQUAL(ColumnarFile::Float64, reader->getEncoding(0));
+	reader->readColumn(ColumnarFile::AzimuthColumn, values);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(359.9999999, values[0], 1E-12);
+	reader->readColumn(ColumnarFile::ReverseAzimuthColumn, values);
+	CPPUNIT_ASSERT_EQUAL(0.0, values[0]);
+	remove(path.c_str());
+}
+
+void ColumnarFileTest::testCurvesAndMeasurements() {
+	string path = temporaryPath();
+	Ellipsoid::ConstPtr reference = Ellipsoid::WGS84();
+
+	GlobalPosition lincolnMemorial(38.88922, -77.04978, 17);
+	GlobalPosition eiffelTower(48.85889, 2.29583, 300);
+	GeodeticMeasurement::Ptr measurement =
+			GeodeticCalculator::calculateGeodeticMeasurement(reference,
+					lincolnMemorial, eiffelTower);
+	GeodeticMeasurementValue value =
+			GeodeticCalculator::calculateGeodeticMeasurement(*reference,
+					eiffelTower, lincolnMemorial);
+
+	ColumnarWriter writer(path, ColumnarFile::Measurements);
+	writer.write(*measurement);
+	writer.write(value);
+	writer.close();
+
+	ColumnarReader::Ptr reader = ColumnarReader::open(path);
+	CPPUNIT_ASSERT_EQUAL(ColumnarFile::Measurements, reader->getContent());
+	CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), reader->getColumnCount());
+	double values[2];
+	reader->readColumn(ColumnarFile::EllipsoidalDistanceColumn, values);
+	CPPUNIT_ASSERT_EQUAL(measurement->getEllipsoidalDistance(), values[0]);
+	CPPUNIT_ASSERT_EQUAL(value.ellipsoidalDistance, values[1]);
+	reader->readColumn(ColumnarFile::ElevationChangeColumn, values);
+	CPPUNIT_ASSERT_EQUAL(283.0, values[0]);
+	CPPUNIT_ASSERT_EQUAL(-283.0, values[1]);
+	reader->readColumn(ColumnarFile::PointToPointDistanceColumn, values);
+	CPPUNIT_ASSERT_EQUAL(value.pointToPointDistance, values[1]);
+
+	// curves from the batch calculation
+	const double lat1[] = { 38.88922, 0 };
+	const double lon1[] = { -77.04978, 0 };
+	const double lat2[] = { 48.85889, 0 };
+	const double lon2[] = { 2.29583, 1 };
+	double distances[2];
+	double azimuths[2];
+	double reverseAzimuths[2];
+	GeodeticCalculator::calculateGeodeticCurves(reference, 2, lat1, lon1, lat2,
+			lon2, distances, azimuths, reverseAzimuths);
+	ColumnarWriter curves(path, ColumnarFile::Curves);
+	curves.writeCurves(2, distances, azimuths, reverseAzimuths);
+	curves.close();
+
+	reader = ColumnarReader::open(path);
+	CPPUNIT_ASSERT_EQUAL(ColumnarFile::Curves, reader->getContent());
+	reader->readColumn(ColumnarFile::ReverseAzimuthColumn, values);
+	CPPUNIT_ASSERT_EQUAL(reverseAzimuths[0], values[0]);
+	CPPUNIT_ASSERT_EQUAL(reverseAzimuths[1], values[1]);
+	remove(path.c_str());
+}
+
+void ColumnarFileTest::testErrors() {
+	string path = temporaryPath();
+
+	{
+		ColumnarWriter writer(path, ColumnarFile::Curves,
+				ColumnarFile::FixedPoint32);
+		GeodeticCurveValue curve = { 1, 2, 3 };
+		writer.write(curve);
+		CPPUNIT_ASSERT_THROW(writer.write(GlobalCoordinates(1, 2)),
+				ColumnarFileException);
+
+		// nothing of a failed call is written
+		const double distances[] = { 1, 2 };
+		const double azimuths[] = { 90, 1E10 };
+		CPPUNIT_ASSERT_THROW(
+				writer.writeCurves(2, distances, azimuths, azimuths),
+				ColumnarFileException);
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), writer.getRowCount());
+
+		// not closed, the file is left as it was
+	}
+	CPPUNIT_ASSERT_THROW(ColumnarReader::open(path), ColumnarFileException);
+
+	ColumnarWriter writer(path, ColumnarFile::Coordinates);
+	for (int i = 0; i < 100; ++i) {
+		writer.write(GlobalCoordinates(i * 0.5, i));
+	}
+	writer.close();
+	CPPUNIT_ASSERT_THROW(writer.write(GlobalCoordinates(0, 0)),
+			ColumnarFileException);
+	CPPUNIT_ASSERT_THROW(writer.close(), ColumnarFileException);
+	CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(100),
+			ColumnarReader::open(path)->getRowCount());
+
+	// so are counts too large for the file, which would overflow the size
+	// of the block: rowCount, blockSize and the rowCount of the first block
+	// at their offsets in the layout of version 1, without the values
+	{
+		ColumnarWriter one(path, ColumnarFile::Coordinates);
+		one.write(GlobalCoordinates(1, 2));
+		one.close();
+		const unsigned long long huge = 1ULL << 61;
+		FILE *file = fopen(path.c_str(), "r+b");
+		CPPUNIT_ASSERT(file);
+		const long offsets[] = { 24, 40, 128 };
+		for (int i = 0; i < 3; ++i) {
+			CPPUNIT_ASSERT_EQUAL(0, fseek(file, offsets[i], SEEK_SET));
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1),
+					fwrite(&huge, sizeof(huge), 1, file));
+		}
+		CPPUNIT_ASSERT_EQUAL(0, fclose(file));
+		CPPUNIT_ASSERT_EQUAL(0, truncate(path.c_str(), 176));
+		CPPUNIT_ASSERT_THROW(ColumnarReader::open(path),
+				ColumnarFileException);
+	}
+
+	// a truncated file is rejected
+	ColumnarWriter again(path, ColumnarFile::Coordinates);
+	for (int i = 0; i < 100; ++i) {
+		again.write(GlobalCoordinates(i * 0.5, i));
+	}
+	again.close();
+	CPPUNIT_ASSERT_EQUAL(0, truncate(path.c_str(), 1000));
+	CPPUNIT_ASSERT_THROW(ColumnarReader::open(path), ColumnarFileException);
+	remove(path.c_str());
+	CPPUNIT_ASSERT_THROW(ColumnarReader::open(path), ColumnarFileException);
+
+	CPPUNIT_ASSERT_THROW(
+			ColumnarWriter("/nonexistent/directory/file", ColumnarFile::Curves),
+			ColumnarFileException);
+}
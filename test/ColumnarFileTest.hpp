@@ -0,0 +1,29 @@
+#ifndef GEODESY_COLUMNAR_FILE_TEST_HPP
+#define GEODESY_COLUMNAR_FILE_TEST_HPP
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <ColumnarFile.hpp>
+
+class ColumnarFileTest: public CppUnit::TestFixture {
+
+CPPUNIT_TEST_SUITE( ColumnarFileTest);
+
+		// list all test methods here
+		CPPUNIT_TEST(testCoordinates);
+		CPPUNIT_TEST(testFixedPoint);
+		CPPUNIT_TEST(testCurvesAndMeasurements);
+		CPPUNIT_TEST(testErrors);
+
+	CPPUNIT_TEST_SUITE_END();
+
+protected:
+	void testCoordinates();
+	void testFixedPoint();
+	void testCurvesAndMeasurements();
+	void testErrors();
+
+};
+
+#endif // GEODESY_COLUMNAR_FILE_TEST_HPP
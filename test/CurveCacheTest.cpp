@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#include "CurveCacheTest.hpp"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <CurveCache.hpp>
+#include <cmath>
+#include <pthread.h>
+
+using namespace geodesy;
+using namespace std;
+CPPUNIT_TEST_SUITE_REGISTRATION( CurveCacheTest );
+
+void CurveCacheTest::testHitsAndMisses() {
+	Ellipsoid::ConstPtr reference = Ellipsoid::WGS84();
+	GlobalCoordinates lincolnMemorial(38.88922, -77.04978);
+	GlobalCoordinates eiffelTower(48.85889, 2.29583);
+	CurveCache cache;
+
+	GeodeticCurveValue first = cache.calculateGeodeticCurve(*reference,
+			lincolnMemorial, eiffelTower);
+	GeodeticCurveValue second = cache.calculateGeodeticCurve(*reference,
+			lincolnMemorial, eiffelTower);
+	CurveCache::Statistics statistics = cache.getStatistics();
+	CPPUNIT_ASSERT_EQUAL(1ULL, statistics.hits);
+	CPPUNIT_ASSERT_EQUAL(1ULL, statistics.misses);
+	CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), statistics.size);
+
+	// the result of the uncached calculation, to within the resolution
+	GeodeticCurveValue expected = GeodeticCalculator::calculateGeodeticCurve(
+			*reference, lincolnMemorial, eiffelTower);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(expected.ellipsoidalDistance,
+			first.ellipsoidalDistance, 0.02);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(expected.azimuth, first.azimuth, 1E-7);
+	CPPUNIT_ASSERT_EQUAL(first.ellipsoidalDistance, second.ellipsoidalDistance);
+	CPPUNIT_ASSERT_EQUAL(first.azimuth, second.azimuth);
+	CPPUNIT_ASSERT_EQUAL(first.reverseAzimuth, second.reverseAzimuth);
+
+	cache.clear();
+	statistics = cache.getStatistics();
+	CPPUNIT_ASSERT_EQUAL(0ULL, statistics.hits);
+	CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), statistics.size);
+
+	// exact keys give exactly the uncached result
+	CurveCache exact(100, 4, 0);
+	GeodeticCurveValue curve = exact.calculateGeodeticCurve(*reference,
+			lincolnMemorial, eiffelTower);
+	CPPUNIT_ASSERT_EQUAL(expected.ellipsoidalDistance, curve.ellipsoidalDistance);
+	CPPUNIT_ASSERT_EQUAL(expected.reverseAzimuth, curve.reverseAzimuth);
+}
+
+void CurveCacheTest::testKeys() {
+	GlobalCoordinates start(10, 20);
+	GlobalCoordinates end(11, 21);
+	CurveCache cache(1000, 4, 1E-6);
+
+	cache.calculateGeodeticCurve(*Ellipsoid::WGS84(), start, end);
+	// within the resolution
+	cache.calculateGeodeticCurve(*Ellipsoid::WGS84(),
+			GlobalCoordinates(10.0000002, 20), GlobalCoordinates(11, 20.9999998));
+	// an equal ellipsoid from another instance
+	cache.calculateGeodeticCurve(
+			*Ellipsoid::fromAAndInverseF(6378137.0, 298.257223563), start, end);
+	CPPUNIT_ASSERT_EQUAL(2ULL, cache.getStatistics().hits);
+
+	// the rest are different keys
+	cache.calculateGeodeticCurve(*Ellipsoid::WGS84(),
+			GlobalCoordinates(10.000002, 20), end);
+	cache.calculateGeodeticCurve(*Ellipsoid::WGS84(), end, start);
+	cache.calculateGeodeticCurve(*Ellipsoid::GRS67(), start, end);
+	cache.calculateGeodeticCurve(*Ellipsoid::WGS84(), start, end,
+			GeodeticCalculator::Karney);
+	CurveCache::Statistics statistics = cache.getStatistics();
+	CPPUNIT_ASSERT_EQUAL(2ULL, statistics.hits);
+	CPPUNIT_ASSERT_EQUAL(5ULL, statistics.misses);
+	CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), statistics.size);
+}
+
+void CurveCacheTest::testEviction() {
+	const Ellipsoid &reference = *Ellipsoid::WGS84();
+	GlobalCoordinates origin(0, 0);
+	CurveCache cache(3, 1);
+
+	for (int i = 1; i <= 3; ++i) {
+		cache.calculateGeodeticCurve(reference, origin, GlobalCoordinates(i, 0));
+	}
+	// use 1 again, so that 2 is the least recently used
+	cache.calculateGeodeticCurve(reference, origin, GlobalCoordinates(1, 0));
+	cache.calculateGeodeticCurve(reference, origin, GlobalCoordinates(4, 0));
+	CurveCache::Statistics statistics = cache.getStatistics();
+	CPPUNIT_ASSERT_EQUAL(1ULL, statistics.evictions);
+	CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), statistics.size);
+
+	cache.calculateGeodeticCurve(reference, origin, GlobalCoordinates(1, 0));
+	cache.calculateGeodeticCurve(reference, origin, GlobalCoordinates(3, 0));
+	CPPUNIT_ASSERT_EQUAL(3ULL, cache.getStatistics().hits);
+	cache.calculateGeodeticCurve(reference, origin, GlobalCoordinates(2, 0));
+	statistics = cache.getStatistics();
+	CPPUNIT_ASSERT_EQUAL(3ULL, statistics.hits);
+	CPPUNIT_ASSERT_EQUAL(2ULL, statistics.evictions);
+	CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), statistics.size);
+}
+
+void CurveCacheTest::testCapacity() {
+	const Ellipsoid &reference = *Ellipsoid::WGS84();
+	GlobalCoordinates origin(0, 0);
+	// more shards than curves, and shares that don't divide evenly
+	const size_t capacities[] = { 4, 10, 0 };
+	const unsigned shardCounts[] = { 16, 4, 2 };
+
+	for (int c = 0; c < 3; ++c) {
+		CurveCache cache(capacities[c], shardCounts[c]);
+		for (int i = 1; i <= 200; ++i) {
+			cache.calculateGeodeticCurve(reference, origin,
+					GlobalCoordinates(i * 0.1, 0));
+		}
+		CurveCache::Statistics statistics = cache.getStatistics();
+		CPPUNIT_ASSERT_EQUAL(capacities[c], cache.getCapacity());
+		CPPUNIT_ASSERT_EQUAL(capacities[c], statistics.size);
+		CPPUNIT_ASSERT_EQUAL(200 - capacities[c],
+				static_cast<size_t>(statistics.evictions));
+	}
+}
+
+void CurveCacheTest::testNonFinite() {
+	const Ellipsoid &reference = *Ellipsoid::WGS84();
+	GlobalCoordinates origin(0, 0);
+	GlobalCoordinates unknown(NAN, 0);
+	GlobalCoordinates negative(-NAN, 0);
+	CurveCache cache(100, 1);
+
+	GeodeticCurveValue curve = cache.calculateGeodeticCurve(reference, origin,
+			unknown);
+	CPPUNIT_ASSERT(isnan(curve.ellipsoidalDistance));
+	// every NaN is the same key, and not the key of a number
+	cache.calculateGeodeticCurve(reference, origin, negative);
+	curve = cache.calculateGeodeticCurve(reference, origin,
+			GlobalCoordinates(0, 0));
+	CPPUNIT_ASSERT_EQUAL(0.0, curve.ellipsoidalDistance);
+	CurveCache::Statistics statistics = cache.getStatistics();
+	CPPUNIT_ASSERT_EQUAL(1ULL, statistics.hits);
+	CPPUNIT_ASSERT_EQUAL(2ULL, statistics.misses);
+
+	// a resolution so fine that the coordinates don't fit the keys
+	CurveCache fine(100, 1, 1E-310);
+	curve = fine.calculateGeodeticCurve(reference, origin,
+			GlobalCoordinates(1, 0));
+	CPPUNIT_ASSERT(curve.ellipsoidalDistance > 110000);
+	fine.calculateGeodeticCurve(reference, origin, GlobalCoordinates(1, 0));
+	CPPUNIT_ASSERT_EQUAL(1ULL, fine.getStatistics().hits);
+}
+
+namespace {
+
+struct LookupThread {
+	CurveCache *cache;
+	pthread_t thread;
+	bool consistent;
+};
+
+void *lookups(void *argument) {
+	LookupThread &lookup = *static_cast<LookupThread *>(argument);
+	const Ellipsoid &reference = *Ellipsoid::WGS84();
+	GlobalCoordinates depot(52.52, 13.405);
+	lookup.consistent = true;
+	for (int i = 0; i < 2000; ++i) {
+		GlobalCoordinates customer(50 + (i % 50) * 0.1, 10);
+		GeodeticCurveValue cached = lookup.cache->calculateGeodeticCurve(
+				reference, depot, customer);
+		GeodeticCurveValue expected =
+				GeodeticCalculator::calculateGeodeticCurve(reference, depot,
+						customer);
+		if (fabs(cached.ellipsoidalDistance - expected.ellipsoidalDistance)
+				> 0.02) {
+			lookup.consistent = false;
+		}
+	}
+	return 0;
+}
+
+}
+
+void CurveCacheTest::testConcurrentLookups() {
+	CurveCache cache(40, 4);
+	LookupThread threads[4];
+	for (int i = 0; i < 4; ++i) {
+		threads[i].cache = &cache;
+		CPPUNIT_ASSERT_EQUAL(0,
+				pthread_create(&threads[i].thread, 0, lookups, &threads[i]));
+	}
+	for (int i = 0; i < 4; ++i) {
+		pthread_join(threads[i].thread, 0);
+		CPPUNIT_ASSERT(threads[i].consistent);
+	}
+
+	CurveCache::Statistics statistics = cache.getStatistics();
+	CPPUNIT_ASSERT_EQUAL(8000ULL, statistics.hits + statistics.misses);
+	CPPUNIT_ASSERT(statistics.size <= cache.getCapacity());
+}
@@ -0,0 +1,33 @@
+#ifndef GEODESY_CURVE_CACHE_TEST_HPP
+#define GEODESY_CURVE_CACHE_TEST_HPP
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <CurveCache.hpp>
+
+class CurveCacheTest: public CppUnit::TestFixture {
+
+CPPUNIT_TEST_SUITE( CurveCacheTest);
+
+		// list all test methods here
+		CPPUNIT_TEST(testHitsAndMisses);
+		CPPUNIT_TEST(testKeys);
+		CPPUNIT_TEST(testEviction);
+		CPPUNIT_TEST(testCapacity);
+		CPPUNIT_TEST(testNonFinite);
+		CPPUNIT_TEST(testConcurrentLookups);
+
+	CPPUNIT_TEST_SUITE_END();
+
+protected:
+	void testHitsAndMisses();
+	void testKeys();
+	void testEviction();
+	void testCapacity();
+	void testNonFinite();
+	void testConcurrentLookups();
+
+};
+
+#endif // GEODESY_CURVE_CACHE_TEST_HPP
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#include "DistanceMatrixTest.hpp"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <DistanceMatrix.hpp>
+#include <GeodeticCalculator.hpp>
+#include <cmath>
+#include <vector>
+
+using namespace geodesy;
+using namespace std;
+using namespace std::tr1;
+CPPUNIT_TEST_SUITE_REGISTRATION( DistanceMatrixTest );
+
+namespace {
+
+/**
+ * Fill the arrays with pseudo-random points all over the globe.
+ */
+void randomPoints(size_t count, vector<double> &latitudes,
+		vector<double> &longitudes, unsigned seed) {
+	latitudes.resize(count);
+	longitudes.resize(count);
+	for (size_t i = 0; i < count; ++i) {
+		seed = seed * 1103515245 + 12345;
+		latitudes[i] = (seed % 1800000) / 10000.0 - 90;
+		seed = seed * 1103515245 + 12345;
+		longitudes[i] = (seed % 3600000) / 10000.0 - 180;
+	}
+}
+
+/**
+ * Counts how often each element is handed out.
+ */
+class CountingHandler: public DistanceMatrix::TileHandler {
+public:
+	CountingHandler(size_t rows, size_t columns) :
+			mColumns(columns), mVisits(rows * columns, 0) {
+	}
+
+	virtual void handleTile(const DistanceMatrix::Tile &tile) {
+		for (size_t row = tile.rowBegin; row < tile.rowEnd; ++row) {
+			for (size_t column = tile.columnBegin; column < tile.columnEnd;
+					++column) {
+				__sync_fetch_and_add(&mVisits[row * mColumns + column], 1);
+			}
+		}
+	}
+
+	size_t mColumns;
+	vector<int> mVisits;
+};
+
+}
+
+void DistanceMatrixTest::testDense() {
+	shared_ptr<const Ellipsoid> reference = Ellipsoid::WGS84();
+
+	// sizes that aren't whole tiles, and the same point in both sets
+	const size_t rows = 37;
+	const size_t columns = 45;
+	vector<double> rowLat, rowLon, columnLat, columnLon;
+	randomPoints(rows, rowLat, rowLon, 5);
+	randomPoints(columns, columnLat, columnLon, 6);
+	columnLat[3] = rowLat[2];
+	columnLon[3] = rowLon[2];
+
+	DistanceMatrix matrix(reference, rows, &rowLat[0], &rowLon[0], columns,
+			&columnLat[0], &columnLon[0], 16);
+	CPPUNIT_ASSERT_EQUAL(rows, matrix.getRowCount());
+	CPPUNIT_ASSERT_EQUAL(columns, matrix.getColumnCount());
+	CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(16), matrix.getTileSize());
+
+	vector<double> s(rows * columns), az1(rows * columns), az2(rows * columns);
+	BatchExecutor executor(3);
+	matrix.calculate(executor, &s[0], &az1[0], &az2[0]);
+
+	for (size_t row = 0; row < rows; ++row) {
+		for (size_t column = 0; column < columns; ++column) {
+			GeodeticCurveValue expected =
+					GeodeticCalculator::calculateGeodeticCurve(*reference,
+							GlobalCoordinates(rowLat[row], rowLon[row]),
+							GlobalCoordinates(columnLat[column],
+									columnLon[column]));
+			size_t i = row * columns + column;
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(expected.ellipsoidalDistance, s[i], 0.000001);
+			if (!isnan(expected.azimuth)) {
+				CPPUNIT_ASSERT_DOUBLES_EQUAL(expected.azimuth, az1[i], 0.000000001);
+				CPPUNIT_ASSERT_DOUBLES_EQUAL(expected.reverseAzimuth, az2[i], 0.000000001);
+			}
+		}
+	}
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, s[2 * columns + 3], 0.000001);
+
+	// distances only
+	vector<double> distancesOnly(rows * columns);
+	matrix.calculate(executor, &distancesOnly[0], 0, 0);
+	for (size_t i = 0; i < rows * columns; ++i) {
+		CPPUNIT_ASSERT_EQUAL(s[i], distancesOnly[i]);
+	}
+}
+
+void DistanceMatrixTest::testTiles() {
+	shared_ptr<const Ellipsoid> reference = Ellipsoid::WGS84();
+
+	const size_t rows = 130;
+	const size_t columns = 7;
+	vector<double> rowLat, rowLon, columnLat, columnLon;
+	randomPoints(rows, rowLat, rowLon, 7);
+	randomPoints(columns, columnLat, columnLon, 8);
+
+	DistanceMatrix matrix(reference, rows, &rowLat[0], &rowLon[0], columns,
+			&columnLat[0], &columnLon[0]);
+	CPPUNIT_ASSERT_EQUAL(DistanceMatrix::DefaultTileSize, matrix.getTileSize());
+
+	BatchExecutor executor(2);
+	CountingHandler handler(rows, columns);
+	matrix.calculate(executor, handler);
+	for (size_t i = 0; i < rows * columns; ++i) {
+		CPPUNIT_ASSERT_EQUAL(1, handler.mVisits[i]);
+	}
+
+	// an empty set of columns
+	DistanceMatrix empty(reference, rows, &rowLat[0], &rowLon[0], 0, 0, 0);
+	CountingHandler none(rows, 0);
+	empty.calculate(executor, none);
+}
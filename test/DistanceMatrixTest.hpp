@@ -0,0 +1,25 @@
+#ifndef GEODESY_DISTANCE_MATRIX_TEST_HPP
+#define GEODESY_DISTANCE_MATRIX_TEST_HPP
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <DistanceMatrix.hpp>
+
+class DistanceMatrixTest: public CppUnit::TestFixture {
+
+CPPUNIT_TEST_SUITE( DistanceMatrixTest);
+
+		// list all test methods here
+		CPPUNIT_TEST(testDense);
+		CPPUNIT_TEST(testTiles);
+
+	CPPUNIT_TEST_SUITE_END();
+
+protected:
+	void testDense();
+	void testTiles();
+
+};
+
+#endif // GEODESY_DISTANCE_MATRIX_TEST_HPP
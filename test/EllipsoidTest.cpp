@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#include "EllipsoidTest.hpp"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <Ellipsoid.hpp>
+#include <cmath>
+
+using namespace geodesy;
+using namespace std;
+CPPUNIT_TEST_SUITE_REGISTRATION( EllipsoidTest );
+
+void EllipsoidTest::testDerivedConstants() {
+	Ellipsoid::ConstPtr wgs84 = Ellipsoid::WGS84();
+	double a = wgs84->getSemiMajorAxis();
+	double b = wgs84->getSemiMinorAxis();
+	double f = wgs84->getFlattening();
+
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(6356752.314245, b, 1E-6);
+	CPPUNIT_ASSERT_EQUAL(a * a, wgs84->getSemiMajorAxisSquared());
+	CPPUNIT_ASSERT_EQUAL(b * b, wgs84->getSemiMinorAxisSquared());
+	CPPUNIT_ASSERT_EQUAL(1.0 - f, wgs84->getAxisRatio());
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(b / a, wgs84->getAxisRatio(), 1E-15);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL((a - b) / (a + b),
+			wgs84->getThirdFlattening(), 1E-15);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.00669437999014,
+			wgs84->getEccentricitySquared(), 1E-14);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0818191908426, wgs84->getEccentricity(),
+			1E-13);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.00673949674228,
+			wgs84->getSecondEccentricitySquared(), 1E-14);
+
+	// a sphere has none of the eccentricity
+	Ellipsoid::ConstPtr sphere = Ellipsoid::Sphere();
+	CPPUNIT_ASSERT_EQUAL(1.0, sphere->getAxisRatio());
+	CPPUNIT_ASSERT_EQUAL(0.0, sphere->getThirdFlattening());
+	CPPUNIT_ASSERT_EQUAL(0.0, sphere->getEccentricity());
+	CPPUNIT_ASSERT_EQUAL(0.0, sphere->getSecondEccentricitySquared());
+}
+
+void EllipsoidTest::testIntern() {
+	// the common ellipsoids are the shared ones
+	Ellipsoid::ConstPtr wgs84 = Ellipsoid::WGS84();
+	CPPUNIT_ASSERT(
+			Ellipsoid::intern(6378137.0, 1.0 / 298.257223563) == wgs84);
+	CPPUNIT_ASSERT(
+			Ellipsoid::intern(Ellipsoid::fromAAndInverseF(6378137.0, 298.257223563)) == wgs84);
+
+	// equal parameters share an instance, different ones don't
+	Ellipsoid::ConstPtr bessel = Ellipsoid::intern(6377397.155,
+			1.0 / 299.1528128);
+	CPPUNIT_ASSERT(bessel != wgs84);
+	CPPUNIT_ASSERT(Ellipsoid::intern(6377397.155, 1.0 / 299.1528128) == bessel);
+	CPPUNIT_ASSERT(Ellipsoid::intern(6377397.155, 1.0 / 299.15) != bessel);
+	CPPUNIT_ASSERT_EQUAL(6377397.155, bessel->getSemiMajorAxis());
+
+	// an ellipsoid built elsewhere becomes the shared one
+	Ellipsoid::ConstPtr krassowsky = Ellipsoid::fromAAndInverseF(6378245.0,
+			298.3);
+	CPPUNIT_ASSERT(Ellipsoid::intern(krassowsky) == krassowsky);
+	CPPUNIT_ASSERT(
+			Ellipsoid::intern(6378245.0, krassowsky->getFlattening()) == krassowsky);
+
+	// once released, a new instance is shared
+	krassowsky.reset();
+	Ellipsoid::ConstPtr again = Ellipsoid::intern(6378245.0, 1.0 / 298.3);
+	CPPUNIT_ASSERT(again);
+	CPPUNIT_ASSERT(Ellipsoid::intern(6378245.0, 1.0 / 298.3) == again);
+
+	// NaN can't be shared, but still gives an ellipsoid
+	CPPUNIT_ASSERT(isnan(Ellipsoid::intern(NAN, 0.0)->getSemiMajorAxis()));
+}
+
+void EllipsoidTest::testCommonByReference() {
+	// every call refers to the same pointer, and taking it doesn't count as
+	// a use
+	const Ellipsoid::ConstPtr &wgs84 = Ellipsoid::WGS84();
+	long uses = wgs84.use_count();
+	const Ellipsoid::ConstPtr &again = Ellipsoid::WGS84();
+	CPPUNIT_ASSERT(&again == &wgs84);
+	CPPUNIT_ASSERT_EQUAL(uses, wgs84.use_count());
+	CPPUNIT_ASSERT_EQUAL(6378137.0, Ellipsoid::WGS84()->getSemiMajorAxis());
+
+	// a copy still counts
+	Ellipsoid::ConstPtr copy = Ellipsoid::WGS84();
+	CPPUNIT_ASSERT_EQUAL(uses + 1, wgs84.use_count());
+	CPPUNIT_ASSERT(&Ellipsoid::Sphere() != &wgs84);
+}
@@ -0,0 +1,27 @@
+#ifndef GEODESY_ELLIPSOID_TEST_HPP
+#define GEODESY_ELLIPSOID_TEST_HPP
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <Ellipsoid.hpp>
+
+class EllipsoidTest: public CppUnit::TestFixture {
+
+CPPUNIT_TEST_SUITE( EllipsoidTest);
+
+		// list all test methods here
+		CPPUNIT_TEST(testDerivedConstants);
+		CPPUNIT_TEST(testIntern);
+		CPPUNIT_TEST(testCommonByReference);
+
+	CPPUNIT_TEST_SUITE_END();
+
+protected:
+	void testDerivedConstants();
+	void testIntern();
+	void testCommonByReference();
+
+};
+
+#endif // GEODESY_ELLIPSOID_TEST_HPP
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#include "FastMathTest.hpp"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <FastMath.hpp>
+#include <cmath>
+
+using namespace geodesy;
+using namespace std;
+CPPUNIT_TEST_SUITE_REGISTRATION( FastMathTest );
+
+void FastMathTest::testSincos() {
+	for (int i = -4000; i <= 4000; ++i) {
+		double x = i * 0.00731;
+		double sine, cosine;
+		fastmath::sincos(x, sine, cosine);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(sin(x), sine, 4E-16);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(cos(x), cosine, 4E-16);
+
+		fastmath::sincosReduced(x, sine, cosine);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(sin(x), sine, 2E-11);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(cos(x), cosine, 2E-11);
+	}
+
+	// small arguments keep their relative accuracy
+	double sine, cosine;
+	fastmath::sincosReduced(1E-9, sine, cosine);
+	CPPUNIT_ASSERT_EQUAL(1E-9, sine);
+	CPPUNIT_ASSERT_EQUAL(1.0, cosine);
+}
+
+void FastMathTest::testAtan2() {
+	for (int i = -50; i <= 50; ++i) {
+		for (int j = -50; j <= 50; ++j) {
+			double y = i * 0.37;
+			double x = j * 0.53;
+			double expected = atan2(y, x);
+			double tolerance = fabs(expected);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(expected, fastmath::atan2(y, x),
+					tolerance * 5E-16);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(expected,
+					fastmath::atan2Reduced(y, x), tolerance * 4E-12);
+		}
+	}
+
+	// signed zeros, same as the C library
+	CPPUNIT_ASSERT_EQUAL(M_PI, fastmath::atan2(0.0, -0.0));
+	CPPUNIT_ASSERT_EQUAL(-M_PI, fastmath::atan2(-0.0, -0.0));
+	CPPUNIT_ASSERT(signbit(fastmath::atan2(-0.0, 0.0)));
+	CPPUNIT_ASSERT_EQUAL(M_PI / 2, fastmath::atan2(1.0, 0.0));
+	CPPUNIT_ASSERT_EQUAL(M_PI / 2, fastmath::atan2Reduced(1.0, 0.0));
+}
+
+void FastMathTest::testAsin() {
+	for (int i = -1000; i <= 1000; ++i) {
+		double x = i * 0.001;
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(asin(x), fastmath::asin(x), 5E-16);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(asin(x), fastmath::asinReduced(x), 4E-12);
+	}
+	CPPUNIT_ASSERT_EQUAL(3.0, fastmath::sqrt(9.0));
+}
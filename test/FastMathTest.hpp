@@ -0,0 +1,27 @@
+#ifndef GEODESY_FAST_MATH_TEST_HPP
+#define GEODESY_FAST_MATH_TEST_HPP
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <FastMath.hpp>
+
+class FastMathTest: public CppUnit::TestFixture {
+
+CPPUNIT_TEST_SUITE( FastMathTest);
+
+		// list all test methods here
+		CPPUNIT_TEST(testSincos);
+		CPPUNIT_TEST(testAtan2);
+		CPPUNIT_TEST(testAsin);
+
+	CPPUNIT_TEST_SUITE_END();
+
+protected:
+	void testSincos();
+	void testAtan2();
+	void testAsin();
+
+};
+
+#endif // GEODESY_FAST_MATH_TEST_HPP
@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#include "GeoBatchTest.hpp"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <GeodeticCalculator.hpp>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+// set by the build to the geoBatch it builds, this is where it is relative
+// to the test directory of the build
+#ifndef GEOBATCH_PATH
+#define GEOBATCH_PATH "../tools/geoBatch"
+#endif
+
+using namespace geodesy;
+using namespace std;
+CPPUNIT_TEST_SUITE_REGISTRATION( GeoBatchTest );
+
+namespace {
+
+string temporaryPath() {
+	char path[] = "/tmp/GeoBatchTestXXXXXX";
+	int fd = mkstemp(path);
+	CPPUNIT_ASSERT(fd >= 0);
+	close(fd);
+	return path;
+}
+
+void writeDoubles(const string &path, const vector<double> &values) {
+	FILE *file = fopen(path.c_str(), "wb");
+	CPPUNIT_ASSERT(file);
+	CPPUNIT_ASSERT_EQUAL(values.size(),
+			fwrite(&values[0], sizeof(double), values.size(), file));
+	CPPUNIT_ASSERT_EQUAL(0, fclose(file));
+}
+
+vector<double> readDoubles(const string &path) {
+	vector<double> values;
+	FILE *file = fopen(path.c_str(), "rb");
+	CPPUNIT_ASSERT(file);
+	double value;
+	while (fread(&value, sizeof(double), 1, file) == 1) {
+		values.push_back(value);
+	}
+	fclose(file);
+	return values;
+}
+
+/**
+ * Run geoBatch with arguments.
+ *
+ * @return its exit status
+ */
+int geoBatch(const string &arguments) {
+	string command = string(GEOBATCH_PATH) + " " + arguments
+			+ " 2>/dev/null";
+	int status = system(command.c_str());
+	CPPUNIT_ASSERT(WIFEXITED(status));
+	return WEXITSTATUS(status);
+}
+
+}
+
+void GeoBatchTest::testInverse() {
+	// Lincoln Memorial to Eiffel Tower, the antipodal cases, a zero length
+	// curve and a pair that needs canonicalizing
+	const double lat1[] = { 38.88922, 10, 11, 38.88922, 100 };
+	const double lon1[] = { -77.04978, 80.6, 80, -77.04978, 370 };
+	const double lat2[] = { 48.85889, -10, -10, 38.88922, -45 };
+	const double lon2[] = { 2.29583, -100, -100, -77.04978, -530 };
+	const size_t count = sizeof(lat1) / sizeof(lat1[0]);
+
+	vector<double> records;
+	for (size_t i = 0; i < count; ++i) {
+		records.push_back(lat1[i]);
+		records.push_back(lon1[i]);
+		records.push_back(lat2[i]);
+		records.push_back(lon2[i]);
+	}
+	string input = temporaryPath();
+	string output = temporaryPath();
+	writeDoubles(input, records);
+
+	const char *methods[] = { "vincenty", "karney", "andoyer_lambert",
+			"haversine" };
+	for (int m = 0; m < 4; ++m) {
+		CPPUNIT_ASSERT_EQUAL(0,
+				geoBatch(
+						string("inverse ") + input + " " + output
+								+ " --threads 2 --ellipsoid grs80 --method "
+								+ methods[m]));
+
+		double distances[count];
+		double azimuths[count];
+		double reverseAzimuths[count];
+		GeodeticCalculator::calculateGeodeticCurves(*Ellipsoid::GRS80(),
+				count, lat1, lon1, lat2, lon2, distances, azimuths,
+				reverseAzimuths, static_cast<GeodeticCalculator::InverseMethod>(
+						GeodeticCalculator::Vincenty + m));
+
+		vector<double> results = readDoubles(output);
+		CPPUNIT_ASSERT_EQUAL(3 * count, results.size());
+		for (size_t i = 0; i < count; ++i) {
+			CPPUNIT_ASSERT_EQUAL(distances[i], results[3 * i]);
+			if (!isnan(azimuths[i])) {
+				CPPUNIT_ASSERT_EQUAL(azimuths[i], results[3 * i + 1]);
+				CPPUNIT_ASSERT_EQUAL(reverseAzimuths[i], results[3 * i + 2]);
+			}
+		}
+	}
+
+	// nothing is left behind
+	CPPUNIT_ASSERT(access((output + ".tmp").c_str(), F_OK) != 0);
+
+	unlink(input.c_str());
+	unlink(output.c_str());
+}
+
+void GeoBatchTest::testDirect() {
+	// the third record has no bearing
+	const double lat1[] = { 38.88922, 10, 45, -89.5 };
+	const double lon1[] = { -77.04978, 80.6, 7, 190 };
+	const double bearings[] = { 51.7679, -30, NAN, 180 };
+	const double distances[] = { 6179016.136, 20000000, 1000, 500000 };
+	const size_t count = sizeof(lat1) / sizeof(lat1[0]);
+
+	vector<double> records;
+	for (size_t i = 0; i < count; ++i) {
+		records.push_back(lat1[i]);
+		records.push_back(lon1[i]);
+		records.push_back(bearings[i]);
+		records.push_back(distances[i]);
+	}
+	string input = temporaryPath();
+	string output = temporaryPath();
+	writeDoubles(input, records);
+
+	CPPUNIT_ASSERT_EQUAL(0, geoBatch("direct " + input + " " + output));
+
+	vector<double> results = readDoubles(output);
+	CPPUNIT_ASSERT_EQUAL(3 * count, results.size());
+	for (size_t i = 0; i < count; ++i) {
+		if (isnan(bearings[i])) {
+			CPPUNIT_ASSERT(isnan(results[3 * i]));
+			CPPUNIT_ASSERT(isnan(results[3 * i + 1]));
+			CPPUNIT_ASSERT(isnan(results[3 * i + 2]));
+			continue;
+		}
+		double latitude;
+		double longitude;
+		double endBearing;
+		GeodeticCalculator::calculateEndingGlobalCoordinates(
+				*Ellipsoid::WGS84(), 1, lat1 + i, lon1 + i, bearings + i,
+				distances + i, &latitude, &longitude, &endBearing);
+		CPPUNIT_ASSERT_EQUAL(latitude, results[3 * i]);
+		CPPUNIT_ASSERT_EQUAL(longitude, results[3 * i + 1]);
+		CPPUNIT_ASSERT_EQUAL(endBearing, results[3 * i + 2]);
+	}
+
+	unlink(input.c_str());
+	unlink(output.c_str());
+}
+
+void GeoBatchTest::testOutputIsInput() {
+	vector<double> records(8, 1.0);
+	string output = temporaryPath();
+	string input = output + ".tmp";
+	writeDoubles(input, records);
+
+	// refused, and the input is untouched
+	CPPUNIT_ASSERT(geoBatch("inverse " + input + " " + input) != 0);
+	CPPUNIT_ASSERT(readDoubles(input) == records);
+
+	// also through another name
+	string link = output + ".link";
+	CPPUNIT_ASSERT_EQUAL(0, symlink(input.c_str(), link.c_str()));
+	CPPUNIT_ASSERT(geoBatch("inverse " + input + " " + link) != 0);
+	CPPUNIT_ASSERT(readDoubles(input) == records);
+
+	// or as the temporary file of the output
+	CPPUNIT_ASSERT(geoBatch("inverse " + input + " " + output) != 0);
+	CPPUNIT_ASSERT(readDoubles(input) == records);
+
+	unlink(link.c_str());
+	unlink(input.c_str());
+	unlink(output.c_str());
+}
+
+void GeoBatchTest::testBadThreads() {
+	vector<double> records(8, 1.0);
+	string input = temporaryPath();
+	string output = temporaryPath();
+	writeDoubles(input, records);
+	unlink(output.c_str());
+
+	const char *counts[] = { "-1", "abc", "2x", "", "+2", "4294967296",
+			"1025" };
+	for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i) {
+		CPPUNIT_ASSERT_EQUAL(2,
+				geoBatch(
+						"inverse " + input + " " + output + " --threads '"
+								+ counts[i] + "'"));
+		CPPUNIT_ASSERT(access(output.c_str(), F_OK) != 0);
+		CPPUNIT_ASSERT(access((output + ".tmp").c_str(), F_OK) != 0);
+	}
+
+	CPPUNIT_ASSERT_EQUAL(0,
+			geoBatch("inverse " + input + " " + output + " --threads 1024"));
+	CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(6), readDoubles(output).size());
+
+	unlink(input.c_str());
+	unlink(output.c_str());
+}
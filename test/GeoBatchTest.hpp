@@ -0,0 +1,27 @@
+#ifndef GEODESY_GEO_BATCH_TEST_HPP
+#define GEODESY_GEO_BATCH_TEST_HPP
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class GeoBatchTest: public CppUnit::TestFixture {
+
+CPPUNIT_TEST_SUITE( GeoBatchTest);
+
+		// list all test methods here
+		CPPUNIT_TEST(testInverse);
+		CPPUNIT_TEST(testDirect);
+		CPPUNIT_TEST(testOutputIsInput);
+		CPPUNIT_TEST(testBadThreads);
+
+	CPPUNIT_TEST_SUITE_END();
+
+protected:
+	void testInverse();
+	void testDirect();
+	void testOutputIsInput();
+	void testBadThreads();
+
+};
+
+#endif // GEODESY_GEO_BATCH_TEST_HPP
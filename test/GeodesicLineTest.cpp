@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#include "GeodesicLineTest.hpp"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <GeodesicLine.hpp>
+#include <GeodeticCalculator.hpp>
+#include <cmath>
+
+using namespace geodesy;
+using namespace std;
+CPPUNIT_TEST_SUITE_REGISTRATION( GeodesicLineTest );
+
+void GeodesicLineTest::testMatchesDirect() {
+	const Ellipsoid &reference = *Ellipsoid::WGS84();
+
+	// set Lincoln Memorial coordinates and head for the Eiffel Tower
+	GlobalCoordinates lincolnMemorial(38.88922, -77.04978);
+	GeodesicLine line(reference, lincolnMemorial, 51.76792142);
+
+	CPPUNIT_ASSERT_EQUAL(lincolnMemorial.getLatitude(), line.getStartLatitude());
+	CPPUNIT_ASSERT_EQUAL(lincolnMemorial.getLongitude(), line.getStartLongitude());
+	CPPUNIT_ASSERT_EQUAL(51.76792142, line.getStartBearing());
+
+	GeodeticDestinationValue eiffelTower = line.calculatePosition(6179016.136);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(48.85889, eiffelTower.latitude, 0.0000001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(2.29583, eiffelTower.longitude, 0.0000001);
+
+	// all the way around the world and past the start
+	for (double distance = 0; distance < 45000000; distance += 1234567) {
+		GeodeticDestinationValue actual = line.calculatePosition(distance);
+		GeodeticDestinationValue expected =
+				GeodeticCalculator::calculateEndingGlobalCoordinates(reference,
+						lincolnMemorial, 51.76792142, distance);
+		CPPUNIT_ASSERT_EQUAL(expected.latitude, actual.latitude);
+		CPPUNIT_ASSERT_EQUAL(expected.longitude, actual.longitude);
+		CPPUNIT_ASSERT_EQUAL(expected.endBearing, actual.endBearing);
+	}
+}
+
+void GeodesicLineTest::testPositions() {
+	const Ellipsoid &reference = *Ellipsoid::WGS84();
+
+	// the pole crossing from GeodeticCalculatorTest
+	GlobalCoordinates lincolnMemorial(38.88922, -77.04978);
+	GeodesicLine line(reference, lincolnMemorial, 1.0);
+
+	const double distances[] = { 0, 1000, 6179016.13586, 10000000, -5000 };
+	const size_t count = sizeof(distances) / sizeof(distances[0]);
+	double latitudes[count];
+	double longitudes[count];
+	double endBearings[count];
+	line.calculatePositions(count, distances, latitudes, longitudes,
+			endBearings);
+
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(lincolnMemorial.getLatitude(), latitudes[0], 0.0000001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(lincolnMemorial.getLongitude(), longitudes[0], 0.0000001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(85.60006433, latitudes[2], 0.0000001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(92.17243943, longitudes[2], 0.0000001);
+	for (size_t i = 0; i < count; ++i) {
+		GeodeticDestinationValue expected = line.calculatePosition(distances[i]);
+		CPPUNIT_ASSERT_EQUAL(expected.latitude, latitudes[i]);
+		CPPUNIT_ASSERT_EQUAL(expected.longitude, longitudes[i]);
+		CPPUNIT_ASSERT_EQUAL(expected.endBearing, endBearings[i]);
+	}
+}
+
+void GeodesicLineTest::testNanAzimuth() {
+	GlobalCoordinates lincolnMemorial(38.88922, -77.04978);
+	bool exception = false;
+
+	try {
+		GeodesicLine line(*Ellipsoid::WGS84(), lincolnMemorial, nan("foo"));
+	} catch (InvalidAzimuthException &e) {
+		exception = true;
+	}
+	CPPUNIT_ASSERT_EQUAL_MESSAGE("Should have gotten an exception", true, exception);
+}
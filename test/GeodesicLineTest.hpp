@@ -0,0 +1,27 @@
+#ifndef GEODESY_GEODESIC_LINE_TEST_HPP
+#define GEODESY_GEODESIC_LINE_TEST_HPP
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <GeodesicLine.hpp>
+
+class GeodesicLineTest: public CppUnit::TestFixture {
+
+CPPUNIT_TEST_SUITE( GeodesicLineTest);
+
+		// list all test methods here
+		CPPUNIT_TEST(testMatchesDirect);
+		CPPUNIT_TEST(testPositions);
+		CPPUNIT_TEST(testNanAzimuth);
+
+	CPPUNIT_TEST_SUITE_END();
+
+protected:
+	void testMatchesDirect();
+	void testPositions();
+	void testNanAzimuth();
+
+};
+
+#endif // GEODESY_GEODESIC_LINE_TEST_HPP
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#include "GeodeticCalculatorTTest.hpp"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <GeodeticCalculator.hpp>
+#include <GeodeticCalculatorT.hpp>
+#include <cmath>
+
+using namespace geodesy;
+using namespace std;
+CPPUNIT_TEST_SUITE_REGISTRATION( GeodeticCalculatorTTest );
+
+namespace {
+
+/**
+ * Check that a calculator gives the results of GeodeticCalculator on the
+ * ellipsoid of its tag, bit for bit.
+ */
+template<class Tag>
+void checkMatches(const Ellipsoid &ellipsoid) {
+	typedef GeodeticCalculatorT<Tag> Calculator;
+
+	const GlobalPosition points[] = { GlobalPosition(38.88922, -77.04978,
+			10.0), GlobalPosition(48.85889, 2.29583, 35.0), GlobalPosition(
+			-33.8688, 151.2093, 58.0), GlobalPosition(10, 80.6, 0.0),
+			GlobalPosition(-10, -100, 0.0), GlobalPosition(89.5, 12.0,
+					4000.0) };
+	const size_t count = sizeof(points) / sizeof(points[0]);
+
+	for (size_t i = 0; i < count; ++i) {
+		for (size_t j = 0; j < count; ++j) {
+			GeodeticCurveValue expected =
+					GeodeticCalculator::calculateGeodeticCurve(ellipsoid,
+							points[i], points[j]);
+			GeodeticCurveValue curve = Calculator::calculateGeodeticCurve(
+					points[i], points[j]);
+			CPPUNIT_ASSERT_EQUAL(expected.ellipsoidalDistance,
+					curve.ellipsoidalDistance);
+			if (!isnan(expected.azimuth)) {
+				CPPUNIT_ASSERT_EQUAL(expected.azimuth, curve.azimuth);
+				CPPUNIT_ASSERT_EQUAL(expected.reverseAzimuth,
+						curve.reverseAzimuth);
+			}
+
+			GeodeticMeasurementValue expectedMeasurement =
+					GeodeticCalculator::calculateGeodeticMeasurement(ellipsoid,
+							points[i], points[j]);
+			GeodeticMeasurementValue measurement =
+					Calculator::calculateGeodeticMeasurement(points[i],
+							points[j]);
+			CPPUNIT_ASSERT_EQUAL(expectedMeasurement.pointToPointDistance,
+					measurement.pointToPointDistance);
+		}
+
+		GeodeticDestinationValue expected =
+				GeodeticCalculator::calculateEndingGlobalCoordinates(ellipsoid,
+						points[i], 30.0 * i, 1E6);
+		GeodeticDestinationValue destination =
+				Calculator::calculateEndingGlobalCoordinates(points[i],
+						30.0 * i, 1E6);
+		CPPUNIT_ASSERT_EQUAL(expected.latitude, destination.latitude);
+		CPPUNIT_ASSERT_EQUAL(expected.longitude, destination.longitude);
+		CPPUNIT_ASSERT_EQUAL(expected.endBearing, destination.endBearing);
+	}
+}
+
+}
+
+void GeodeticCalculatorTTest::testTags() {
+	// the tags name the shared common ellipsoids
+	CPPUNIT_ASSERT(&WGS84Calculator::getEllipsoid() == Ellipsoid::WGS84().get());
+	CPPUNIT_ASSERT(&GeodeticCalculatorT<GRS80Tag>::getEllipsoid() == Ellipsoid::GRS80().get());
+	CPPUNIT_ASSERT(&GeodeticCalculatorT<GRS67Tag>::getEllipsoid() == Ellipsoid::GRS67().get());
+	CPPUNIT_ASSERT(&GeodeticCalculatorT<WGS72Tag>::getEllipsoid() == Ellipsoid::WGS72().get());
+	CPPUNIT_ASSERT(&GeodeticCalculatorT<Clarke1858Tag>::getEllipsoid() == Ellipsoid::Clarke1858().get());
+	CPPUNIT_ASSERT(&GeodeticCalculatorT<Clarke1880Tag>::getEllipsoid() == Ellipsoid::Clarke1880().get());
+	CPPUNIT_ASSERT(&GeodeticCalculatorT<SphereTag>::getEllipsoid() == Ellipsoid::Sphere().get());
+
+	// Lincoln Memorial to the Eiffel Tower
+	GeodeticCurveValue curve = WGS84Calculator::calculateGeodeticCurve(
+			GlobalCoordinates(38.88922, -77.04978),
+			GlobalCoordinates(48.85889, 2.29583));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(6179016.136, curve.ellipsoidalDistance, 0.001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(51.76792142, curve.azimuth, 0.0000001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(291.75529334, curve.reverseAzimuth, 0.0000001);
+}
+
+void GeodeticCalculatorTTest::testMatchesCalculator() {
+	checkMatches<WGS84Tag>(*Ellipsoid::WGS84());
+	checkMatches<GRS80Tag>(*Ellipsoid::GRS80());
+	checkMatches<Clarke1880Tag>(*Ellipsoid::Clarke1880());
+	checkMatches<SphereTag>(*Ellipsoid::Sphere());
+}
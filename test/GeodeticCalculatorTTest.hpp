@@ -0,0 +1,25 @@
+#ifndef GEODESY_GEODETIC_CALCULATOR_T_TEST_HPP
+#define GEODESY_GEODETIC_CALCULATOR_T_TEST_HPP
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <GeodeticCalculatorT.hpp>
+
+class GeodeticCalculatorTTest: public CppUnit::TestFixture {
+
+CPPUNIT_TEST_SUITE( GeodeticCalculatorTTest);
+
+		// list all test methods here
+		CPPUNIT_TEST(testTags);
+		CPPUNIT_TEST(testMatchesCalculator);
+
+	CPPUNIT_TEST_SUITE_END();
+
+protected:
+	void testTags();
+	void testMatchesCalculator();
+
+};
+
+#endif // GEODESY_GEODETIC_CALCULATOR_T_TEST_HPP
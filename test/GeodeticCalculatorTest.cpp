@@ -31,8 +31,11 @@
 #include <cppunit/extensions/HelperMacros.h>
 
 #include <GeodeticCalculator.hpp>
+#include <VincentySimd.hpp>
 #include <tr1/memory>
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 using namespace geodesy;
 using namespace std;
@@ -197,3 +200,394 @@ void GeodeticCalculatorTest::testNanAzimuth() {
 	}
 	CPPUNIT_ASSERT_EQUAL_MESSAGE("Should have gotten an exception", true, exception);
 }
+
+void GeodeticCalculatorTest::testBatchGeodeticCurves() {
+	shared_ptr<const Ellipsoid> reference = Ellipsoid::WGS84();
+
+	// Lincoln Memorial to Eiffel Tower, the antipodal cases, a zero length
+	// curve and a pair that needs canonicalizing
+	const double lat1[] = { 38.88922, 10, 11, 38.88922, 100 };
+	const double lon1[] = { -77.04978, 80.6, 80, -77.04978, 370 };
+	const double lat2[] = { 48.85889, -10, -10, 38.88922, -45 };
+	const double lon2[] = { 2.29583, -100, -100, -77.04978, -530 };
+	const size_t count = sizeof(lat1) / sizeof(lat1[0]);
+
+	double distances[count];
+	double azimuths[count];
+	double reverseAzimuths[count];
+	GeodeticCalculator::calculateGeodeticCurves(reference, count, lat1, lon1,
+			lat2, lon2, distances, azimuths, reverseAzimuths);
+
+	for (size_t i = 0; i < count; ++i) {
+		GeodeticCurve::Ptr expected = GeodeticCalculator::calculateGeodeticCurve(
+				reference, GlobalCoordinates(lat1[i], lon1[i]),
+				GlobalCoordinates(lat2[i], lon2[i]));
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(expected->getEllipsoidalDistance(), distances[i], 0.001);
+		if (!isnan(expected->getAzimuth())) {
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(expected->getAzimuth(), azimuths[i], 0.0000001);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(expected->getReverseAzimuth(), reverseAzimuths[i], 0.0000001);
+		}
+	}
+
+	// the azimuth outputs are optional
+	double distance;
+	GeodeticCalculator::calculateGeodeticCurves(reference, 1, lat1, lon1, lat2,
+			lon2, &distance, 0, 0);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(6179016.136, distance, 0.001);
+}
+
+void GeodeticCalculatorTest::testSimdInverseKernels() {
+	shared_ptr<const Ellipsoid> reference = Ellipsoid::WGS84();
+
+	// one lane converges quickly, the antipodal ones take all the iterations
+	// and two never converge (coincident and N/S)
+	const double lat1[] = { 38.88922, 10, 11, 38.88922, -45, 0, 89.5, 12 };
+	const double lon1[] = { -77.04978, 80.6, 80, -77.04978, 10, 0, 1, 34 };
+	const double lat2[] = { 48.85889, -10, -10, 38.88922, 45, 0.5, -89.5, 13 };
+	const double lon2[] = { 2.29583, -100, -100, -77.04978, 10, 179.7, -179, 34 };
+	const size_t count = sizeof(lat1) / sizeof(lat1[0]);
+
+	size_t kernelCount;
+	const simd::Kernels *kernels = simd::availableKernels(kernelCount);
+	for (size_t k = 0; k < kernelCount; ++k) {
+		double distances[count];
+		double azimuths[count];
+		double reverseAzimuths[count];
+		kernels[k].inverse(reference->getSemiMajorAxis(),
+				reference->getSemiMinorAxis(), reference->getFlattening(), 1E-13,
+				20, count, lat1, lon1, lat2, lon2, distances, azimuths,
+				reverseAzimuths);
+
+		for (size_t i = 0; i < count; ++i) {
+			GeodeticCurve::Ptr expected =
+					GeodeticCalculator::calculateGeodeticCurve(reference,
+							GlobalCoordinates(lat1[i], lon1[i]),
+							GlobalCoordinates(lat2[i], lon2[i]));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(expected->getEllipsoidalDistance(), distances[i], 0.000001);
+			CPPUNIT_ASSERT_EQUAL(isnan(expected->getAzimuth()), isnan(azimuths[i]));
+			if (!isnan(expected->getAzimuth())) {
+				CPPUNIT_ASSERT_DOUBLES_EQUAL(expected->getAzimuth(), azimuths[i], 0.000000001);
+				CPPUNIT_ASSERT_DOUBLES_EQUAL(expected->getReverseAzimuth(), reverseAzimuths[i], 0.000000001);
+			}
+		}
+	}
+}
+
+void GeodeticCalculatorTest::testBatchEndingGlobalCoordinates() {
+	shared_ptr<const Ellipsoid> reference = Ellipsoid::WGS84();
+
+	// Lincoln Memorial to Eiffel Tower, the pole crossing, zero distance, a
+	// start on the pole and one that needs canonicalizing
+	const double lat[] = { 38.88922, 38.88922, 38.88922, 90, 120 };
+	const double lon[] = { -77.04978, -77.04978, -77.04978, 0, 370 };
+	const double bearing[] = { 51.76792142, 1.0, 1.0, 180, -45 };
+	const double distance[] = { 6179016.136, 6179016.13586, 0, 1000, 5000000 };
+	const size_t count = sizeof(lat) / sizeof(lat[0]);
+
+	double endLatitudes[count];
+	double endLongitudes[count];
+	double endBearings[count];
+	GeodeticCalculator::calculateEndingGlobalCoordinates(reference, count, lat,
+			lon, bearing, distance, endLatitudes, endLongitudes, endBearings);
+
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(48.85889, endLatitudes[0], 0.0000001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(2.29583, endLongitudes[0], 0.0000001);
+	for (size_t i = 0; i < count; ++i) {
+		double endBearing;
+		GlobalCoordinates::Ptr expected =
+				GeodeticCalculator::calculateEndingGlobalCoordinates(reference,
+						GlobalCoordinates(lat[i], lon[i]), bearing[i], distance[i],
+						endBearing);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(expected->getLatitude(), endLatitudes[i], 0.000000001);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(expected->getLongitude(), endLongitudes[i], 0.000000001);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(endBearing, endBearings[i], 0.000000001);
+	}
+
+	// a NaN bearing anywhere is rejected
+	double badBearings[count];
+	std::copy(bearing, bearing + count, badBearings);
+	badBearings[count - 1] = nan("foo");
+	bool exception = false;
+	try {
+		GeodeticCalculator::calculateEndingGlobalCoordinates(reference, count,
+				lat, lon, badBearings, distance, endLatitudes, endLongitudes, 0);
+	} catch (InvalidAzimuthException &e) {
+		exception = true;
+	}
+	CPPUNIT_ASSERT_EQUAL_MESSAGE("Should have gotten an exception", true, exception);
+}
+
+void GeodeticCalculatorTest::testSimdDirectKernels() {
+	shared_ptr<const Ellipsoid> reference = Ellipsoid::WGS84();
+
+	const double lat[] = { 38.88922, 38.88922, 38.88922, 90, -89, 0, 12, 45 };
+	const double lon[] = { -77.04978, -77.04978, -77.04978, 0, 100, 179, 34, -170 };
+	const double bearing[] = { 51.76792142, 1.0, 1.0, 180, 0, 90, 300, -45 };
+	const double distance[] = { 6179016.136, 6179016.13586, 0, 1000, 19000000, 1, 250000, 5000000 };
+	const size_t count = sizeof(lat) / sizeof(lat[0]);
+
+	size_t kernelCount;
+	const simd::Kernels *kernels = simd::availableKernels(kernelCount);
+	for (size_t k = 0; k < kernelCount; ++k) {
+		double endLatitudes[count];
+		double endLongitudes[count];
+		double endBearings[count];
+		kernels[k].direct(reference->getSemiMajorAxis(),
+				reference->getSemiMinorAxis(), reference->getFlattening(), 1E-13,
+				20, count, lat, lon, bearing, distance, endLatitudes,
+				endLongitudes, endBearings);
+
+		for (size_t i = 0; i < count; ++i) {
+			double endBearing;
+			GlobalCoordinates::Ptr expected =
+					GeodeticCalculator::calculateEndingGlobalCoordinates(
+							reference, GlobalCoordinates(lat[i], lon[i]),
+							bearing[i], distance[i], endBearing);
+			GlobalCoordinates actual(endLatitudes[i], endLongitudes[i]);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(expected->getLatitude(), actual.getLatitude(), 0.000000001);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(expected->getLongitude(), actual.getLongitude(), 0.000000001);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(endBearing, endBearings[i], 0.000000001);
+		}
+	}
+}
+
+void GeodeticCalculatorTest::testValueResults() {
+	const Ellipsoid &reference = *Ellipsoid::WGS84();
+
+	GlobalCoordinates lincolnMemorial(38.88922, -77.04978);
+	GlobalCoordinates eiffelTower(48.85889, 2.29583);
+
+	GeodeticCurveValue curve = GeodeticCalculator::calculateGeodeticCurve(
+			reference, lincolnMemorial, eiffelTower);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(6179016.136, curve.ellipsoidalDistance, 0.001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(51.76792142, curve.azimuth, 0.0000001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(291.75529334, curve.reverseAzimuth, 0.0000001);
+
+	GeodeticDestinationValue dest =
+			GeodeticCalculator::calculateEndingGlobalCoordinates(reference,
+					lincolnMemorial, curve.azimuth, curve.ellipsoidalDistance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(eiffelTower.getLatitude(), dest.latitude, 0.0000001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(eiffelTower.getLongitude(), dest.longitude, 0.0000001);
+
+	double endBearing;
+	GlobalCoordinates::Ptr expected =
+			GeodeticCalculator::calculateEndingGlobalCoordinates(
+					Ellipsoid::WGS84(), lincolnMemorial, curve.azimuth,
+					curve.ellipsoidalDistance, endBearing);
+	CPPUNIT_ASSERT_EQUAL(endBearing, dest.endBearing);
+
+	GlobalPosition pikesPeak(38.840511, -105.0445896, 4301.0);
+	GlobalPosition alcatrazIsland(37.826389, -122.4225, 0.0);
+	GeodeticMeasurementValue measurement =
+			GeodeticCalculator::calculateGeodeticMeasurement(reference,
+					pikesPeak, alcatrazIsland);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(-4301.0, measurement.elevationChange, 0.001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(1521788.826, measurement.pointToPointDistance, 0.001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(1521782.748, measurement.ellipsoidalDistance, 0.001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(271.21039153, measurement.azimuth, 0.0000001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(80.38029386, measurement.reverseAzimuth, 0.0000001);
+
+	bool exception = false;
+	try {
+		GeodeticCalculator::calculateEndingGlobalCoordinates(reference,
+				lincolnMemorial, nan("foo"), 0);
+	} catch (InvalidAzimuthException &e) {
+		exception = true;
+	}
+	CPPUNIT_ASSERT_EQUAL_MESSAGE("Should have gotten an exception", true, exception);
+}
+
+void GeodeticCalculatorTest::testWaypoints() {
+	shared_ptr<const Ellipsoid> reference = Ellipsoid::WGS84();
+	GlobalCoordinates lincolnMemorial(38.88922, -77.04978);
+	GlobalCoordinates eiffelTower(48.85889, 2.29583);
+
+	const size_t count = 11;
+	double latitudes[count];
+	double longitudes[count];
+	double bearings[count];
+	double distance = GeodeticCalculator::calculateWaypoints(*reference,
+			lincolnMemorial, eiffelTower, count, latitudes, longitudes,
+			bearings);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(6179016.136, distance, 0.001);
+
+	// the ends exactly, the points in between evenly spaced on the geodesic
+	CPPUNIT_ASSERT_EQUAL(lincolnMemorial.getLatitude(), latitudes[0]);
+	CPPUNIT_ASSERT_EQUAL(lincolnMemorial.getLongitude(), longitudes[0]);
+	CPPUNIT_ASSERT_EQUAL(eiffelTower.getLatitude(), latitudes[count - 1]);
+	CPPUNIT_ASSERT_EQUAL(eiffelTower.getLongitude(), longitudes[count - 1]);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(51.76792142, bearings[0], 0.0000001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(111.75529334, bearings[count - 1], 0.0000001);
+	for (size_t i = 1; i < count; ++i) {
+		GlobalCoordinates point(latitudes[i], longitudes[i]);
+		GeodeticCurveValue fromStart = GeodeticCalculator::calculateGeodeticCurve(
+				*reference, lincolnMemorial, point);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(distance * i / (count - 1),
+				fromStart.ellipsoidalDistance, 0.001);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(51.76792142, fromStart.azimuth, 0.0000001);
+
+		GeodeticCurveValue step = GeodeticCalculator::calculateGeodeticCurve(
+				*reference, GlobalCoordinates(latitudes[i - 1], longitudes[i - 1]),
+				point);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(distance / (count - 1),
+				step.ellipsoidalDistance, 0.001);
+	}
+
+	// one point is the start, and no bearings are optional
+	GeodeticCalculator::calculateWaypoints(*reference, lincolnMemorial,
+			eiffelTower, 1, latitudes, longitudes);
+	CPPUNIT_ASSERT_EQUAL(lincolnMemorial.getLatitude(), latitudes[0]);
+
+	// nearly antipodal, with Karney's method
+	GlobalCoordinates start(0, 0);
+	GlobalCoordinates end(0.5, 179.7);
+	distance = GeodeticCalculator::calculateWaypoints(*reference, start, end,
+			3, latitudes, longitudes, bearings, GeodeticCalculator::Karney);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(19944127.42075, distance, 0.00001);
+	GeodeticCurveValue half = GeodeticCalculator::calculateGeodeticCurve(
+			*reference, start, GlobalCoordinates(latitudes[1], longitudes[1]),
+			GeodeticCalculator::Karney);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(distance / 2, half.ellipsoidalDistance, 0.001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(15.5568827935, half.azimuth, 0.000001);
+}
+
+void GeodeticCalculatorTest::testWaypointsBySpacing() {
+	shared_ptr<const Ellipsoid> reference = Ellipsoid::WGS84();
+	GlobalCoordinates start(10, 20);
+	GlobalCoordinates end(10.5, 20.5);
+	double distance = GeodeticCalculator::calculateGeodeticCurve(*reference,
+			start, end).ellipsoidalDistance;
+
+	double latitudes[20];
+	double longitudes[20];
+	double bearings[20];
+	size_t count = GeodeticCalculator::calculateWaypointsBySpacing(*reference,
+			start, end, 10000, 20, latitudes, longitudes, bearings);
+	size_t expected = static_cast<size_t>(ceil(distance / 10000)) + 1;
+	CPPUNIT_ASSERT_EQUAL(expected, count);
+	CPPUNIT_ASSERT_EQUAL(end.getLatitude(), latitudes[count - 1]);
+	CPPUNIT_ASSERT_EQUAL(end.getLongitude(), longitudes[count - 1]);
+	for (size_t i = 1; i + 1 < count; ++i) {
+		GeodeticCurveValue step = GeodeticCalculator::calculateGeodeticCurve(
+				*reference, GlobalCoordinates(latitudes[i - 1], longitudes[i - 1]),
+				GlobalCoordinates(latitudes[i], longitudes[i]));
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(10000.0, step.ellipsoidalDistance, 0.001);
+	}
+
+	// too small a buffer: the count, nothing written
+	latitudes[0] = -1;
+	CPPUNIT_ASSERT_EQUAL(expected,
+			GeodeticCalculator::calculateWaypointsBySpacing(*reference, start,
+					end, 10000, expected - 1, latitudes, longitudes));
+	CPPUNIT_ASSERT_EQUAL(-1.0, latitudes[0]);
+
+	// coincident points and bad spacings
+	CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1),
+			GeodeticCalculator::calculateWaypointsBySpacing(*reference, start,
+					start, 10000, 20, latitudes, longitudes));
+	CPPUNIT_ASSERT_EQUAL(start.getLatitude(), latitudes[0]);
+	CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0),
+			GeodeticCalculator::calculateWaypointsBySpacing(*reference, start,
+					end, 0, 20, latitudes, longitudes));
+	CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0),
+			GeodeticCalculator::calculateWaypointsBySpacing(*reference, start,
+					end, NAN, 20, latitudes, longitudes));
+}
+
+void GeodeticCalculatorTest::testBatchGeodeticMeasurements() {
+	shared_ptr<const Ellipsoid> reference = Ellipsoid::WGS84();
+
+	// a flight climbing out of Denver, Pike's Peak to Alcatraz Island, points
+	// below the ellipsoid and a pair of coincident points
+	vector<GlobalPosition> starts;
+	vector<GlobalPosition> ends;
+	starts.push_back(GlobalPosition(39.8561, -104.6737, 1655.0));
+	ends.push_back(GlobalPosition(39.9012, -104.5521, 2410.5));
+	starts.push_back(GlobalPosition(38.840511, -105.0445896, 4301.0));
+	ends.push_back(GlobalPosition(37.826389, -122.4225, 0.0));
+	starts.push_back(GlobalPosition(31.5590, 35.4732, -430.5));
+	ends.push_back(GlobalPosition(-33.8688, 151.2093, 58.0));
+	starts.push_back(GlobalPosition(10, 80.6, 120.0));
+	ends.push_back(GlobalPosition(10, 80.6, 120.0));
+
+	vector<GeodeticMeasurementValue> measurements(starts.size());
+	GeodeticCalculator::calculateGeodeticMeasurements(*reference,
+			starts.size(), &starts[0], &ends[0], &measurements[0]);
+
+	// bit for bit the single pair results
+	for (size_t i = 0; i < starts.size(); ++i) {
+		GeodeticMeasurementValue expected =
+				GeodeticCalculator::calculateGeodeticMeasurement(*reference,
+						starts[i], ends[i]);
+		CPPUNIT_ASSERT_EQUAL(expected.ellipsoidalDistance,
+				measurements[i].ellipsoidalDistance);
+		if (!isnan(expected.azimuth)) {
+			CPPUNIT_ASSERT_EQUAL(expected.azimuth, measurements[i].azimuth);
+			CPPUNIT_ASSERT_EQUAL(expected.reverseAzimuth,
+					measurements[i].reverseAzimuth);
+		}
+		CPPUNIT_ASSERT_EQUAL(expected.elevationChange,
+				measurements[i].elevationChange);
+		CPPUNIT_ASSERT_EQUAL(expected.pointToPointDistance,
+				measurements[i].pointToPointDistance);
+	}
+
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(1521788.826, measurements[1].pointToPointDistance, 0.001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, measurements[3].pointToPointDistance, 0.0);
+	CPPUNIT_ASSERT(isnan(measurements[3].azimuth));
+
+	// nothing to do, nothing written
+	GeodeticCalculator::calculateGeodeticMeasurements(*reference, 0, 0, 0, 0);
+}
+
+void GeodeticCalculatorTest::testBatchEllipsoidByReference() {
+	const Ellipsoid::ConstPtr &reference = Ellipsoid::WGS84();
+
+	const double lat1[] = { 38.88922, 10, 38.88922, 100 };
+	const double lon1[] = { -77.04978, 80.6, -77.04978, 370 };
+	const double lat2[] = { 48.85889, -10, 38.88922, -45 };
+	const double lon2[] = { 2.29583, -100, -77.04978, -530 };
+	const size_t count = sizeof(lat1) / sizeof(lat1[0]);
+
+	// bit for bit the results of the pointer forms
+	GeodeticCalculator::InverseMethod methods[] = { GeodeticCalculator::Vincenty,
+			GeodeticCalculator::Karney };
+	for (size_t m = 0; m < 2; ++m) {
+		double expectedDistances[count];
+		double expectedAzimuths[count];
+		double distances[count];
+		double azimuths[count];
+		GeodeticCalculator::calculateGeodeticCurves(reference, count, lat1,
+				lon1, lat2, lon2, expectedDistances, expectedAzimuths, 0,
+				methods[m]);
+		GeodeticCalculator::calculateGeodeticCurves(*reference, count, lat1,
+				lon1, lat2, lon2, distances, azimuths, 0, methods[m]);
+		for (size_t i = 0; i < count; ++i) {
+			CPPUNIT_ASSERT_EQUAL(expectedDistances[i], distances[i]);
+			if (!isnan(expectedAzimuths[i])) {
+				CPPUNIT_ASSERT_EQUAL(expectedAzimuths[i], azimuths[i]);
+			}
+		}
+	}
+
+	double distance;
+	GeodeticCalculator::calculateGeodeticCurves(*reference, 1, lat1, lon1, lat2,
+			lon2, &distance, 0, 0);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(6179016.136, distance, 0.001);
+
+	const double bearings[] = { 51.7679, 0, 180, -30 };
+	const double distances[] = { 6179016.136, 1000, 0, 20000000 };
+	double expectedLatitudes[count];
+	double expectedLongitudes[count];
+	double latitudes[count];
+	double longitudes[count];
+	GeodeticCalculator::calculateEndingGlobalCoordinates(reference, count,
+			lat1, lon1, bearings, distances, expectedLatitudes,
+			expectedLongitudes, 0);
+	GeodeticCalculator::calculateEndingGlobalCoordinates(*reference, count,
+			lat1, lon1, bearings, distances, latitudes, longitudes, 0);
+	for (size_t i = 0; i < count; ++i) {
+		CPPUNIT_ASSERT_EQUAL(expectedLatitudes[i], latitudes[i]);
+		CPPUNIT_ASSERT_EQUAL(expectedLongitudes[i], longitudes[i]);
+	}
+}
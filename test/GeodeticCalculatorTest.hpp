@@ -20,6 +20,15 @@ CPPUNIT_TEST_SUITE( GeodeticCalculatorTest);
 		CPPUNIT_TEST(testPoleCrossing);
 		CPPUNIT_TEST(testZeroDistance);
 		CPPUNIT_TEST(testNanAzimuth);
+		CPPUNIT_TEST(testBatchGeodeticCurves);
+		CPPUNIT_TEST(testSimdInverseKernels);
+		CPPUNIT_TEST(testBatchEndingGlobalCoordinates);
+		CPPUNIT_TEST(testSimdDirectKernels);
+		CPPUNIT_TEST(testValueResults);
+		CPPUNIT_TEST(testWaypoints);
+		CPPUNIT_TEST(testWaypointsBySpacing);
+		CPPUNIT_TEST(testBatchGeodeticMeasurements);
+		CPPUNIT_TEST(testBatchEllipsoidByReference);
 
 	CPPUNIT_TEST_SUITE_END();
 
@@ -32,6 +41,15 @@ protected:
 	void testPoleCrossing();
 	void testZeroDistance();
 	void testNanAzimuth();
+	void testBatchGeodeticCurves();
+	void testSimdInverseKernels();
+	void testBatchEndingGlobalCoordinates();
+	void testSimdDirectKernels();
+	void testValueResults();
+	void testWaypoints();
+	void testWaypointsBySpacing();
+	void testBatchGeodeticMeasurements();
+	void testBatchEllipsoidByReference();
 
 };
 
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#include "GlobalCoordinatesTest.hpp"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <GlobalCoordinates.hpp>
+#include <GlobalPosition.hpp>
+#include <LatLon.hpp>
+#include <cmath>
+#include <vector>
+
+using namespace geodesy;
+using namespace std;
+CPPUNIT_TEST_SUITE_REGISTRATION( GlobalCoordinatesTest );
+
+void GlobalCoordinatesTest::testCanonicalize() {
+	// canonical values are kept exactly
+	GlobalCoordinates coordinates(38.88922, -77.04978);
+	CPPUNIT_ASSERT_EQUAL(38.88922, coordinates.getLatitude());
+	CPPUNIT_ASSERT_EQUAL(-77.04978, coordinates.getLongitude());
+
+	coordinates = GlobalCoordinates(-90, 180);
+	CPPUNIT_ASSERT_EQUAL(-90.0, coordinates.getLatitude());
+	CPPUNIT_ASSERT_EQUAL(180.0, coordinates.getLongitude());
+
+	coordinates = GlobalCoordinates(0, -180);
+	CPPUNIT_ASSERT_EQUAL(180.0, coordinates.getLongitude());
+
+	coordinates = GlobalCoordinates(95, 10);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(85.0, coordinates.getLatitude(), 1E-12);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(-170.0, coordinates.getLongitude(), 1E-12);
+
+	coordinates = GlobalCoordinates(-30, 370);
+	CPPUNIT_ASSERT_EQUAL(-30.0, coordinates.getLatitude());
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(10.0, coordinates.getLongitude(), 1E-12);
+
+	CPPUNIT_ASSERT(GlobalCoordinates::isCanonical(90, 180));
+	CPPUNIT_ASSERT(!GlobalCoordinates::isCanonical(0, -180));
+	CPPUNIT_ASSERT(!GlobalCoordinates::isCanonical(90.5, 0));
+	CPPUNIT_ASSERT(!GlobalCoordinates::isCanonical(NAN, 0));
+	CPPUNIT_ASSERT(!GlobalCoordinates::isCanonical(0, NAN));
+}
+
+void GlobalCoordinatesTest::testCanonicalizeArrays() {
+	// mostly canonical, with outliers in some blocks and a partial last block
+	const size_t count = 37;
+	vector<double> latitudes(count);
+	vector<double> longitudes(count);
+	for (size_t i = 0; i < count; ++i) {
+		latitudes[i] = -85.0 + 4.5 * i;
+		longitudes[i] = -175.0 + 9.5 * i;
+	}
+	latitudes[3] = 100;
+	longitudes[12] = -180;
+	latitudes[20] = -450;
+	longitudes[35] = 725;
+	latitudes[36] = NAN;
+
+	vector<double> expectedLatitudes(latitudes);
+	vector<double> expectedLongitudes(longitudes);
+	for (size_t i = 0; i < count; ++i) {
+		GlobalCoordinates::canonicalize(expectedLatitudes[i],
+				expectedLongitudes[i]);
+	}
+	vector<LatLon> values(count);
+	for (size_t i = 0; i < count; ++i) {
+		LatLon value = { latitudes[i], longitudes[i] };
+		values[i] = value;
+	}
+
+	GlobalCoordinates::canonicalize(count, &latitudes[0], &longitudes[0]);
+	LatLon::canonicalize(count, &values[0]);
+	for (size_t i = 0; i + 1 < count; ++i) {
+		CPPUNIT_ASSERT_EQUAL(expectedLatitudes[i], latitudes[i]);
+		CPPUNIT_ASSERT_EQUAL(expectedLongitudes[i], longitudes[i]);
+		CPPUNIT_ASSERT_EQUAL(expectedLatitudes[i], values[i].latitude);
+		CPPUNIT_ASSERT_EQUAL(expectedLongitudes[i], values[i].longitude);
+		CPPUNIT_ASSERT(GlobalCoordinates::isCanonical(latitudes[i], longitudes[i]));
+	}
+	CPPUNIT_ASSERT(isnan(latitudes[count - 1]));
+	CPPUNIT_ASSERT(isnan(values[count - 1].latitude));
+}
+
+void GlobalCoordinatesTest::testAssumeCanonical() {
+	GlobalCoordinates coordinates(100, 190, GlobalCoordinates::AssumeCanonical);
+	CPPUNIT_ASSERT_EQUAL(100.0, coordinates.getLatitude());
+	CPPUNIT_ASSERT_EQUAL(190.0, coordinates.getLongitude());
+
+	// the setters still canonicalize
+	coordinates.setLongitude(190);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(80.0, coordinates.getLatitude(), 1E-12);
+
+	GlobalPosition position(100, 190, 5, GlobalCoordinates::AssumeCanonical);
+	CPPUNIT_ASSERT_EQUAL(100.0, position.getLatitude());
+	CPPUNIT_ASSERT_EQUAL(5.0, position.getElevation());
+
+	GlobalPosition canonical(100, 190, 5);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(80.0, canonical.getLatitude(), 1E-12);
+}
@@ -0,0 +1,27 @@
+#ifndef GEODESY_GLOBAL_COORDINATES_TEST_HPP
+#define GEODESY_GLOBAL_COORDINATES_TEST_HPP
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <GlobalCoordinates.hpp>
+
+class GlobalCoordinatesTest: public CppUnit::TestFixture {
+
+CPPUNIT_TEST_SUITE( GlobalCoordinatesTest);
+
+		// list all test methods here
+		CPPUNIT_TEST(testCanonicalize);
+		CPPUNIT_TEST(testCanonicalizeArrays);
+		CPPUNIT_TEST(testAssumeCanonical);
+
+	CPPUNIT_TEST_SUITE_END();
+
+protected:
+	void testCanonicalize();
+	void testCanonicalizeArrays();
+	void testAssumeCanonical();
+
+};
+
+#endif // GEODESY_GLOBAL_COORDINATES_TEST_HPP
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#include "KarneyInverseTest.hpp"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <KarneyInverse.hpp>
+#include <GeodeticCalculator.hpp>
+#include <cmath>
+
+using namespace geodesy;
+using namespace std;
+using namespace std::tr1;
+CPPUNIT_TEST_SUITE_REGISTRATION( KarneyInverseTest );
+
+void KarneyInverseTest::testCalculateGeodeticCurve() {
+	KarneyInverse inverse(*Ellipsoid::WGS84());
+
+	// Lincoln Memorial to Eiffel Tower, same as Vincenty's method
+	GeodeticCurveValue curve = inverse.calculateGeodeticCurve(
+			GlobalCoordinates(38.88922, -77.04978),
+			GlobalCoordinates(48.85889, 2.29583));
+
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(6179016.136, curve.ellipsoidalDistance, 0.001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(51.76792142, curve.azimuth, 0.0000001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(291.75529334, curve.reverseAzimuth, 0.0000001);
+}
+
+void KarneyInverseTest::testNearlyAntipodal() {
+	shared_ptr<const Ellipsoid> reference = Ellipsoid::WGS84();
+	KarneyInverse inverse(*reference);
+
+	// reference values from GeographicLib
+	GlobalCoordinates start(0, 0);
+	GlobalCoordinates end(0.5, 179.7);
+	GeodeticCurveValue curve = inverse.calculateGeodeticCurve(start, end);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(19944127.42075, curve.ellipsoidalDistance, 0.00001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(15.5568827935, curve.azimuth, 0.0000000001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(344.4425138909, curve.reverseAzimuth, 0.0000000001);
+
+	// Vincenty's method doesn't converge here and falls back to due north
+	GeodeticCurveValue vincenty = GeodeticCalculator::calculateGeodeticCurve(
+			*reference, start, end);
+	CPPUNIT_ASSERT_EQUAL(0.0, vincenty.azimuth);
+
+	curve = inverse.calculateGeodeticCurve(GlobalCoordinates(-30, 0),
+			GlobalCoordinates(29.9, 179.8));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(19989832.82761, curve.ellipsoidalDistance, 0.00001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(161.8905247363, curve.azimuth, 0.0000000001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(198.0907372457, curve.reverseAzimuth, 0.0000000001);
+}
+
+void KarneyInverseTest::testSpecialCases() {
+	KarneyInverse inverse(*Ellipsoid::WGS84());
+	double s, alpha1, alpha2;
+
+	// antipodal on the equator, the shortest path is over the pole
+	inverse.solve(0, 0, 0, 180, s, alpha1, alpha2);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(20003931.458625, s, 0.000001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, alpha1, 0.0000000001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, alpha2, 0.0000000001);
+
+	// pole to pole
+	inverse.solve(90, 0, -90, 0, s, alpha1, alpha2);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(20003931.458625, s, 0.000001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(180.0, alpha1, 0.0000000001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, alpha2, 0.0000000001);
+
+	// along the equator
+	inverse.solve(0, 10, 0, 20, s, alpha1, alpha2);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(6378137.0 * M_PI / 18, s, 0.000001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(90.0, alpha1, 0.0000000001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(270.0, alpha2, 0.0000000001);
+
+	// coincident points
+	inverse.solve(10, 20, 10, 20, s, alpha1, alpha2);
+	CPPUNIT_ASSERT_EQUAL(0.0, s);
+	CPPUNIT_ASSERT(!isnan(alpha1));
+	CPPUNIT_ASSERT(!isnan(alpha2));
+
+	// a sphere
+	KarneyInverse sphere(*Ellipsoid::Sphere());
+	sphere.solve(0, 0, 0, 90, s, alpha1, alpha2);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(Ellipsoid::Sphere()->getSemiMajorAxis() * M_PI / 2, s, 0.000001);
+}
+
+void KarneyInverseTest::testMethodSelection() {
+	shared_ptr<const Ellipsoid> reference = Ellipsoid::WGS84();
+	KarneyInverse inverse(*reference);
+
+	const double lat1[] = { 38.88922, 0, -30, 10, 0 };
+	const double lon1[] = { -77.04978, 0, 0, 20, 370 };
+	const double lat2[] = { 48.85889, 0.5, 29.9, 10, 0 };
+	const double lon2[] = { 2.29583, 179.7, 179.8, 20, 180 };
+	const size_t count = sizeof(lat1) / sizeof(lat1[0]);
+
+	double distances[count];
+	double azimuths[count];
+	double reverseAzimuths[count];
+	GeodeticCalculator::calculateGeodeticCurves(reference, count, lat1, lon1,
+			lat2, lon2, distances, azimuths, reverseAzimuths,
+			GeodeticCalculator::Karney);
+
+	for (size_t i = 0; i < count; ++i) {
+		GlobalCoordinates start(lat1[i], lon1[i]);
+		GlobalCoordinates end(lat2[i], lon2[i]);
+		GeodeticCurveValue expected = inverse.calculateGeodeticCurve(start,
+				end);
+		CPPUNIT_ASSERT_EQUAL(expected.ellipsoidalDistance, distances[i]);
+		CPPUNIT_ASSERT_EQUAL(expected.azimuth, azimuths[i]);
+		CPPUNIT_ASSERT_EQUAL(expected.reverseAzimuth, reverseAzimuths[i]);
+
+		GeodeticCurve::Ptr curve = GeodeticCalculator::calculateGeodeticCurve(
+				reference, start, end, GeodeticCalculator::Karney);
+		CPPUNIT_ASSERT_EQUAL(expected.ellipsoidalDistance, curve->getEllipsoidalDistance());
+		CPPUNIT_ASSERT_EQUAL(expected.azimuth, curve->getAzimuth());
+		CPPUNIT_ASSERT_EQUAL(expected.reverseAzimuth, curve->getReverseAzimuth());
+	}
+}
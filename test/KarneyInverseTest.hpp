@@ -0,0 +1,29 @@
+#ifndef GEODESY_KARNEY_INVERSE_TEST_HPP
+#define GEODESY_KARNEY_INVERSE_TEST_HPP
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <KarneyInverse.hpp>
+
+class KarneyInverseTest: public CppUnit::TestFixture {
+
+CPPUNIT_TEST_SUITE( KarneyInverseTest);
+
+		// list all test methods here
+		CPPUNIT_TEST(testCalculateGeodeticCurve);
+		CPPUNIT_TEST(testNearlyAntipodal);
+		CPPUNIT_TEST(testSpecialCases);
+		CPPUNIT_TEST(testMethodSelection);
+
+	CPPUNIT_TEST_SUITE_END();
+
+protected:
+	void testCalculateGeodeticCurve();
+	void testNearlyAntipodal();
+	void testSpecialCases();
+	void testMethodSelection();
+
+};
+
+#endif // GEODESY_KARNEY_INVERSE_TEST_HPP
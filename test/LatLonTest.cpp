@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#include "LatLonTest.hpp"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <LatLon.hpp>
+#include <cstring>
+
+using namespace geodesy;
+using namespace std;
+CPPUNIT_TEST_SUITE_REGISTRATION( LatLonTest );
+
+void LatLonTest::testLayout() {
+	CPPUNIT_ASSERT_EQUAL(2 * sizeof(double), sizeof(LatLon));
+	CPPUNIT_ASSERT_EQUAL(3 * sizeof(double), sizeof(LatLonAlt));
+
+	// aggregates, laid out like plain arrays of doubles
+	LatLon points[] = { { 1, 2 }, { 3, 4 } };
+	double raw[4];
+	memcpy(raw, points, sizeof(points));
+	CPPUNIT_ASSERT_EQUAL(1.0, raw[0]);
+	CPPUNIT_ASSERT_EQUAL(4.0, raw[3]);
+
+	LatLonAlt positions[2];
+	const double values[] = { 5, 6, 7, 8, 9, 10 };
+	memcpy(positions, values, sizeof(positions));
+	CPPUNIT_ASSERT_EQUAL(8.0, positions[1].latitude);
+	CPPUNIT_ASSERT_EQUAL(10.0, positions[1].elevation);
+}
+
+void LatLonTest::testConversions() {
+	GlobalCoordinates coordinates(38.88922, -77.04978);
+	LatLon latLon = LatLon::fromGlobalCoordinates(coordinates);
+	CPPUNIT_ASSERT_EQUAL(coordinates.getLatitude(), latLon.latitude);
+	CPPUNIT_ASSERT_EQUAL(coordinates.getLongitude(), latLon.longitude);
+	CPPUNIT_ASSERT(coordinates == latLon.toGlobalCoordinates());
+
+	GlobalPosition position(48.85889, 2.29583, 300);
+	LatLonAlt latLonAlt = LatLonAlt::fromGlobalPosition(position);
+	CPPUNIT_ASSERT_EQUAL(300.0, latLonAlt.elevation);
+	CPPUNIT_ASSERT(position == latLonAlt.toGlobalPosition());
+	CPPUNIT_ASSERT(GlobalCoordinates(48.85889, 2.29583) == latLonAlt.getLatLon().toGlobalCoordinates());
+
+	// converting to the classes canonicalizes
+	LatLon outside = { 100, 190 };
+	GlobalCoordinates canonical = outside.toGlobalCoordinates();
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(80.0, canonical.getLatitude(), 1E-12);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(10.0, canonical.getLongitude(), 1E-12);
+}
+
+void LatLonTest::testCanonicalize() {
+	LatLon latLon = { 100, 190 };
+	latLon.canonicalize();
+	GlobalCoordinates expected(100, 190);
+	CPPUNIT_ASSERT_EQUAL(expected.getLatitude(), latLon.latitude);
+	CPPUNIT_ASSERT_EQUAL(expected.getLongitude(), latLon.longitude);
+
+	LatLonAlt latLonAlt = { -95, -185, 12 };
+	latLonAlt.canonicalize();
+	GlobalPosition position(-95, -185, 12);
+	CPPUNIT_ASSERT_EQUAL(position.getLatitude(), latLonAlt.latitude);
+	CPPUNIT_ASSERT_EQUAL(position.getLongitude(), latLonAlt.longitude);
+	CPPUNIT_ASSERT_EQUAL(12.0, latLonAlt.elevation);
+}
@@ -0,0 +1,27 @@
+#ifndef GEODESY_LAT_LON_TEST_HPP
+#define GEODESY_LAT_LON_TEST_HPP
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <LatLon.hpp>
+
+class LatLonTest: public CppUnit::TestFixture {
+
+CPPUNIT_TEST_SUITE( LatLonTest);
+
+		// list all test methods here
+		CPPUNIT_TEST(testLayout);
+		CPPUNIT_TEST(testConversions);
+		CPPUNIT_TEST(testCanonicalize);
+
+	CPPUNIT_TEST_SUITE_END();
+
+protected:
+	void testLayout();
+	void testConversions();
+	void testCanonicalize();
+
+};
+
+#endif // GEODESY_LAT_LON_TEST_HPP
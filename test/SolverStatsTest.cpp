@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#include "SolverStatsTest.hpp"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <BatchExecutor.hpp>
+#include <GeodeticCalculator.hpp>
+#include <GeodeticCalculatorT.hpp>
+#include <SolverStats.hpp>
+#include <cstring>
+
+using namespace geodesy;
+using namespace std;
+using namespace std::tr1;
+CPPUNIT_TEST_SUITE_REGISTRATION( SolverStatsTest );
+
+namespace {
+
+/**
+ * Solves one inverse problem per item on the worker threads.
+ */
+class InverseTask: public BatchExecutor::Task {
+public:
+	virtual void run(size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			GeodeticCalculator::calculateGeodeticCurve(*Ellipsoid::WGS84(),
+					GlobalCoordinates(0, 0), GlobalCoordinates(10, i % 90));
+		}
+	}
+};
+
+}
+
+void SolverStatsTest::testCounts() {
+	const Ellipsoid &reference = *Ellipsoid::WGS84();
+	SolverStats::reset();
+
+	GlobalCoordinates lincolnMemorial(38.88922, -77.04978);
+	GlobalCoordinates eiffelTower(48.85889, 2.29583);
+	GeodeticCalculator::calculateGeodeticCurve(reference, lincolnMemorial,
+			eiffelTower);
+	GeodeticCalculator::calculateGeodeticCurve(reference, lincolnMemorial,
+			eiffelTower, GeodeticCalculator::Karney);
+	// nearly antipodal, Vincenty's method falls back to due north
+	GeodeticCalculator::calculateGeodeticCurve(reference,
+			GlobalCoordinates(0, 0), GlobalCoordinates(0.5, 179.7));
+	GeodeticCalculator::calculateEndingGlobalCoordinates(reference,
+			lincolnMemorial, 51.76792142, 6179016.136);
+	GeodeticCalculator::calculateEndingGlobalCoordinates(reference,
+			lincolnMemorial, 1.0, 6179016.13586);
+
+	SolverStatsSnapshot snapshot = SolverStats::getSnapshot();
+	if (!SolverStats::isEnabled()) {
+		SolverStatsSnapshot zero;
+		memset(&zero, 0, sizeof(zero));
+		CPPUNIT_ASSERT(memcmp(&zero, &snapshot, sizeof(zero)) == 0);
+		return;
+	}
+
+	CPPUNIT_ASSERT_EQUAL(3ULL, snapshot.inverse.solves);
+	CPPUNIT_ASSERT_EQUAL(1ULL, snapshot.inverse.notConverged);
+	CPPUNIT_ASSERT_EQUAL(1ULL, snapshot.inverse.antipodalFallbacks);
+	CPPUNIT_ASSERT_EQUAL(20ULL, snapshot.inverse.maxIterations);
+	CPPUNIT_ASSERT(snapshot.inverse.iterations > 20);
+	CPPUNIT_ASSERT_EQUAL(3ULL, snapshot.inverse.timedCalls);
+	CPPUNIT_ASSERT(snapshot.inverse.totalNanoseconds > 0);
+
+	CPPUNIT_ASSERT_EQUAL(2ULL, snapshot.direct.solves);
+	CPPUNIT_ASSERT_EQUAL(0ULL, snapshot.direct.notConverged);
+	CPPUNIT_ASSERT_EQUAL(0ULL, snapshot.direct.antipodalFallbacks);
+	CPPUNIT_ASSERT(snapshot.direct.iterations >= 2);
+	CPPUNIT_ASSERT_EQUAL(2ULL, snapshot.direct.timedCalls);
+
+	unsigned long long timed = 0;
+	for (size_t i = 0; i < SolverCounters::LatencyBuckets; ++i) {
+		timed += snapshot.inverse.latency[i];
+	}
+	CPPUNIT_ASSERT_EQUAL(3ULL, timed);
+
+	// everything happened on this thread
+	SolverStatsSnapshot thread = SolverStats::getThreadSnapshot();
+	CPPUNIT_ASSERT(memcmp(&thread, &snapshot, sizeof(thread)) == 0);
+
+	SolverStats::reset();
+	snapshot = SolverStats::getSnapshot();
+	CPPUNIT_ASSERT_EQUAL(0ULL, snapshot.inverse.solves);
+	CPPUNIT_ASSERT_EQUAL(0ULL, snapshot.direct.timedCalls);
+}
+
+void SolverStatsTest::testThreads() {
+	SolverStats::reset();
+
+	{
+		BatchExecutor executor(3);
+		InverseTask task;
+		executor.run(task, 1000, 10);
+
+		if (SolverStats::isEnabled()) {
+			CPPUNIT_ASSERT_EQUAL(1000ULL, SolverStats::getSnapshot().inverse.solves);
+			CPPUNIT_ASSERT_EQUAL(0ULL, SolverStats::getThreadSnapshot().inverse.solves);
+		}
+	}
+
+	// the counts of exited threads are kept
+	SolverStatsSnapshot snapshot = SolverStats::getSnapshot();
+	CPPUNIT_ASSERT_EQUAL(SolverStats::isEnabled() ? 1000ULL : 0ULL, snapshot.inverse.solves);
+	CPPUNIT_ASSERT_EQUAL(SolverStats::isEnabled() ? 1000ULL : 0ULL, snapshot.inverse.timedCalls);
+}
+
+void SolverStatsTest::testTaggedCalculator() {
+	SolverStats::reset();
+	// timed by the library, whatever this file was compiled with
+	GeodeticCalculatorT<WGS84Tag>::calculateGeodeticCurve(
+			GlobalCoordinates(38.88922, -77.04978),
+			GlobalCoordinates(48.85889, 2.29583));
+	SolverStatsSnapshot snapshot = SolverStats::getSnapshot();
+	CPPUNIT_ASSERT_EQUAL(SolverStats::isEnabled() ? 1ULL : 0ULL, snapshot.inverse.solves);
+	CPPUNIT_ASSERT_EQUAL(SolverStats::isEnabled() ? 1ULL : 0ULL, snapshot.inverse.timedCalls);
+	SolverStats::reset();
+}
+
+void SolverStatsTest::testLatencyPercentile() {
+	SolverCounters counters;
+	memset(&counters, 0, sizeof(counters));
+	CPPUNIT_ASSERT_EQUAL(0ULL, counters.getLatencyPercentile(0.99));
+
+	// 98 calls in [1024, 2048) and 2 in [65536, 131072) nanoseconds
+	counters.timedCalls = 100;
+	counters.latency[10] = 98;
+	counters.latency[16] = 2;
+	CPPUNIT_ASSERT_EQUAL(2048ULL, counters.getLatencyPercentile(0.5));
+	CPPUNIT_ASSERT_EQUAL(2048ULL, counters.getLatencyPercentile(0.97));
+	CPPUNIT_ASSERT_EQUAL(131072ULL, counters.getLatencyPercentile(0.99));
+}
@@ -0,0 +1,29 @@
+#ifndef GEODESY_SOLVER_STATS_TEST_HPP
+#define GEODESY_SOLVER_STATS_TEST_HPP
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <SolverStats.hpp>
+
+class SolverStatsTest: public CppUnit::TestFixture {
+
+CPPUNIT_TEST_SUITE( SolverStatsTest);
+
+		// list all test methods here
+		CPPUNIT_TEST(testCounts);
+		CPPUNIT_TEST(testThreads);
+		CPPUNIT_TEST(testTaggedCalculator);
+		CPPUNIT_TEST(testLatencyPercentile);
+
+	CPPUNIT_TEST_SUITE_END();
+
+protected:
+	void testCounts();
+	void testThreads();
+	void testTaggedCalculator();
+	void testLatencyPercentile();
+
+};
+
+#endif // GEODESY_SOLVER_STATS_TEST_HPP
@@ -0,0 +1,280 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#include "SpatialIndexTest.hpp"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <SpatialIndex.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <unistd.h>
+
+using namespace geodesy;
+using namespace std;
+using namespace std::tr1;
+CPPUNIT_TEST_SUITE_REGISTRATION( SpatialIndexTest );
+
+namespace {
+
+/**
+ * Points clustered around a few cities plus some spread over the globe,
+ * including the poles and both sides of the antimeridian.
+ */
+vector<GlobalCoordinates> makePoints() {
+	vector<GlobalCoordinates> points;
+	const double centers[][2] = { { 38.9, -77.0 }, { 48.9, 2.3 },
+			{ -33.9, 151.2 }, { 64.1, -179.9 }, { 89.9, 0 } };
+	unsigned seed = 7;
+	for (int i = 0; i < 1500; ++i) {
+		seed = seed * 1103515245 + 12345;
+		double u = (seed >> 8) / 16777216.0;
+		seed = seed * 1103515245 + 12345;
+		double v = (seed >> 8) / 16777216.0;
+		if (i % 3 == 0) {
+			points.push_back(
+					GlobalCoordinates(asin(2 * u - 1) * 180 / M_PI,
+							360 * v - 180));
+		} else {
+			const double *center = centers[i % 5];
+			points.push_back(
+					GlobalCoordinates(center[0] + 2 * u - 1,
+							center[1] + 2 * v - 1));
+		}
+	}
+	return points;
+}
+
+vector<double> bruteForce(const Ellipsoid &ellipsoid,
+		const vector<GlobalCoordinates> &points,
+		const GlobalCoordinates &target,
+		GeodeticCalculator::InverseMethod method = GeodeticCalculator::Vincenty) {
+	vector<double> distances;
+	for (size_t i = 0; i < points.size(); ++i) {
+		distances.push_back(
+				GeodeticCalculator::calculateGeodeticCurve(ellipsoid, target,
+						points[i], method).ellipsoidalDistance);
+	}
+	return distances;
+}
+
+}
+
+void SpatialIndexTest::testFindNearest() {
+	shared_ptr<const Ellipsoid> reference = Ellipsoid::WGS84();
+	vector<GlobalCoordinates> points = makePoints();
+	SpatialIndex index(reference, points, 8);
+	CPPUNIT_ASSERT_EQUAL(points.size(), index.getCount());
+
+	const GlobalCoordinates targets[] = { GlobalCoordinates(38.88922,
+			-77.04978), GlobalCoordinates(48.85889, 2.29583),
+			GlobalCoordinates(64, 179.9), GlobalCoordinates(-90, 0),
+			GlobalCoordinates(0, 0) };
+	for (size_t t = 0; t < sizeof(targets) / sizeof(targets[0]); ++t) {
+		vector<double> expected = bruteForce(*reference, points, targets[t]);
+		vector<double> sorted(expected);
+		sort(sorted.begin(), sorted.end());
+
+		const size_t counts[] = { 1, 5, 40 };
+		for (size_t c = 0; c < 3; ++c) {
+			vector<SpatialIndex::Neighbor> nearest = index.findNearest(
+					targets[t], counts[c]);
+			CPPUNIT_ASSERT_EQUAL(counts[c], nearest.size());
+			for (size_t i = 0; i < nearest.size(); ++i) {
+				CPPUNIT_ASSERT_EQUAL(sorted[i], nearest[i].ellipsoidalDistance);
+				CPPUNIT_ASSERT_EQUAL(expected[nearest[i].index],
+						nearest[i].ellipsoidalDistance);
+			}
+		}
+	}
+}
+
+void SpatialIndexTest::testFindWithinRadius() {
+	shared_ptr<const Ellipsoid> reference = Ellipsoid::WGS84();
+	vector<GlobalCoordinates> points = makePoints();
+	vector<double> latitudes, longitudes;
+	for (size_t i = 0; i < points.size(); ++i) {
+		latitudes.push_back(points[i].getLatitude());
+		longitudes.push_back(points[i].getLongitude());
+	}
+	SpatialIndex index(reference, points.size(), &latitudes[0],
+			&longitudes[0]);
+
+	GlobalCoordinates target(64, 179.9);
+	vector<double> expected = bruteForce(*reference, points, target);
+	const double radii[] = { 0, 1000, 50000, 150000, 3000000 };
+	for (size_t r = 0; r < 5; ++r) {
+		vector<SpatialIndex::Neighbor> found = index.findWithinRadius(target,
+				radii[r], GeodeticCalculator::Karney);
+		size_t count = 0;
+		for (size_t i = 0; i < expected.size(); ++i) {
+			if (expected[i] <= radii[r] - 0.001) {
+				++count;
+			}
+		}
+		CPPUNIT_ASSERT(found.size() >= count);
+		for (size_t i = 0; i < found.size(); ++i) {
+			CPPUNIT_ASSERT(found[i].ellipsoidalDistance <= radii[r]);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(expected[found[i].index],
+					found[i].ellipsoidalDistance, 0.001);
+			if (i > 0) {
+				CPPUNIT_ASSERT(found[i - 1].ellipsoidalDistance <= found[i].ellipsoidalDistance);
+			}
+		}
+	}
+}
+
+void SpatialIndexTest::testEveryMethod() {
+	// the approximate methods can be shorter than the chord, most of all
+	// the haversine near the equator, where the mean sphere is smaller than
+	// the ellipsoid
+	shared_ptr<const Ellipsoid> reference = Ellipsoid::WGS84();
+	vector<GlobalCoordinates> points = makePoints();
+	unsigned seed = 11;
+	for (int i = 0; i < 3000; ++i) {
+		seed = seed * 1103515245 + 12345;
+		double u = (seed >> 8) / 16777216.0;
+		seed = seed * 1103515245 + 12345;
+		double v = (seed >> 8) / 16777216.0;
+		points.push_back(GlobalCoordinates(6 * u - 3, 20 * v - 10));
+	}
+	SpatialIndex index(reference, points);
+
+	const GlobalCoordinates targets[] = { GlobalCoordinates(0, 0),
+			GlobalCoordinates(1.5, -4), GlobalCoordinates(-2, 8),
+			GlobalCoordinates(48.85889, 2.29583), GlobalCoordinates(89, 30) };
+	const GeodeticCalculator::InverseMethod methods[] = {
+			GeodeticCalculator::Vincenty, GeodeticCalculator::Karney,
+			GeodeticCalculator::AndoyerLambert, GeodeticCalculator::Haversine };
+	for (size_t m = 0; m < 4; ++m) {
+		for (size_t t = 0; t < sizeof(targets) / sizeof(targets[0]); ++t) {
+			vector<double> expected = bruteForce(*reference, points,
+					targets[t], methods[m]);
+			vector<double> sorted(expected);
+			sort(sorted.begin(), sorted.end());
+
+			vector<SpatialIndex::Neighbor> nearest = index.findNearest(
+					targets[t], 50, methods[m]);
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(50), nearest.size());
+			for (size_t i = 0; i < nearest.size(); ++i) {
+				CPPUNIT_ASSERT_EQUAL(sorted[i], nearest[i].ellipsoidalDistance);
+			}
+
+			const double radii[] = { 20000, 100000, 400000 };
+			for (size_t r = 0; r < 3; ++r) {
+				vector<SpatialIndex::Neighbor> found = index.findWithinRadius(
+						targets[t], radii[r], methods[m]);
+				size_t count = upper_bound(sorted.begin(), sorted.end(),
+						radii[r]) - sorted.begin();
+				CPPUNIT_ASSERT_EQUAL(count, found.size());
+				for (size_t i = 0; i < found.size(); ++i) {
+					CPPUNIT_ASSERT_EQUAL(expected[found[i].index],
+							found[i].ellipsoidalDistance);
+				}
+			}
+		}
+	}
+}
+
+void SpatialIndexTest::testSpecialCases() {
+	shared_ptr<const Ellipsoid> reference = Ellipsoid::WGS84();
+	GlobalCoordinates target(10, 20);
+
+	// empty
+	SpatialIndex empty(reference, vector<GlobalCoordinates>());
+	CPPUNIT_ASSERT(empty.findNearest(target, 3).empty());
+	CPPUNIT_ASSERT(empty.findWithinRadius(target, 1E7).empty());
+
+	// fewer points than asked for, duplicates, the target itself
+	vector<GlobalCoordinates> points;
+	points.push_back(GlobalCoordinates(10, 20));
+	points.push_back(GlobalCoordinates(10, 20));
+	points.push_back(GlobalCoordinates(-10, -160));
+	SpatialIndex index(reference, points, 1);
+	vector<SpatialIndex::Neighbor> nearest = index.findNearest(target, 5);
+	CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), nearest.size());
+	CPPUNIT_ASSERT_EQUAL(0.0, nearest[0].ellipsoidalDistance);
+	CPPUNIT_ASSERT_EQUAL(0.0, nearest[1].ellipsoidalDistance);
+	CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), nearest[2].index);
+	CPPUNIT_ASSERT(index.findNearest(target, 0).empty());
+
+	vector<SpatialIndex::Neighbor> found = index.findWithinRadius(target, 0);
+	CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), found.size());
+	CPPUNIT_ASSERT(index.findWithinRadius(target, -1).empty());
+}
+
+void SpatialIndexTest::testSaveAndOpen() {
+	shared_ptr<const Ellipsoid> reference = Ellipsoid::WGS84();
+	vector<GlobalCoordinates> points = makePoints();
+	SpatialIndex built(reference, points);
+	CPPUNIT_ASSERT(!built.isMapped());
+
+	char path[] = "/tmp/SpatialIndexTestXXXXXX";
+	int fd = mkstemp(path);
+	CPPUNIT_ASSERT(fd >= 0);
+	close(fd);
+	built.save(path);
+
+	SpatialIndex::Ptr mapped = SpatialIndex::open(path);
+	CPPUNIT_ASSERT(mapped->isMapped());
+	CPPUNIT_ASSERT_EQUAL(built.getCount(), mapped->getCount());
+	CPPUNIT_ASSERT_EQUAL(reference->getSemiMajorAxis(), mapped->getEllipsoid()->getSemiMajorAxis());
+	CPPUNIT_ASSERT_EQUAL(reference->getFlattening(), mapped->getEllipsoid()->getFlattening());
+
+	GlobalCoordinates target(48.85889, 2.29583);
+	vector<SpatialIndex::Neighbor> expected = built.findNearest(target, 25);
+	vector<SpatialIndex::Neighbor> actual = mapped->findNearest(target, 25);
+	CPPUNIT_ASSERT_EQUAL(expected.size(), actual.size());
+	for (size_t i = 0; i < expected.size(); ++i) {
+		CPPUNIT_ASSERT_EQUAL(expected[i].index, actual[i].index);
+		CPPUNIT_ASSERT_EQUAL(expected[i].ellipsoidalDistance, actual[i].ellipsoidalDistance);
+	}
+	CPPUNIT_ASSERT_EQUAL(built.findWithinRadius(target, 100000).size(),
+			mapped->findWithinRadius(target, 100000).size());
+
+	// saving a mapped index gives the same file back
+	string copy = string(path) + ".copy";
+	mapped->save(copy);
+	CPPUNIT_ASSERT_EQUAL(points.size(), SpatialIndex::open(copy)->getCount());
+	remove(copy.c_str());
+
+	// a truncated file is rejected
+	CPPUNIT_ASSERT_EQUAL(0, truncate(path, 100));
+	CPPUNIT_ASSERT_THROW(SpatialIndex::open(path), SpatialIndexFileException);
+	// so is something else
+	{
+		ofstream other(path);
+		other << "definitely not an index, but long enough for a header ..........";
+	}
+	CPPUNIT_ASSERT_THROW(SpatialIndex::open(path), SpatialIndexFileException);
+	remove(path);
+	CPPUNIT_ASSERT_THROW(SpatialIndex::open(path), SpatialIndexFileException);
+}
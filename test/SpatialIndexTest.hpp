@@ -0,0 +1,31 @@
+#ifndef GEODESY_SPATIAL_INDEX_TEST_HPP
+#define GEODESY_SPATIAL_INDEX_TEST_HPP
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <SpatialIndex.hpp>
+
+class SpatialIndexTest: public CppUnit::TestFixture {
+
+CPPUNIT_TEST_SUITE( SpatialIndexTest);
+
+		// list all test methods here
+		CPPUNIT_TEST(testFindNearest);
+		CPPUNIT_TEST(testFindWithinRadius);
+		CPPUNIT_TEST(testEveryMethod);
+		CPPUNIT_TEST(testSpecialCases);
+		CPPUNIT_TEST(testSaveAndOpen);
+
+	CPPUNIT_TEST_SUITE_END();
+
+protected:
+	void testFindNearest();
+	void testFindWithinRadius();
+	void testEveryMethod();
+	void testSpecialCases();
+	void testSaveAndOpen();
+
+};
+
+#endif // GEODESY_SPATIAL_INDEX_TEST_HPP
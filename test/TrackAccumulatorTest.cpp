@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+#include "TrackAccumulatorTest.hpp"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <GeodeticCalculator.hpp>
+#include <TrackAccumulator.hpp>
+#include <cmath>
+#include <vector>
+
+using namespace geodesy;
+using namespace std;
+CPPUNIT_TEST_SUITE_REGISTRATION( TrackAccumulatorTest );
+
+namespace {
+
+/**
+ * A short flight out of Denver: a climb with a repeated fix, a descent and a
+ * climb again.
+ */
+vector<GlobalPosition> flight() {
+	vector<GlobalPosition> positions;
+	positions.push_back(GlobalPosition(39.8561, -104.6737, 1655.0));
+	positions.push_back(GlobalPosition(39.8712, -104.6402, 1890.5));
+	positions.push_back(GlobalPosition(39.8712, -104.6402, 1890.5));
+	positions.push_back(GlobalPosition(39.9254, -104.5121, 2740.0));
+	positions.push_back(GlobalPosition(40.0150, -104.3310, 2512.25));
+	positions.push_back(GlobalPosition(40.1302, -104.0457, 3100.0));
+	return positions;
+}
+
+}
+
+void TrackAccumulatorTest::testEmptyTrack() {
+	TrackAccumulator track(Ellipsoid::WGS84());
+	CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), track.getPositionCount());
+	CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), track.getSegmentCount());
+	CPPUNIT_ASSERT_EQUAL(0.0, track.getEllipsoidalLength());
+	CPPUNIT_ASSERT_EQUAL(0.0, track.getPointToPointLength());
+	CPPUNIT_ASSERT(isnan(track.getInitialBearing()));
+	CPPUNIT_ASSERT(isnan(track.getLastSegment().ellipsoidalDistance));
+
+	// a single fix has no length
+	track.add(GlobalPosition(39.8561, -104.6737, 1655.0));
+	CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), track.getPositionCount());
+	CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), track.getSegmentCount());
+	CPPUNIT_ASSERT_EQUAL(0.0, track.getPointToPointLength());
+	CPPUNIT_ASSERT_EQUAL(0.0, track.getLastSegment().ellipsoidalDistance);
+	CPPUNIT_ASSERT(isnan(track.getLastSegment().azimuth));
+	CPPUNIT_ASSERT(isnan(track.getInitialBearing()));
+}
+
+void TrackAccumulatorTest::testMatchesMeasurements() {
+	Ellipsoid::ConstPtr reference = Ellipsoid::WGS84();
+	vector<GlobalPosition> positions = flight();
+
+	TrackAccumulator track(reference);
+	double ellipsoidalLength = 0;
+	double pointToPointLength = 0;
+	double climb = 0;
+	double descent = 0;
+	track.add(positions[0]);
+	for (size_t i = 1; i < positions.size(); ++i) {
+		track.add(positions[i]);
+
+		// bit for bit the measurement of the segment on its own
+		GeodeticMeasurementValue expected =
+				GeodeticCalculator::calculateGeodeticMeasurement(*reference,
+						positions[i - 1], positions[i]);
+		const GeodeticMeasurementValue &segment = track.getLastSegment();
+		CPPUNIT_ASSERT_EQUAL(expected.ellipsoidalDistance,
+				segment.ellipsoidalDistance);
+		CPPUNIT_ASSERT_EQUAL(expected.pointToPointDistance,
+				segment.pointToPointDistance);
+		CPPUNIT_ASSERT_EQUAL(expected.elevationChange, segment.elevationChange);
+		if (!isnan(expected.azimuth)) {
+			CPPUNIT_ASSERT_EQUAL(expected.azimuth, segment.azimuth);
+			CPPUNIT_ASSERT_EQUAL(expected.reverseAzimuth,
+					segment.reverseAzimuth);
+		}
+
+		ellipsoidalLength += expected.ellipsoidalDistance;
+		pointToPointLength += expected.pointToPointDistance;
+		if (expected.elevationChange > 0) {
+			climb += expected.elevationChange;
+		} else {
+			descent -= expected.elevationChange;
+		}
+	}
+
+	CPPUNIT_ASSERT_EQUAL(positions.size(), track.getPositionCount());
+	CPPUNIT_ASSERT_EQUAL(positions.size() - 1, track.getSegmentCount());
+	CPPUNIT_ASSERT_EQUAL(ellipsoidalLength, track.getEllipsoidalLength());
+	CPPUNIT_ASSERT_EQUAL(pointToPointLength, track.getPointToPointLength());
+	CPPUNIT_ASSERT(track.getPointToPointLength() > track.getEllipsoidalLength());
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(1672.75, track.getClimb(), 1E-9);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(227.75, track.getDescent(), 1E-9);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(climb, track.getClimb(), 0.0);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(descent, track.getDescent(), 0.0);
+	CPPUNIT_ASSERT_EQUAL(
+			GeodeticCalculator::calculateGeodeticMeasurement(*reference,
+					positions[0], positions[1]).azimuth,
+			track.getInitialBearing());
+
+	track.reset();
+	CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), track.getPositionCount());
+	CPPUNIT_ASSERT_EQUAL(0.0, track.getEllipsoidalLength());
+	CPPUNIT_ASSERT_EQUAL(0.0, track.getClimb());
+	CPPUNIT_ASSERT(isnan(track.getInitialBearing()));
+}
+
+void TrackAccumulatorTest::testBlocks() {
+	Ellipsoid::ConstPtr reference = Ellipsoid::WGS84();
+	vector<GlobalPosition> positions = flight();
+
+	TrackAccumulator single(reference);
+	for (size_t i = 0; i < positions.size(); ++i) {
+		single.add(positions[i]);
+	}
+
+	// two blocks, the second one continuing the track of the first
+	TrackAccumulator blocks(reference);
+	vector<GeodeticMeasurementValue> segments(positions.size());
+	blocks.add(2, &positions[0], &segments[0]);
+	blocks.add(positions.size() - 2, &positions[2], &segments[2]);
+	blocks.add(0, 0);
+
+	CPPUNIT_ASSERT_EQUAL(single.getPositionCount(), blocks.getPositionCount());
+	CPPUNIT_ASSERT_EQUAL(single.getEllipsoidalLength(),
+			blocks.getEllipsoidalLength());
+	CPPUNIT_ASSERT_EQUAL(single.getPointToPointLength(),
+			blocks.getPointToPointLength());
+	CPPUNIT_ASSERT_EQUAL(single.getClimb(), blocks.getClimb());
+	CPPUNIT_ASSERT_EQUAL(single.getDescent(), blocks.getDescent());
+
+	// the first fix ends no segment, the repeated one a segment of no length
+	CPPUNIT_ASSERT_EQUAL(0.0, segments[0].pointToPointDistance);
+	CPPUNIT_ASSERT(isnan(segments[0].azimuth));
+	CPPUNIT_ASSERT_EQUAL(0.0, segments[2].pointToPointDistance);
+	for (size_t i = 1; i < positions.size(); ++i) {
+		GeodeticMeasurementValue expected =
+				GeodeticCalculator::calculateGeodeticMeasurement(*reference,
+						positions[i - 1], positions[i]);
+		CPPUNIT_ASSERT_EQUAL(expected.pointToPointDistance,
+				segments[i].pointToPointDistance);
+	}
+	CPPUNIT_ASSERT_EQUAL(segments.back().azimuth,
+			blocks.getLastSegment().azimuth);
+}
@@ -0,0 +1,27 @@
+#ifndef GEODESY_TRACK_ACCUMULATOR_TEST_HPP
+#define GEODESY_TRACK_ACCUMULATOR_TEST_HPP
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <TrackAccumulator.hpp>
+
+class TrackAccumulatorTest: public CppUnit::TestFixture {
+
+CPPUNIT_TEST_SUITE( TrackAccumulatorTest);
+
+		// list all test methods here
+		CPPUNIT_TEST(testEmptyTrack);
+		CPPUNIT_TEST(testMatchesMeasurements);
+		CPPUNIT_TEST(testBlocks);
+
+	CPPUNIT_TEST_SUITE_END();
+
+protected:
+	void testEmptyTrack();
+	void testMatchesMeasurements();
+	void testBlocks();
+
+};
+
+#endif // GEODESY_TRACK_ACCUMULATOR_TEST_HPP
@@ -0,0 +1,560 @@
+/*
+ * Copyright (c) 2011
+ *      Jon Schewe.  All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * I'd appreciate comments/suggestions on the code jpschewe@mtu.net
+ */
+
+/*
+ * Runs the batch solvers over binary record files. The input file is mapped
+ * into memory and the results are written straight into the mapped output
+ * file, so nothing is parsed or formatted per record and files larger than
+ * memory are paged through.
+ *
+ * Both files are flat arrays of doubles in the byte order of the machine,
+ * without a header:
+ *
+ *   inverse  in:  start latitude, start longitude, end latitude,
+ *                 end longitude (two LatLon)
+ *            out: ellipsoidal distance, azimuth, reverse azimuth
+ *   direct   in:  start latitude, start longitude, start bearing, distance
+ *            out: end latitude, end longitude, end bearing
+ *
+ * Angles are in degrees and distances in meters. A NaN start bearing gives a
+ * NaN result rather than failing the job. The results are written to
+ * OUTPUT.tmp, flushed to disk and renamed to OUTPUT when they are complete;
+ * OUTPUT may not be the input file.
+ *
+ * Usage: geoBatch inverse|direct INPUT OUTPUT [--threads N]
+ *                 [--method vincenty|karney|andoyer_lambert|haversine]
+ *                 [--ellipsoid NAME]
+ */
+
+#include <BatchExecutor.hpp>
+#include <FileUtil.hpp>
+#include <GeodeticCalculator.hpp>
+#include <LatLon.hpp>
+
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace geodesy;
+using namespace std;
+
+namespace {
+
+/** A record of the input file of the inverse problem. */
+struct InverseRecord {
+	LatLon start;
+	LatLon end;
+};
+
+/** A record of the output file of the inverse problem. */
+struct InverseResult {
+	double ellipsoidalDistance;
+	double azimuth;
+	double reverseAzimuth;
+};
+
+/** A record of the input file of the direct problem. */
+struct DirectRecord {
+	LatLon start;
+	double startBearing;
+	double distance;
+};
+
+/** A record of the output file of the direct problem. */
+struct DirectResult {
+	LatLon end;
+	double endBearing;
+};
+
+/**
+ * Records are moved between the mapped files and the column arrays of the
+ * batch methods this many at a time, small enough for the stacks of the
+ * worker threads and the first level cache.
+ */
+const size_t BlockSize = 256;
+
+/**
+ * The most worker threads --threads accepts.
+ */
+const unsigned long MaxThreads = 1024;
+
+/**
+ * Solves the inverse problem for a range of mapped records.
+ */
+class InverseTask: public BatchExecutor::Task {
+public:
+	InverseTask(const Ellipsoid &ellipsoid,
+			GeodeticCalculator::InverseMethod method,
+			const InverseRecord *records, InverseResult *results) :
+			mEllipsoid(ellipsoid), mMethod(method), mRecords(records), mResults(
+					results) {
+	}
+
+	virtual void run(size_t begin, size_t end) {
+		double lat1[BlockSize];
+		double lon1[BlockSize];
+		double lat2[BlockSize];
+		double lon2[BlockSize];
+		double s[BlockSize];
+		double alpha1[BlockSize];
+		double alpha2[BlockSize];
+
+		for (size_t offset = begin; offset < end; offset += BlockSize) {
+			size_t n = min(BlockSize, end - offset);
+			const InverseRecord *records = mRecords + offset;
+			for (size_t i = 0; i < n; ++i) {
+				lat1[i] = records[i].start.latitude;
+				lon1[i] = records[i].start.longitude;
+				lat2[i] = records[i].end.latitude;
+				lon2[i] = records[i].end.longitude;
+			}
+
+			GeodeticCalculator::calculateGeodeticCurves(mEllipsoid, n, lat1,
+					lon1, lat2, lon2, s, alpha1, alpha2, mMethod);
+
+			InverseResult *results = mResults + offset;
+			for (size_t i = 0; i < n; ++i) {
+				results[i].ellipsoidalDistance = s[i];
+				results[i].azimuth = alpha1[i];
+				results[i].reverseAzimuth = alpha2[i];
+			}
+		}
+	}
+
+private:
+	const Ellipsoid &mEllipsoid;
+	GeodeticCalculator::InverseMethod mMethod;
+	const InverseRecord *mRecords;
+	InverseResult *mResults;
+};
+
+/**
+ * Solves the direct problem for a range of mapped records.
+ */
+class DirectTask: public BatchExecutor::Task {
+public:
+	DirectTask(const Ellipsoid &ellipsoid, const DirectRecord *records,
+			DirectResult *results) :
+			mEllipsoid(ellipsoid), mRecords(records), mResults(results) {
+	}
+
+	virtual void run(size_t begin, size_t end) {
+		double lat1[BlockSize];
+		double lon1[BlockSize];
+		double alpha1[BlockSize];
+		double s[BlockSize];
+		double lat2[BlockSize];
+		double lon2[BlockSize];
+		double alpha2[BlockSize];
+		bool invalid[BlockSize];
+
+		for (size_t offset = begin; offset < end; offset += BlockSize) {
+			size_t n = min(BlockSize, end - offset);
+			const DirectRecord *records = mRecords + offset;
+			for (size_t i = 0; i < n; ++i) {
+				lat1[i] = records[i].start.latitude;
+				lon1[i] = records[i].start.longitude;
+				alpha1[i] = records[i].startBearing;
+				s[i] = records[i].distance;
+				// the batch method throws on these, run() must not
+				invalid[i] = isnan(alpha1[i]);
+				if (invalid[i]) {
+					alpha1[i] = 0;
+				}
+			}
+
+			GeodeticCalculator::calculateEndingGlobalCoordinates(mEllipsoid, n,
+					lat1, lon1, alpha1, s, lat2, lon2, alpha2);
+
+			DirectResult *results = mResults + offset;
+			for (size_t i = 0; i < n; ++i) {
+				if (invalid[i]) {
+					lat2[i] = lon2[i] = alpha2[i] =
+							numeric_limits<double>::quiet_NaN();
+				}
+				results[i].end.latitude = lat2[i];
+				results[i].end.longitude = lon2[i];
+				results[i].endBearing = alpha2[i];
+			}
+		}
+	}
+
+private:
+	const Ellipsoid &mEllipsoid;
+	const DirectRecord *mRecords;
+	DirectResult *mResults;
+};
+
+/**
+ * A file mapped into memory, unmapped and closed on destruction.
+ */
+class MappedFile {
+public:
+	MappedFile() :
+			mDescriptor(-1), mData(0), mSize(0) {
+	}
+
+	~MappedFile() {
+		if (mData) {
+			munmap(mData, mSize);
+		}
+		if (mDescriptor >= 0) {
+			close(mDescriptor);
+		}
+	}
+
+	/**
+	 * Map an existing file for reading.
+	 *
+	 * @return false with errno set if that failed
+	 */
+	bool openForReading(const string &path) {
+		mDescriptor = open(path.c_str(), O_RDONLY);
+		if (mDescriptor < 0) {
+			return false;
+		}
+		struct stat status;
+		if (fstat(mDescriptor, &status) != 0) {
+			return false;
+		}
+		mSize = status.st_size;
+		if (mSize == 0) {
+			return true;
+		}
+		void *data = mmap(0, mSize, PROT_READ, MAP_SHARED, mDescriptor, 0);
+		if (data == MAP_FAILED) {
+			return false;
+		}
+		mData = data;
+		madvise(mData, mSize, MADV_SEQUENTIAL);
+		return true;
+	}
+
+	/**
+	 * Create or truncate a file of the given size and map it for writing.
+	 * The space is allocated up front, so that a full disk is reported here
+	 * rather than as a SIGBUS while the results are written.
+	 *
+	 * @return false with errno set if that failed
+	 */
+	bool create(const string &path, size_t size) {
+		mDescriptor = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0666);
+		if (mDescriptor < 0) {
+			return false;
+		}
+		mSize = size;
+		if (mSize == 0) {
+			return true;
+		}
+		int error = posix_fallocate(mDescriptor, 0, mSize);
+		if (error != 0) {
+			errno = error;
+			return false;
+		}
+		void *data = mmap(0, mSize, PROT_READ | PROT_WRITE, MAP_SHARED,
+				mDescriptor, 0);
+		if (data == MAP_FAILED) {
+			return false;
+		}
+		mData = data;
+		madvise(mData, mSize, MADV_SEQUENTIAL);
+		return true;
+	}
+
+	/**
+	 * Flush what was written to the mapping to disk.
+	 *
+	 * @return false with errno set if that failed
+	 */
+	bool sync() {
+		if (mData && msync(mData, mSize, MS_SYNC) != 0) {
+			return false;
+		}
+		return fsync(mDescriptor) == 0;
+	}
+
+	/**
+	 * Tell if a path names the file that is mapped.
+	 *
+	 * @return false if it doesn't or doesn't exist
+	 */
+	bool isSameFile(const string &path) const {
+		struct stat mapped;
+		struct stat other;
+		if (fstat(mDescriptor, &mapped) != 0
+				|| stat(path.c_str(), &other) != 0) {
+			return false;
+		}
+		return mapped.st_dev == other.st_dev && mapped.st_ino == other.st_ino;
+	}
+
+	void *getData() const {
+		return mData;
+	}
+
+	size_t getSize() const {
+		return mSize;
+	}
+
+private:
+	int mDescriptor;
+	void *mData;
+	size_t mSize;
+
+	// no copies
+	MappedFile(const MappedFile &);
+	MappedFile &operator=(const MappedFile &);
+};
+
+struct Options {
+	bool direct;
+	string input;
+	string output;
+	unsigned threads;
+	GeodeticCalculator::InverseMethod method;
+	Ellipsoid::ConstPtr ellipsoid;
+};
+
+void usage() {
+	fprintf(stderr,
+			"usage: geoBatch inverse|direct INPUT OUTPUT [--threads N]\n"
+					"                [--method vincenty|karney|andoyer_lambert|"
+					"haversine]\n"
+					"                [--ellipsoid NAME]\n"
+					"  inverse    INPUT holds start latitude, start longitude, "
+					"end latitude,\n"
+					"             end longitude; OUTPUT gets distance, azimuth,"
+					" reverse azimuth\n"
+					"  direct     INPUT holds start latitude, start longitude, "
+					"start bearing,\n"
+					"             distance; OUTPUT gets end latitude, end "
+					"longitude, end bearing\n"
+					"  --threads  worker threads up to 1024, 0 for one per "
+					"processor (default 0)\n"
+					"  --method   algorithm of the inverse problem (default "
+					"vincenty)\n"
+					"  --ellipsoid wgs84, grs80, grs67, ans, wgs72, "
+					"clarke1858, clarke1880\n"
+					"             or sphere (default wgs84)\n"
+					"Records are native byte order doubles, degrees and "
+					"meters.\n");
+}
+
+bool parseMethod(const char *name, GeodeticCalculator::InverseMethod &method) {
+	if (strcmp(name, "vincenty") == 0) {
+		method = GeodeticCalculator::Vincenty;
+	} else if (strcmp(name, "karney") == 0) {
+		method = GeodeticCalculator::Karney;
+	} else if (strcmp(name, "andoyer_lambert") == 0) {
+		method = GeodeticCalculator::AndoyerLambert;
+	} else if (strcmp(name, "haversine") == 0) {
+		method = GeodeticCalculator::Haversine;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+bool parseEllipsoid(const char *name, Ellipsoid::ConstPtr &ellipsoid) {
+	if (strcmp(name, "wgs84") == 0) {
+		ellipsoid = Ellipsoid::WGS84();
+	} else if (strcmp(name, "grs80") == 0) {
+		ellipsoid = Ellipsoid::GRS80();
+	} else if (strcmp(name, "grs67") == 0) {
+		ellipsoid = Ellipsoid::GRS67();
+	} else if (strcmp(name, "ans") == 0) {
+		ellipsoid = Ellipsoid::ANS();
+	} else if (strcmp(name, "wgs72") == 0) {
+		ellipsoid = Ellipsoid::WGS72();
+	} else if (strcmp(name, "clarke1858") == 0) {
+		ellipsoid = Ellipsoid::Clarke1858();
+	} else if (strcmp(name, "clarke1880") == 0) {
+		ellipsoid = Ellipsoid::Clarke1880();
+	} else if (strcmp(name, "sphere") == 0) {
+		ellipsoid = Ellipsoid::Sphere();
+	} else {
+		return false;
+	}
+	return true;
+}
+
+bool parseThreads(const char *text, unsigned &threads) {
+	// strtoul takes a sign and white space, which aren't thread counts
+	if (!isdigit(static_cast<unsigned char>(*text))) {
+		return false;
+	}
+	char *end;
+	errno = 0;
+	unsigned long value = strtoul(text, &end, 10);
+	if (*end != 0 || errno == ERANGE || value > MaxThreads) {
+		return false;
+	}
+	threads = value;
+	return true;
+}
+
+bool parseOptions(int argc, char **argv, Options &options) {
+	if (argc < 4) {
+		return false;
+	}
+	if (strcmp(argv[1], "direct") == 0) {
+		options.direct = true;
+	} else if (strcmp(argv[1], "inverse") == 0) {
+		options.direct = false;
+	} else {
+		return false;
+	}
+	options.input = argv[2];
+	options.output = argv[3];
+	options.threads = 0;
+	options.method = GeodeticCalculator::Vincenty;
+	options.ellipsoid = Ellipsoid::WGS84();
+
+	for (int i = 4; i < argc; ++i) {
+		string option = argv[i];
+		if (i + 1 >= argc) {
+			return false;
+		}
+		const char *value = argv[++i];
+		if (option == "--threads") {
+			if (!parseThreads(value, options.threads)) {
+				return false;
+			}
+		} else if (option == "--method") {
+			if (!parseMethod(value, options.method)) {
+				return false;
+			}
+		} else if (option == "--ellipsoid") {
+			if (!parseEllipsoid(value, options.ellipsoid)) {
+				return false;
+			}
+		} else {
+			return false;
+		}
+	}
+	return true;
+}
+
+}
+
+int main(int argc, char **argv) {
+	Options options;
+	if (!parseOptions(argc, argv, options)) {
+		usage();
+		return 2;
+	}
+
+	size_t recordSize =
+			options.direct ? sizeof(DirectRecord) : sizeof(InverseRecord);
+	size_t resultSize =
+			options.direct ? sizeof(DirectResult) : sizeof(InverseResult);
+
+	MappedFile input;
+	if (!input.openForReading(options.input)) {
+		fprintf(stderr, "geoBatch: %s: %s\n", options.input.c_str(),
+				strerror(errno));
+		return 1;
+	}
+	if (input.getSize() % recordSize != 0) {
+		fprintf(stderr, "geoBatch: %s: size is not a multiple of %lu bytes\n",
+				options.input.c_str(), static_cast<unsigned long>(recordSize));
+		return 1;
+	}
+	size_t count = input.getSize() / recordSize;
+
+	// the results go to a temporary file renamed over OUTPUT once they are
+	// all written, so OUTPUT is never left half done, and neither file may be
+	// the input, which would be truncated while it is mapped
+	string temporary = options.output + ".tmp";
+	if (input.isSameFile(options.output) || input.isSameFile(temporary)) {
+		fprintf(stderr, "geoBatch: %s: same file as the input %s\n",
+				options.output.c_str(), options.input.c_str());
+		return 1;
+	}
+
+	try {
+		MappedFile output;
+		if (!output.create(temporary, count * resultSize)) {
+			fprintf(stderr, "geoBatch: %s: %s\n", temporary.c_str(),
+					strerror(errno));
+			unlink(temporary.c_str());
+			return 1;
+		}
+
+		if (count > 0) {
+			BatchExecutor executor(options.threads);
+			if (options.direct) {
+				DirectTask task(*options.ellipsoid,
+						static_cast<const DirectRecord *>(input.getData()),
+						static_cast<DirectResult *>(output.getData()));
+				executor.run(task, count);
+			} else {
+				InverseTask task(*options.ellipsoid, options.method,
+						static_cast<const InverseRecord *>(input.getData()),
+						static_cast<InverseResult *>(output.getData()));
+				executor.run(task, count);
+			}
+		}
+
+		// the space was allocated up front, a crash after the rename must not
+		// leave it unwritten under OUTPUT
+		if (!output.sync()) {
+			fprintf(stderr, "geoBatch: %s: %s\n", temporary.c_str(),
+					strerror(errno));
+			unlink(temporary.c_str());
+			return 1;
+		}
+	} catch (const std::exception &e) {
+		fprintf(stderr, "geoBatch: %s\n", e.what());
+		unlink(temporary.c_str());
+		return 1;
+	}
+
+	if (rename(temporary.c_str(), options.output.c_str()) != 0) {
+		fprintf(stderr, "geoBatch: %s: %s\n", options.output.c_str(),
+				strerror(errno));
+		unlink(temporary.c_str());
+		return 1;
+	}
+	if (!fileutil::syncDirectory(options.output)) {
+		fprintf(stderr, "geoBatch: %s: %s\n", options.output.c_str(),
+				strerror(errno));
+		return 1;
+	}
+	return 0;
+}